@@ -0,0 +1,129 @@
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class ArrowGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config&) override {
+        outFile << "#pragma once\n\n"
+            << "#include <memory>\n"
+            << "#include <arrow/api.h>\n\n";
+    }
+
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        if (schema.contains("definitions")) {
+            for (auto& [name, def] : schema["definitions"].items()) {
+                if (def.contains("enum")) {
+                    // Enums become dictionary-encoded strings, which Parquet stores as one small dictionary per column
+                    enumNames.insert(name);
+                    outFile << "inline std::shared_ptr<arrow::DataType> " << name << "Type() {\n"
+                        << std::string(config.indentSize, ' ') << "return arrow::dictionary(arrow::int8(), arrow::utf8());\n"
+                        << "}\n\n";
+                }
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        ++depth;
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                const json& sample = value.is_array() ? value[0] : value;
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+            }
+        }
+
+        // Nested objects are struct types; only the root becomes an arrow::Schema
+        bool isRoot = --depth == 0;
+        if (isRoot) {
+            outFile << "inline std::shared_ptr<arrow::Schema> " << className << "Schema() {\n"
+                << std::string(config.indentSize, ' ') << "return arrow::schema({\n";
+        }
+        else {
+            outFile << "inline std::shared_ptr<arrow::DataType> " << className << "Type() {\n"
+                << std::string(config.indentSize, ' ') << "return arrow::struct_({\n";
+        }
+
+        for (auto& [key, value] : data.items()) {
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize * 2, ' ') << "// " << schema["properties"][key]["description"].get<std::string>() << "\n";
+            }
+            outFile << std::string(config.indentSize * 2, ' ') << "arrow::field(\"" << key << "\", " << fieldType(className, key, value, schema) << "),\n";
+        }
+
+        outFile << std::string(config.indentSize, ' ') << "});\n"
+            << "}\n\n";
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        testFile << "#include <gtest/gtest.h>\n"
+            << "#include \"" << className << ".hpp\"\n\n"
+            << "TEST(" << className << "Test, SchemaMatchesSample) {\n"
+            << indent1 << "std::shared_ptr<arrow::Schema> schema = " << className << "Schema();\n"
+            << indent1 << "EXPECT_EQ(" << sampleData.size() << ", schema->num_fields());\n";
+        for (auto& [key, value] : sampleData.items()) {
+            testFile << indent1 << "EXPECT_NE(nullptr, schema->GetFieldByName(\"" << key << "\"));\n";
+        }
+        testFile << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "arrow::null()";
+        if (value.is_boolean()) return "arrow::boolean()";
+        if (value.is_number_integer()) return "arrow::int64()";
+        if (value.is_number_float()) return "arrow::float64()";
+        if (value.is_string()) return "arrow::utf8()";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "arrow::list(" + toLanguageType(value[0], config, key) + ")";
+            }
+            return "arrow::list(arrow::null())";
+        }
+        if (value.is_object()) return key + "Type()";
+        return "arrow::null()";
+    }
+
+private:
+    std::set<std::string> enumNames;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    int depth = 0;
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const json& schema) {
+        const json& property = propertySchema(schema, key);
+        if (property.contains("$ref")) {
+            std::string ref = property["$ref"].get<std::string>();
+            std::string name = ref.substr(ref.find_last_of('/') + 1);
+            if (enumNames.count(name)) return name + "Type()";
+        }
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "arrow::fixed_size_binary(16)";
+            case StringFormat::Kind::DATE_TIME: return "arrow::timestamp(arrow::TimeUnit::MICRO, \"UTC\")";
+            default: return "arrow::binary()";
+            }
+        }
+        if (value.is_object()) return className + "_" + key + "Type()";
+        if (isArrayOfObjects(value)) return "arrow::list(" + className + "_" + key + "Type())";
+        if (NumberFormat::isNumeric(value) && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            std::string type = format.isFloat ? (format.bits == 32 ? "arrow::float32()" : "arrow::float64()")
+                : std::string(format.isUnsigned ? "arrow::uint" : "arrow::int") + std::to_string(format.bits) + "()";
+            return value.is_array() ? "arrow::list(" + type + ")" : type;
+        }
+        return toLanguageType(value, Config(), key);
+    }
+};
@@ -0,0 +1,175 @@
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+class CapnProtoGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        fieldIds.load(config.outputFile + ".ids.json");
+        outFile << "# Field ordinals are persisted in " << config.outputFile << ".ids.json; keep it under version control.\n"
+            << fileId(config.outputFile) << ";\n\n"
+            << "using Json = import \"/capnp/compat/json.capnp\";\n\n";
+    }
+
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        if (schema.contains("definitions")) {
+            for (auto& [name, def] : schema["definitions"].items()) {
+                if (def.contains("enum")) {
+                    enumNames.insert(name);
+                    outFile << "enum " << typeName(name) << " {\n";
+                    for (size_t i = 0; i < def["enum"].size(); ++i) {
+                        const json& value = def["enum"][i];
+                        std::string original = value.is_string() ? value.get<std::string>() : value.dump();
+                        outFile << std::string(config.indentSize, ' ') << memberName(original) << " @" << i << jsonName(original) << ";\n";
+                    }
+                    outFile << "}\n\n";
+                }
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        ++depth;
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                const json& sample = value.is_array() ? value[0] : value;
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+            }
+        }
+
+        std::string structName = typeName(className);
+        for (auto& [key, value] : data.items()) {
+            fieldIds.assign(structName, key, fieldType(className, key, value, schema));
+        }
+
+        outFile << "struct " << structName << " {\n";
+        for (const auto& field : fieldIds.fields(structName)) {
+            if (field.retired || !data.contains(field.name)) {
+                // Ordinals must stay contiguous, so fields missing from the sample or retired for a type change stay declared
+                std::string retired = memberName(field.name);
+                retired[0] = std::toupper(retired[0]);
+                outFile << std::string(config.indentSize, ' ') << "obsolete" << retired << " @" << field.id << " :" << field.type << ";\n";
+                continue;
+            }
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(field.name) && schema["properties"][field.name].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "# " << schema["properties"][field.name]["description"].get<std::string>() << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << memberName(field.name) << " @" << field.id << " :" << field.type << jsonName(field.name) << ";\n";
+        }
+        outFile << "}\n\n";
+
+        if (--depth == 0) {
+            fieldIds.save();
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "# Round-trip check for " << className << " against the generated schema:\n"
+            << "#   capnp convert json:binary " << config.outputFile << " " << typeName(className) << " < sample.json > sample.bin\n"
+            << "#   capnp convert binary:json " << config.outputFile << " " << typeName(className) << " < sample.bin | jq -S . > roundtrip.json\n"
+            << "#   diff <(jq -S . sample.json) roundtrip.json\n"
+            << "#\n"
+            << "# sample.json:\n"
+            << "# " << sampleData.dump() << "\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "AnyPointer";
+        if (value.is_boolean()) return "Bool";
+        if (value.is_number_integer()) return "Int64";
+        if (value.is_number_float()) return "Float64";
+        if (value.is_string()) return "Text";
+        if (value.is_array()) {
+            if (!value.empty() && !value[0].is_null()) {
+                return "List(" + toLanguageType(value[0], config, key) + ")";
+            }
+            return "AnyPointer";
+        }
+        if (value.is_object()) return typeName(key);
+        return "AnyPointer";
+    }
+
+private:
+    FieldIdRegistry fieldIds;
+    std::set<std::string> enumNames;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    int depth = 0;
+
+    // Cap'n Proto requires a unique 64-bit file id with the top bit set; derive it from the
+    // output file name so regenerating the schema keeps the same id.
+    std::string fileId(const std::string& outputFile) {
+        std::string name = outputFile.substr(outputFile.find_last_of("/\\") + 1);
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "@0x%016llx", static_cast<unsigned long long>(hash | 0x8000000000000000ULL));
+        return buffer;
+    }
+
+    // Cap'n Proto identifiers may not contain underscores: types are UpperCamelCase, members lowerCamelCase
+    std::string typeName(const std::string& name) {
+        std::string result;
+        bool upper = true;
+        for (char c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c))) {
+                upper = true;
+                continue;
+            }
+            result += upper ? static_cast<char>(std::toupper(c)) : c;
+            upper = false;
+        }
+        return result;
+    }
+
+    std::string memberName(const std::string& name) {
+        std::string result = typeName(name);
+        if (result.empty() || std::isdigit(static_cast<unsigned char>(result[0]))) {
+            result = "f" + result;
+        }
+        result[0] = std::tolower(result[0]);
+        return result;
+    }
+
+    // Keeps the original JSON key when the Cap'n Proto member name had to be changed
+    std::string jsonName(const std::string& name) {
+        return memberName(name) == name ? "" : " $Json.name(\"" + name + "\")";
+    }
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const json& schema) {
+        const json& property = propertySchema(schema, key);
+        if (property.contains("$ref")) {
+            std::string ref = property["$ref"].get<std::string>();
+            std::string name = ref.substr(ref.find_last_of('/') + 1);
+            if (enumNames.count(name)) return typeName(name);
+        }
+        // The JSON codec has base64 for Data but no UUID or timestamp form, so only bytes change type
+        if (value.is_string() && stringFormats[className].count(key) && stringFormats[className][key].kind == StringFormat::Kind::BYTES) {
+            return "Data $Json.base64";
+        }
+        if (value.is_object()) return typeName(className + "_" + key);
+        if (isArrayOfObjects(value)) return "List(" + typeName(className + "_" + key) + ")";
+        if (NumberFormat::isNumeric(value) && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            std::string type = (format.isFloat ? "Float" : format.isUnsigned ? "UInt" : "Int") + std::to_string(format.bits);
+            return value.is_array() ? "List(" + type + ")" : type;
+        }
+        return toLanguageType(value, Config(), key);
+    }
+};
@@ -1,117 +1,1571 @@
-#include "json_model_generator.hpp"
-#include <iostream>
-
-class CppGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "#pragma once\n\n"
-            << "#include <string>\n"
-            << "#include <vector>\n"
-            << "#include <nlohmann/json.hpp>\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "enum class " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << value << ",\n";
-                    }
-                    outFile << "};\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "class " << className << " {\n"
-            << "public:\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "// " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << type << " " << key << ";\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        generateSerializationMethods(className, data, outFile, config);
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-
-        outFile << "};\n\n";
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "#include <gtest/gtest.h>\n"
-            << "#include \"" << className << ".hpp\"\n\n"
-            << "TEST(" << className << "Test, SerializationDeserialization) {\n"
-            << "    nlohmann::json sampleJson = " << sampleData.dump() << ";\n"
-            << "    " << className << " obj = " << className << "::from_json(sampleJson);\n"
-            << "    nlohmann::json serialized = obj.to_json();\n"
-            << "    EXPECT_EQ(sampleJson, serialized);\n"
-            << "}\n\n"
-            << "TEST(" << className << "Test, Validation) {\n"
-            << "    " << className << " validObj = " << className << "::from_json(" << sampleData.dump() << ");\n"
-            << "    EXPECT_TRUE(validObj.is_valid());\n"
-            << "    // Add invalid object test here\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "std::nullptr_t";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "int64_t";
-        if (value.is_number_unsigned()) return "uint64_t";
-        if (value.is_number_float()) return "double";
-        if (value.is_string()) return "std::string";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "std::vector<" + toLanguageType(value[0], config) + ">";
-            }
-            return "std::vector<std::nullptr_t>";
-        }
-        if (value.is_object()) return "class";
-        return "void*";
-    }
-
-private:
-    void generateSerializationMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize, ' ') << "nlohmann::json to_json() const {\n"
-            << std::string(config.indentSize * 2, ' ') << "return nlohmann::json({\n";
-
-        for (auto& [key, value] : data.items()) {
-            outFile << std::string(config.indentSize * 3, ' ') << "{\"" << key << "\", " << key << "},\n";
-        }
-
-        outFile << std::string(config.indentSize * 2, ' ') << "});\n"
-            << std::string(config.indentSize, ' ') << "}\n\n"
-            << std::string(config.indentSize, ' ') << "static " << className << " from_json(const nlohmann::json& j) {\n"
-            << std::string(config.indentSize * 2, ' ') << className << " obj;\n";
-
-        for (auto& [key, value] : data.items()) {
-            outFile << std::string(config.indentSize * 2, ' ') << "obj." << key << " = j.at(\"" << key << "\").get<" << toLanguageType(value, config, key) << ">();\n";
-        }
-
-        outFile << std::string(config.indentSize * 2, ' ') << "return obj;\n"
-            << std::string(config.indentSize, ' ') << "}\n";
-    }
-
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize, ' ') << "bool is_valid() const {\n"
-            << std::string(config.indentSize * 2, ' ') << "// TODO: Implement validation logic\n"
-            << std::string(config.indentSize * 2, ' ') << "return true;\n"
-            << std::string(config.indentSize, ' ') << "}\n";
-    }
+#include "json_model_generator.hpp"
+#include <algorithm>
+#include <iostream>
+
+class CppGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "#pragma once\n\n"
+            << "#include <string>\n"
+            << "#include <string_view>\n"
+            << "#include <vector>\n";
+        if (config.taggedUnions) {
+            outFile << "#include <variant>\n";
+        }
+        if (config.generateValidation) {
+            outFile << "#include <algorithm>\n"
+                << "#include <regex>\n";
+        }
+        outFile << "#include <nlohmann/json.hpp>\n\n";
+
+        generateNumbersRuntime(outFile, config);
+        if (config.generateColumns) {
+            generateAlignedAllocator(outFile, config);
+            generateColumnsRuntime(outFile, config);
+        }
+        if (config.lazyDecoding) {
+            generateLazyScanner(outFile, config);
+        }
+        else if (config.generateBinaryCodecs) {
+            generateBinaryRuntime(outFile, config);
+        }
+        if (config.stringFormats) {
+            generateFormatsRuntime(outFile, config);
+        }
+    }
+
+    // String enums get a to_string over static storage and a parse that switches on the length before
+    // comparing, so decoding a value costs a few memcmp calls at most
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << "enum class " << name << " : " << (cases.size() <= 256 ? "uint8_t" : "uint16_t") << " {\n";
+            for (const auto& caseName : cases) {
+                outFile << indent1 << caseName << ",\n";
+            }
+            outFile << "};\n\n"
+                << "inline std::string_view to_string(" << name << " value) {\n"
+                << indent1 << "static constexpr std::string_view names[] = {";
+            for (size_t i = 0; i < definition.values.size(); ++i) {
+                outFile << (i > 0 ? ", " : " ") << json(definition.values[i]).dump();
+            }
+            outFile << " };\n"
+                << indent1 << "return names[static_cast<std::size_t>(value)];\n"
+                << "}\n\n"
+                << "inline bool parse(std::string_view text, " << name << "& value) {\n"
+                << indent1 << "switch (text.size()) {\n";
+            std::map<size_t, std::vector<size_t>> byLength;
+            for (size_t i = 0; i < definition.values.size(); ++i) {
+                byLength[definition.values[i].size()].push_back(i);
+            }
+            for (const auto& [length, indices] : byLength) {
+                outFile << indent1 << "case " << length << ":\n";
+                for (size_t i : indices) {
+                    outFile << indent2 << "if (text == " << json(definition.values[i]).dump() << ") {\n"
+                        << indent3 << "value = " << name << "::" << cases[i] << ";\n"
+                        << indent3 << "return true;\n"
+                        << indent2 << "}\n";
+                }
+                outFile << indent2 << "break;\n";
+            }
+            outFile << indent1 << "}\n"
+                << indent1 << "return false;\n"
+                << "}\n\n"
+                << "inline void to_json(nlohmann::json& j, " << name << " value) { j = std::string(to_string(value)); }\n"
+                << "inline void from_json(const nlohmann::json& j, " << name << "& value) {\n"
+                << indent1 << "if (!parse(j.get_ref<const std::string&>(), value)) throw std::invalid_argument(\"Invalid " << name << ": \" + j.get<std::string>());\n"
+                << "}\n\n";
+            if (config.generateBinaryCodecs && !config.lazyDecoding) {
+                outFile << "namespace json_model_binary {\n"
+                    << "template <typename Writer> void write(Writer& w, " << name << " v) { w.writeString(to_string(v)); }\n"
+                    << "template <typename Reader> void read(Reader& r, " << name << "& v) {\n"
+                    << indent1 << "if (!parse(r.readStringView(), v)) throw std::runtime_error(\"Invalid " << name << "\");\n"
+                    << "}\n"
+                    << "} // namespace json_model_binary\n\n";
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        if (config.lazyDecoding) {
+            generateLazyClass(className, data, schema, outFile, config, circHandler);
+            return;
+        }
+        readFieldKinds(className, data, schema, config);
+
+        outFile << "class " << className << " {\n"
+            << "public:\n";
+
+        for (auto& [key, value] : data.items()) {
+            // Nested classes are declared ahead of the member that holds them, which needs a complete type
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                unions[className].insert(key);
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config, circHandler);
+            }
+            else if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                const json& sample = value.is_array() ? value[0] : value;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+                if (isColumnar(className, key, value, config)) {
+                    generateColumnsClass(newClassName, value[0], outFile, config);
+                }
+            }
+
+            std::string type = fieldType(className, key, value, config);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "// " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << type << " " << key << ";\n";
+        }
+
+        generateSerializationMethods(className, data, outFile, config);
+
+        if (config.generateBinaryCodecs) {
+            generateBinaryMethods(className, data, outFile, config);
+        }
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        outFile << "};\n\n";
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        if (config.lazyDecoding) {
+            generateLazyUnitTests(className, sampleData, testFile, config);
+            return;
+        }
+
+        // UUIDs, timestamps and base64 are written back in canonical form, so with string formats the
+        // output is checked to be stable instead of equal to the sample
+        bool canonical = std::any_of(stringFormats.begin(), stringFormats.end(), [](const auto& entry) { return !entry.second.empty(); });
+        std::string expected = canonical ? "expected" : "sampleJson";
+        testFile << "#include <gtest/gtest.h>\n"
+            << "#include \"" << className << ".hpp\"\n\n"
+            << "TEST(" << className << "Test, SerializationDeserialization) {\n"
+            << "    nlohmann::json sampleJson = " << jsonLiteral(sampleData) << ";\n"
+            << "    " << className << " obj = " << className << "::from_json(sampleJson);\n"
+            << "    nlohmann::json serialized = obj.to_json();\n"
+            << (canonical ? "    EXPECT_EQ(serialized, " + className + "::from_json(serialized).to_json());\n" : "    EXPECT_EQ(sampleJson, serialized);\n")
+            << "}\n\n"
+            << "TEST(" << className << "Test, Validation) {\n"
+            << "    " << className << " validObj = " << className << "::from_json(" << jsonLiteral(sampleData) << ");\n"
+            << "    EXPECT_TRUE(validObj.is_valid());\n"
+            << "    // Add invalid object test here\n"
+            << "}\n";
+
+        for (auto& [key, value] : sampleData.items()) {
+            if (isColumnar(className, key, value, config)) {
+                std::string columnsName = className + "::" + className + "_" + key + "Columns";
+                testFile << "\nTEST(" << className << "Test, " << key << "Columns) {\n"
+                    << "    nlohmann::json sampleJson = " << jsonLiteral(value) << ";\n"
+                    << "    " << columnsName << " columns = " << columnsName << "::from_json(sampleJson);\n"
+                    << "    EXPECT_EQ(sampleJson.size(), columns.size());\n"
+                    << "    EXPECT_EQ(sampleJson.size(), " << columnsName << "::parse(sampleJson.dump()).size());\n"
+                    << "}\n";
+            }
+        }
+
+        if (config.generateBinaryCodecs) {
+            const std::pair<std::string, std::string> formats[] = { {"msgpack", "MessagePack"}, {"cbor", "Cbor"} };
+            for (const auto& [format, testName] : formats) {
+                testFile << "\nTEST(" << className << "Test, " << testName << "RoundTrip) {\n"
+                    << "    nlohmann::json sampleJson = " << jsonLiteral(sampleData) << ";\n"
+                    << "    " << className << " obj = " << className << "::from_json(sampleJson);\n"
+                    << (canonical ? "    nlohmann::json expected = obj.to_json();\n" : "")
+                    << "    std::vector<uint8_t> encoded = obj.to_" << format << "();\n"
+                    << "    EXPECT_EQ(" << expected << ", nlohmann::json::from_" << format << "(encoded));\n"
+                    << "    EXPECT_EQ(" << expected << ", " << className << "::from_" << format << "(encoded).to_json());\n"
+                    << "    EXPECT_EQ(" << expected << ", " << className << "::from_" << format << "(nlohmann::json::to_" << format << "(sampleJson)).to_json());\n"
+                    << "}\n";
+            }
+        }
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "std::nullptr_t";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "int64_t";
+        if (value.is_number_unsigned()) return "uint64_t";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "std::string";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "std::vector<" + toLanguageType(value[0], config) + ">";
+            }
+            return "std::vector<std::nullptr_t>";
+        }
+        if (value.is_object()) return "class";
+        return "void*";
+    }
+
+private:
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    std::map<std::string, std::set<std::string>> unions;
+
+    // The union holds one alternative class per variant. Decoding looks the tag up first, with a switch
+    // on its length as for enums, and decodes only the matching alternative; MessagePack and CBOR input
+    // is scanned for the tag with a copy of the reader, since it need not be the first key
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string alternatives;
+        for (const auto& variant : tagged.variants) {
+            std::string variantClass = className + "_" + variant.name;
+            circHandler.addDependency(className, variantClass);
+            generateClass(variantClass, *variant.sample, *variant.schema, outFile, config, circHandler);
+            alternatives += (alternatives.empty() ? "" : ", ") + variantClass;
+        }
+        std::string property = json(tagged.property).dump();
+
+        outFile << "class " << className << " {\n"
+            << "public:\n"
+            << indent1 << "std::variant<" << alternatives << "> value;\n\n"
+            << indent1 << "// Index of the alternative for a " << property << " tag, or -1\n"
+            << indent1 << "static int alternative(std::string_view tag) {\n"
+            << indent2 << "switch (tag.size()) {\n";
+        std::map<size_t, std::vector<size_t>> byLength;
+        for (size_t i = 0; i < tagged.variants.size(); ++i) {
+            byLength[tagged.variants[i].tag.size()].push_back(i);
+        }
+        for (const auto& [length, indices] : byLength) {
+            outFile << indent2 << "case " << length << ":\n";
+            for (size_t i : indices) {
+                outFile << indent3 << "if (tag == " << json(tagged.variants[i].tag).dump() << ") return " << i << ";\n";
+            }
+            outFile << indent3 << "break;\n";
+        }
+        outFile << indent2 << "}\n"
+            << indent2 << "return -1;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "nlohmann::json to_json() const {\n"
+            << indent2 << "return std::visit([](const auto& alternative) { return alternative.to_json(); }, value);\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static " << className << " from_json(const nlohmann::json& j) {\n"
+            << indent2 << "const std::string& tag = j.at(" << property << ").get_ref<const std::string&>();\n"
+            << indent2 << "switch (alternative(tag)) {\n";
+        for (size_t i = 0; i < tagged.variants.size(); ++i) {
+            outFile << indent2 << "case " << i << ": return { " << className << "_" << tagged.variants[i].name << "::from_json(j) };\n";
+        }
+        outFile << indent2 << "default: throw std::invalid_argument(\"Unknown " << className << " tag: \" + tag);\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "friend void to_json(nlohmann::json& j, const " << className << "& obj) { j = obj.to_json(); }\n"
+            << indent1 << "friend void from_json(const nlohmann::json& j, " << className << "& obj) { obj = " << className << "::from_json(j); }\n";
+
+        if (config.generateBinaryCodecs) {
+            outFile << "\n" << indent1 << "template <typename Writer>\n"
+                << indent1 << "void write_binary(Writer& w) const {\n"
+                << indent2 << "std::visit([&w](const auto& alternative) { alternative.write_binary(w); }, value);\n"
+                << indent1 << "}\n\n"
+                << indent1 << "template <typename Reader>\n"
+                << indent1 << "static " << className << " read_binary(Reader& r) {\n"
+                << indent2 << "Reader probe = r;\n"
+                << indent2 << "int index = -1;\n"
+                << indent2 << "std::size_t entries = probe.readMapHeader();\n"
+                << indent2 << "for (std::size_t i = 0; i < entries && index < 0; ++i) {\n"
+                << indent3 << "if (probe.readStringView() != " << property << ") {\n"
+                << indent4 << "probe.skip();\n"
+                << indent4 << "continue;\n"
+                << indent3 << "}\n"
+                << indent3 << "std::string_view tag = probe.readStringView();\n"
+                << indent3 << "index = alternative(tag);\n"
+                << indent3 << "if (index < 0) throw std::runtime_error(\"Unknown " << className << " tag: \" + std::string(tag));\n"
+                << indent2 << "}\n"
+                << indent2 << "switch (index) {\n";
+            for (size_t i = 0; i < tagged.variants.size(); ++i) {
+                outFile << indent2 << "case " << i << ": return { " << className << "_" << tagged.variants[i].name << "::read_binary(r) };\n";
+            }
+            outFile << indent2 << "default: throw std::runtime_error(\"Missing " << className << " tag\");\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n";
+        }
+
+        if (config.generateValidation) {
+            outFile << "\n" << indent1 << "bool is_valid() const {\n"
+                << indent2 << "return std::visit([](const auto& alternative) { return alternative.is_valid(); }, value);\n"
+                << indent1 << "}\n";
+        }
+        outFile << "};\n\n";
+    }
+
+    void generateSerializationMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        outFile << std::string(config.indentSize, ' ') << "nlohmann::json to_json() const {\n"
+            << std::string(config.indentSize * 2, ' ') << "return nlohmann::json({\n";
+
+        for (auto& [key, value] : data.items()) {
+            outFile << std::string(config.indentSize * 3, ' ') << "{\"" << key << "\", " << key << "},\n";
+        }
+
+        outFile << std::string(config.indentSize * 2, ' ') << "});\n"
+            << std::string(config.indentSize, ' ') << "}\n\n"
+            << std::string(config.indentSize, ' ') << "static " << className << " from_json(const nlohmann::json& j) {\n"
+            << std::string(config.indentSize * 2, ' ') << className << " obj;\n";
+
+        for (auto& [key, value] : data.items()) {
+            outFile << std::string(config.indentSize * 2, ' ') << "obj." << key << " = json_model_numbers::get<" << fieldType(className, key, value, config) << ">(j.at(\"" << key << "\"));\n";
+        }
+
+        // Hidden friends let nlohmann::json convert nested models and vectors of them
+        outFile << std::string(config.indentSize * 2, ' ') << "return obj;\n"
+            << std::string(config.indentSize, ' ') << "}\n\n"
+            << std::string(config.indentSize, ' ') << "friend void to_json(nlohmann::json& j, const " << className << "& obj) { j = obj.to_json(); }\n"
+            << std::string(config.indentSize, ' ') << "friend void from_json(const nlohmann::json& j, " << className << "& obj) { obj = " << className << "::from_json(j); }\n";
+    }
+
+    // Patterns are compiled once into function-local statics; every other keyword is a plain comparison.
+    // Members always hold a value, so `required` is enforced by from_json. Lengths count UTF-8 code points
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if (" << violation << ") return false;\n";
+        };
+
+        outFile << indent1 << "bool is_valid() const {\n";
+        for (auto& [key, value] : data.items()) {
+            // A field with a string format was checked by its parser when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            // Lazy models decode a field on first access through its accessor
+            std::string field = config.lazyDecoding ? key + "()" : key;
+            if (value.is_string()) {
+                std::string length = "std::count_if(" + field + ".begin(), " + field + ".end(), [](unsigned char c) { return (c & 0xC0) != 0x80; })";
+                if (constraints.minLength) check(length + " < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(length + " > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) {
+                    outFile << indent2 << "static const std::regex " << key << "_pattern(R\"re(" << *constraints.pattern << ")re\", std::regex::ECMAScript | std::regex::optimize);\n";
+                    check("!std::regex_search(" + field + ", " + key + "_pattern)");
+                }
+            }
+            if (value.is_number()) {
+                // A bound the field type already keeps would be an always-false comparison (-Wtype-limits)
+                const NumberFormat& format = numberFormats[className][key];
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + field + " != " + candidate.dump();
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(field + ".size() < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(field + ".size() > " + std::to_string(*constraints.maxItems));
+                // Lazy models keep arrays of objects as raw JSON or columns, which have no item objects to check
+                if (isArrayOfObjects(value) && !config.lazyDecoding) {
+                    outFile << indent2 << "for (const auto& item : " << field << ") {\n"
+                        << indent3 << "if (!item.is_valid()) return false;\n"
+                        << indent2 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check("!" + field + ".is_valid()");
+            }
+        }
+        outFile << indent2 << "return true;\n"
+            << indent1 << "}\n";
+    }
+
+    // Sample data embedded in generated tests; a raw dump is not a valid C++ initializer
+    std::string jsonLiteral(const json& value) {
+        return "nlohmann::json::parse(R\"json(" + value.dump() + ")json\")";
+    }
+
+    // Columns need one item shape, so arrays of tagged unions keep their items as objects
+    bool isColumnar(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        return config.generateColumns && value.is_array() && !value.empty() && value[0].is_object() && !unions[className].count(key);
+    }
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    void readFieldKinds(const std::string& className, const json& data, const json& schema, const Config& config) {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (stringFormats[className].count(key)) return formatType(stringFormats[className][key]);
+        if (NumberFormat::isNumeric(value) && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            std::string type = format.isFloat ? (format.bits == 32 ? "float" : "double")
+                : (format.isUnsigned ? "uint" : "int") + std::to_string(format.bits) + "_t";
+            return value.is_array() ? "std::vector<" + type + ">" : type;
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (isArrayOfObjects(value)) return "std::vector<" + className + "_" + key + ">";
+        return toLanguageType(value, config, key);
+    }
+
+    std::string formatType(const StringFormat& format) {
+        switch (format.kind) {
+        case StringFormat::Kind::UUID: return "json_model_formats::Uuid";
+        case StringFormat::Kind::DATE_TIME: return "json_model_formats::Timestamp";
+        default: return "json_model_formats::Bytes";
+        }
+    }
+
+    // Narrowed fields must reject values outside their type, where nlohmann's get<T> or a static_cast
+    // would silently wrap 300 into a uint8_t
+    void generateNumbersRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "#include <cmath>\n"
+            << "#include <cstdint>\n"
+            << "#include <limits>\n"
+            << "#include <stdexcept>\n"
+            << "#include <type_traits>\n\n"
+            << "namespace json_model_numbers {\n\n"
+            << "template <typename T>\n"
+            << "T narrow(int64_t n) {\n"
+            << indent1 << "if (n < static_cast<int64_t>(std::numeric_limits<T>::min())\n"
+            << indent2 << "|| (sizeof(T) < sizeof(int64_t) && n > static_cast<int64_t>(std::numeric_limits<T>::max()))) {\n"
+            << indent2 << "throw std::out_of_range(\"Integer out of range: \" + std::to_string(n));\n"
+            << indent1 << "}\n"
+            << indent1 << "return static_cast<T>(n);\n"
+            << "}\n\n"
+            << "inline float narrowFloat(double d) {\n"
+            << indent1 << "if (std::isfinite(d) && std::fabs(d) > std::numeric_limits<float>::max()) {\n"
+            << indent2 << "throw std::out_of_range(\"Number out of float range: \" + std::to_string(d));\n"
+            << indent1 << "}\n"
+            << indent1 << "return static_cast<float>(d);\n"
+            << "}\n\n"
+            << "template <typename T>\n"
+            << "void check(const nlohmann::json& j, const T*) {\n"
+            << indent1 << "if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {\n"
+            << indent2 << "if (j.is_number_unsigned() && j.get<uint64_t>() > static_cast<uint64_t>(std::numeric_limits<T>::max())) {\n"
+            << indent3 << "throw std::out_of_range(\"Integer out of range: \" + j.dump());\n"
+            << indent2 << "}\n"
+            << indent2 << "if (j.is_number_integer() && !j.is_number_unsigned()) narrow<T>(j.get<int64_t>());\n"
+            << indent1 << "}\n"
+            << indent1 << "else if constexpr (std::is_same_v<T, float>) {\n"
+            << indent2 << "if (j.is_number()) narrowFloat(j.get<double>());\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "template <typename T>\n"
+            << "void check(const nlohmann::json& j, const std::vector<T>*) {\n"
+            << indent1 << "if (!j.is_array()) return;\n"
+            << indent1 << "for (const auto& item : j) check(item, static_cast<const T*>(nullptr));\n"
+            << "}\n\n"
+            << "// j.get<T>() for fields, except that numbers which do not fit T throw std::out_of_range\n"
+            << "template <typename T>\n"
+            << "T get(const nlohmann::json& j) {\n"
+            << indent1 << "check(j, static_cast<const T*>(nullptr));\n"
+            << indent1 << "return j.get<T>();\n"
+            << "}\n\n"
+            << "} // namespace json_model_numbers\n\n";
+    }
+
+    void generateFormatsRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "#include <array>\n"
+            << "#include <cstdint>\n"
+            << "#include <stdexcept>\n\n"
+            << "// Compact types for string formats: a UUID in 16 bytes, an RFC 3339 timestamp as microseconds since the\n"
+            << "// Unix epoch in UTC, and base64 as the decoded bytes. JSON still carries text, which to_string writes\n"
+            << "// back as lower-case hex, UTC with a Z (milliseconds when exact), and padded base64.\n"
+            << "namespace json_model_formats {\n\n"
+            << "struct Uuid {\n"
+            << indent1 << "std::array<uint8_t, 16> bytes{};\n"
+            << indent1 << "bool operator==(const Uuid& other) const { return bytes == other.bytes; }\n"
+            << indent1 << "bool operator!=(const Uuid& other) const { return bytes != other.bytes; }\n"
+            << "};\n\n"
+            << "struct Timestamp {\n"
+            << indent1 << "int64_t micros = 0;\n"
+            << indent1 << "bool operator==(const Timestamp& other) const { return micros == other.micros; }\n"
+            << indent1 << "bool operator!=(const Timestamp& other) const { return micros != other.micros; }\n"
+            << indent1 << "bool operator<(const Timestamp& other) const { return micros < other.micros; }\n"
+            << "};\n\n"
+            << "struct Bytes {\n"
+            << indent1 << "std::vector<uint8_t> data;\n"
+            << indent1 << "bool operator==(const Bytes& other) const { return data == other.data; }\n"
+            << indent1 << "bool operator!=(const Bytes& other) const { return data != other.data; }\n"
+            << "};\n\n"
+            << "inline int hexValue(char c) {\n"
+            << indent1 << "if (c >= '0' && c <= '9') return c - '0';\n"
+            << indent1 << "c = static_cast<char>(c | 0x20);\n"
+            << indent1 << "return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;\n"
+            << "}\n\n"
+            << "inline bool parse(std::string_view text, Uuid& value) {\n"
+            << indent1 << "if (text.size() != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') return false;\n"
+            << indent1 << "int bad = 0;\n"
+            << indent1 << "std::size_t out = 0;\n"
+            << indent1 << "for (std::size_t i = 0; i < 36; i += 2) {\n"
+            << indent2 << "if (i == 8 || i == 13 || i == 18 || i == 23) ++i;\n"
+            << indent2 << "int high = hexValue(text[i]);\n"
+            << indent2 << "int low = hexValue(text[i + 1]);\n"
+            << indent2 << "bad |= high | low;\n"
+            << indent2 << "value.bytes[out++] = static_cast<uint8_t>((high & 0xF) << 4 | (low & 0xF));\n"
+            << indent1 << "}\n"
+            << indent1 << "return bad >= 0;\n"
+            << "}\n\n"
+            << "inline std::string to_string(const Uuid& value) {\n"
+            << indent1 << "static constexpr char hex[] = \"0123456789abcdef\";\n"
+            << indent1 << "std::string text(36, '-');\n"
+            << indent1 << "std::size_t pos = 0;\n"
+            << indent1 << "for (std::size_t i = 0; i < 16; ++i) {\n"
+            << indent2 << "if (i == 4 || i == 6 || i == 8 || i == 10) ++pos;\n"
+            << indent2 << "text[pos++] = hex[value.bytes[i] >> 4];\n"
+            << indent2 << "text[pos++] = hex[value.bytes[i] & 0xF];\n"
+            << indent1 << "}\n"
+            << indent1 << "return text;\n"
+            << "}\n\n"
+            << "// Days between 1970-01-01 and a proleptic Gregorian date, and back\n"
+            << "inline int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {\n"
+            << indent1 << "year -= month <= 2;\n"
+            << indent1 << "const int64_t era = (year >= 0 ? year : year - 399) / 400;\n"
+            << indent1 << "const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);\n"
+            << indent1 << "const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;\n"
+            << indent1 << "const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;\n"
+            << indent1 << "return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;\n"
+            << "}\n\n"
+            << "inline void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {\n"
+            << indent1 << "days += 719468;\n"
+            << indent1 << "const int64_t era = (days >= 0 ? days : days - 146096) / 146097;\n"
+            << indent1 << "const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);\n"
+            << indent1 << "const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;\n"
+            << indent1 << "const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);\n"
+            << indent1 << "const unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;\n"
+            << indent1 << "day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;\n"
+            << indent1 << "month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;\n"
+            << indent1 << "year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);\n"
+            << "}\n\n"
+            << "// YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM); digits past microseconds are truncated\n"
+            << "inline bool parse(std::string_view text, Timestamp& value) {\n"
+            << indent1 << "if (text.size() < 20 || text[4] != '-' || text[7] != '-' || (text[10] != 'T' && text[10] != 't') || text[13] != ':' || text[16] != ':') return false;\n"
+            << indent1 << "auto number = [&](std::size_t pos, std::size_t count, int& out) {\n"
+            << indent2 << "out = 0;\n"
+            << indent2 << "for (std::size_t i = pos; i < pos + count; ++i) {\n"
+            << indent3 << "if (text[i] < '0' || text[i] > '9') return false;\n"
+            << indent3 << "out = out * 10 + (text[i] - '0');\n"
+            << indent2 << "}\n"
+            << indent2 << "return true;\n"
+            << indent1 << "};\n"
+            << indent1 << "static constexpr int monthLengths[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };\n"
+            << indent1 << "int year, month, day, hour, minute, second;\n"
+            << indent1 << "if (!number(0, 4, year) || !number(5, 2, month) || !number(8, 2, day) || !number(11, 2, hour) || !number(14, 2, minute) || !number(17, 2, second)\n"
+            << indent2 << "|| month < 1 || month > 12 || day < 1 || day > monthLengths[month - 1] || hour > 23 || minute > 59 || second > 59\n"
+            << indent2 << "|| (month == 2 && day == 29 && (year % 4 != 0 || (year % 100 == 0 && year % 400 != 0)))) return false;\n"
+            << indent1 << "std::size_t pos = 19;\n"
+            << indent1 << "int64_t micros = 0;\n"
+            << indent1 << "if (text[pos] == '.') {\n"
+            << indent2 << "std::size_t first = ++pos;\n"
+            << indent2 << "for (int64_t scale = 100000; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, scale /= 10) {\n"
+            << indent3 << "micros += (text[pos] - '0') * scale;\n"
+            << indent2 << "}\n"
+            << indent2 << "if (pos == first) return false;\n"
+            << indent1 << "}\n"
+            << indent1 << "int offset = 0;\n"
+            << indent1 << "if (pos + 6 == text.size() && (text[pos] == '+' || text[pos] == '-') && text[pos + 3] == ':') {\n"
+            << indent2 << "int offsetHours, offsetMinutes;\n"
+            << indent2 << "if (!number(pos + 1, 2, offsetHours) || !number(pos + 4, 2, offsetMinutes) || offsetHours > 23 || offsetMinutes > 59) return false;\n"
+            << indent2 << "offset = (text[pos] == '-' ? -1 : 1) * (offsetHours * 60 + offsetMinutes);\n"
+            << indent1 << "}\n"
+            << indent1 << "else if (pos + 1 != text.size() || (text[pos] != 'Z' && text[pos] != 'z')) {\n"
+            << indent2 << "return false;\n"
+            << indent1 << "}\n"
+            << indent1 << "int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset * 60;\n"
+            << indent1 << "value.micros = seconds * 1000000 + micros;\n"
+            << indent1 << "return true;\n"
+            << "}\n\n"
+            << "inline char* putDigits(char* out, int64_t value, int width) {\n"
+            << indent1 << "for (int i = width - 1; i >= 0; --i, value /= 10) out[i] = static_cast<char>('0' + value % 10);\n"
+            << indent1 << "return out + width;\n"
+            << "}\n\n"
+            << "inline std::string to_string(const Timestamp& value) {\n"
+            << indent1 << "int64_t seconds = value.micros / 1000000;\n"
+            << indent1 << "int64_t micros = value.micros % 1000000;\n"
+            << indent1 << "if (micros < 0) {\n"
+            << indent2 << "micros += 1000000;\n"
+            << indent2 << "--seconds;\n"
+            << indent1 << "}\n"
+            << indent1 << "int64_t days = seconds / 86400;\n"
+            << indent1 << "int64_t time = seconds % 86400;\n"
+            << indent1 << "if (time < 0) {\n"
+            << indent2 << "time += 86400;\n"
+            << indent2 << "--days;\n"
+            << indent1 << "}\n"
+            << indent1 << "int64_t year;\n"
+            << indent1 << "unsigned month, day;\n"
+            << indent1 << "civilFromDays(days, year, month, day);\n"
+            << indent1 << "char text[32];\n"
+            << indent1 << "char* out = putDigits(text, year, 4);\n"
+            << indent1 << "*out++ = '-';\n"
+            << indent1 << "out = putDigits(out, month, 2);\n"
+            << indent1 << "*out++ = '-';\n"
+            << indent1 << "out = putDigits(out, day, 2);\n"
+            << indent1 << "*out++ = 'T';\n"
+            << indent1 << "out = putDigits(out, time / 3600, 2);\n"
+            << indent1 << "*out++ = ':';\n"
+            << indent1 << "out = putDigits(out, time / 60 % 60, 2);\n"
+            << indent1 << "*out++ = ':';\n"
+            << indent1 << "out = putDigits(out, time % 60, 2);\n"
+            << indent1 << "if (micros != 0) {\n"
+            << indent2 << "*out++ = '.';\n"
+            << indent2 << "out = micros % 1000 == 0 ? putDigits(out, micros / 1000, 3) : putDigits(out, micros, 6);\n"
+            << indent1 << "}\n"
+            << indent1 << "*out++ = 'Z';\n"
+            << indent1 << "return std::string(text, out);\n"
+            << "}\n\n"
+            << "// Six-bit value of each base64 symbol, 0xFF for anything else\n"
+            << "inline const std::array<uint8_t, 256>& base64Values() {\n"
+            << indent1 << "static const std::array<uint8_t, 256> table = [] {\n"
+            << indent2 << "std::array<uint8_t, 256> t;\n"
+            << indent2 << "t.fill(0xFF);\n"
+            << indent2 << "const char* symbols = \"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/\";\n"
+            << indent2 << "for (uint8_t i = 0; i < 64; ++i) t[static_cast<unsigned char>(symbols[i])] = i;\n"
+            << indent2 << "return t;\n"
+            << indent1 << "}();\n"
+            << indent1 << "return table;\n"
+            << "}\n\n"
+            << "// Invalid symbols are OR-ed into one flag and checked once, which keeps the loop free of branches\n"
+            << "inline bool parse(std::string_view text, Bytes& value) {\n"
+            << indent1 << "if (text.size() % 4 != 0) return false;\n"
+            << indent1 << "const auto& values = base64Values();\n"
+            << indent1 << "auto at = [&](std::size_t i) -> uint32_t { return values[static_cast<unsigned char>(text[i])]; };\n"
+            << indent1 << "std::size_t padding = text.empty() || text.back() != '=' ? 0 : text[text.size() - 2] == '=' ? 2 : 1;\n"
+            << indent1 << "std::size_t full = text.size() - (padding != 0 ? 4 : 0);\n"
+            << indent1 << "value.data.resize(text.size() / 4 * 3 - padding);\n"
+            << indent1 << "uint8_t* out = value.data.data();\n"
+            << indent1 << "uint32_t bad = 0;\n"
+            << indent1 << "for (std::size_t i = 0; i < full; i += 4, out += 3) {\n"
+            << indent2 << "uint32_t a = at(i), b = at(i + 1), c = at(i + 2), d = at(i + 3);\n"
+            << indent2 << "bad |= a | b | c | d;\n"
+            << indent2 << "uint32_t n = a << 18 | b << 12 | c << 6 | d;\n"
+            << indent2 << "out[0] = static_cast<uint8_t>(n >> 16);\n"
+            << indent2 << "out[1] = static_cast<uint8_t>(n >> 8);\n"
+            << indent2 << "out[2] = static_cast<uint8_t>(n);\n"
+            << indent1 << "}\n"
+            << indent1 << "if (padding != 0) {\n"
+            << indent2 << "uint32_t a = at(full), b = at(full + 1), c = padding == 1 ? at(full + 2) : 0;\n"
+            << indent2 << "bad |= a | b | c;\n"
+            << indent2 << "uint32_t n = a << 18 | b << 12 | c << 6;\n"
+            << indent2 << "out[0] = static_cast<uint8_t>(n >> 16);\n"
+            << indent2 << "if (padding == 1) out[1] = static_cast<uint8_t>(n >> 8);\n"
+            << indent1 << "}\n"
+            << indent1 << "return (bad & 0x80) == 0;\n"
+            << "}\n\n"
+            << "inline std::string to_string(const Bytes& value) {\n"
+            << indent1 << "static constexpr char symbols[] = \"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/\";\n"
+            << indent1 << "const std::vector<uint8_t>& data = value.data;\n"
+            << indent1 << "std::string text((data.size() + 2) / 3 * 4, '=');\n"
+            << indent1 << "std::size_t pos = 0;\n"
+            << indent1 << "std::size_t i = 0;\n"
+            << indent1 << "for (; i + 3 <= data.size(); i += 3) {\n"
+            << indent2 << "uint32_t n = static_cast<uint32_t>(data[i]) << 16 | static_cast<uint32_t>(data[i + 1]) << 8 | data[i + 2];\n"
+            << indent2 << "text[pos++] = symbols[n >> 18];\n"
+            << indent2 << "text[pos++] = symbols[(n >> 12) & 0x3F];\n"
+            << indent2 << "text[pos++] = symbols[(n >> 6) & 0x3F];\n"
+            << indent2 << "text[pos++] = symbols[n & 0x3F];\n"
+            << indent1 << "}\n"
+            << indent1 << "if (i < data.size()) {\n"
+            << indent2 << "uint32_t n = static_cast<uint32_t>(data[i]) << 16 | (i + 1 < data.size() ? static_cast<uint32_t>(data[i + 1]) << 8 : 0);\n"
+            << indent2 << "text[pos++] = symbols[n >> 18];\n"
+            << indent2 << "text[pos++] = symbols[(n >> 12) & 0x3F];\n"
+            << indent2 << "if (i + 1 < data.size()) text[pos] = symbols[(n >> 6) & 0x3F];\n"
+            << indent1 << "}\n"
+            << indent1 << "return text;\n"
+            << "}\n\n"
+            << "template <typename T>\n"
+            << "void parseJson(const nlohmann::json& j, T& value, const char* format) {\n"
+            << indent1 << "if (!parse(j.get_ref<const std::string&>(), value)) throw std::invalid_argument(std::string(\"Invalid \") + format + \": \" + j.get<std::string>());\n"
+            << "}\n\n";
+        const std::pair<std::string, std::string> types[] = { { "Uuid", "uuid" }, { "Timestamp", "date-time" }, { "Bytes", "byte" } };
+        for (const auto& [type, format] : types) {
+            outFile << "inline void to_json(nlohmann::json& j, const " << type << "& value) { j = to_string(value); }\n"
+                << "inline void from_json(const nlohmann::json& j, " << type << "& value) { parseJson(j, value, \"" << format << "\"); }\n";
+        }
+        outFile << "\n} // namespace json_model_formats\n\n";
+
+        if (config.generateBinaryCodecs && !config.lazyDecoding) {
+            outFile << "namespace json_model_binary {\n";
+            for (const auto& [type, format] : types) {
+                outFile << "template <typename Writer> void write(Writer& w, const json_model_formats::" << type << "& v) { w.writeString(to_string(v)); }\n"
+                    << "template <typename Reader> void read(Reader& r, json_model_formats::" << type << "& v) {\n"
+                    << indent1 << "if (!parse(r.readStringView(), v)) throw std::runtime_error(\"Invalid " << format << "\");\n"
+                    << "}\n";
+            }
+            outFile << "} // namespace json_model_binary\n\n";
+        }
+    }
+
+    // Element type stored in one column of a Structure-of-Arrays container: the item struct's field type.
+    // Booleans are widened to uint8_t so the column stays contiguous (std::vector<bool> is bit-packed),
+    // and anything that is not a scalar or array of scalars is kept as a raw JSON cell.
+    std::string columnElementType(const std::string& itemClassName, const std::string& key, const json& value, const Config& config) {
+        if (value.is_boolean()) return "uint8_t";
+        if (value.is_number() || value.is_string()) return fieldType(itemClassName, key, value, config);
+        if (value.is_array() && (value.empty() || value[0].is_primitive())) return fieldType(itemClassName, key, value, config);
+        return "nlohmann::json";
+    }
+
+    std::string columnType(const std::string& itemClassName, const std::string& key, const json& value, const Config& config) {
+        std::string elementType = columnElementType(itemClassName, key, value, config);
+        if (value.is_number()) {
+            return "std::vector<" + elementType + ", JsonModelAlignedAllocator<" + elementType + ">>";
+        }
+        return "std::vector<" + elementType + ">";
+    }
+
+    void generateAlignedAllocator(std::ofstream& outFile, const Config& config) {
+        std::string indent(config.indentSize, ' ');
+        outFile << "#include <cstddef>\n"
+            << "#include <cstdint>\n"
+            << "#include <new>\n\n"
+            << "// Cache-line aligned storage for numeric columns so they can be vectorized.\n"
+            << "template <typename T>\n"
+            << "struct JsonModelAlignedAllocator {\n"
+            << indent << "using value_type = T;\n"
+            << indent << "static constexpr std::size_t alignment = 64;\n\n"
+            << indent << "JsonModelAlignedAllocator() noexcept = default;\n"
+            << indent << "template <typename U>\n"
+            << indent << "JsonModelAlignedAllocator(const JsonModelAlignedAllocator<U>&) noexcept {}\n\n"
+            << indent << "T* allocate(std::size_t n) {\n"
+            << indent << indent << "return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));\n"
+            << indent << "}\n\n"
+            << indent << "void deallocate(T* p, std::size_t) noexcept {\n"
+            << indent << indent << "::operator delete(p, std::align_val_t(alignment));\n"
+            << indent << "}\n\n"
+            << indent << "template <typename U>\n"
+            << indent << "bool operator==(const JsonModelAlignedAllocator<U>&) const noexcept { return true; }\n"
+            << indent << "template <typename U>\n"
+            << indent << "bool operator!=(const JsonModelAlignedAllocator<U>&) const noexcept { return false; }\n"
+            << "};\n\n";
+    }
+
+    // SAX handler behind Columns::parse. Elements of the array are appended field by field as the parser
+    // reports them; only a field that is itself an object or array is assembled into a JSON cell first.
+    void generateColumnsRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "#include <stdexcept>\n"
+            << "#include <utility>\n\n"
+            << "namespace json_model_columns {\n\n"
+            << "template <typename Columns>\n"
+            << "class Decoder {\n"
+            << "public:\n"
+            << indent1 << "explicit Decoder(Columns& columns) : columns_(columns) {}\n\n"
+            << indent1 << "bool null() { return value(nullptr); }\n"
+            << indent1 << "bool boolean(bool b) { return value(b); }\n"
+            << indent1 << "bool number_integer(nlohmann::json::number_integer_t n) { return value(n); }\n"
+            << indent1 << "bool number_unsigned(nlohmann::json::number_unsigned_t n) { return value(n); }\n"
+            << indent1 << "bool number_float(nlohmann::json::number_float_t d, const std::string&) { return value(d); }\n"
+            << indent1 << "bool string(std::string& s) { return value(std::move(s)); }\n"
+            << indent1 << "bool binary(nlohmann::json::binary_t& b) { return value(nlohmann::json::binary(std::move(b))); }\n\n"
+            << indent1 << "bool start_object(std::size_t) {\n"
+            << indent2 << "if (depth_ == 1) {\n"
+            << indent3 << "depth_ = 2;\n"
+            << indent3 << "return true;\n"
+            << indent2 << "}\n"
+            << indent2 << "return open(nlohmann::json::object());\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool key(std::string& k) {\n"
+            << indent2 << "(stack_.empty() ? field_ : cellKey_) = std::move(k);\n"
+            << indent2 << "return true;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool end_object() {\n"
+            << indent2 << "if (stack_.empty()) {\n"
+            << indent3 << "depth_ = 1;\n"
+            << indent3 << "columns_.end_row();\n"
+            << indent3 << "return true;\n"
+            << indent2 << "}\n"
+            << indent2 << "return close();\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool start_array(std::size_t) {\n"
+            << indent2 << "if (depth_ == 0) {\n"
+            << indent3 << "depth_ = 1;\n"
+            << indent3 << "return true;\n"
+            << indent2 << "}\n"
+            << indent2 << "return open(nlohmann::json::array());\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool end_array() {\n"
+            << indent2 << "if (stack_.empty()) {\n"
+            << indent3 << "depth_ = 0;\n"
+            << indent3 << "return true;\n"
+            << indent2 << "}\n"
+            << indent2 << "return close();\n"
+            << indent1 << "}\n\n"
+            << indent1 << "template <typename Exception>\n"
+            << indent1 << "bool parse_error(std::size_t, const std::string&, const Exception& e) { throw e; }\n\n"
+            << "private:\n"
+            << indent1 << "Columns& columns_;\n"
+            << indent1 << "// 1 inside the array, 2 inside one of its elements; deeper values are assembled in the cell\n"
+            << indent1 << "int depth_ = 0;\n"
+            << indent1 << "std::string field_;\n"
+            << indent1 << "std::string cellKey_;\n"
+            << indent1 << "nlohmann::json cell_;\n"
+            << indent1 << "std::vector<nlohmann::json*> stack_;\n\n"
+            << indent1 << "// Places a value in the cell being assembled, or makes it the cell\n"
+            << indent1 << "nlohmann::json* insert(nlohmann::json v) {\n"
+            << indent2 << "if (depth_ != 2) throw std::invalid_argument(\"Expected an array of objects\");\n"
+            << indent2 << "if (stack_.empty()) {\n"
+            << indent3 << "cell_ = std::move(v);\n"
+            << indent3 << "return &cell_;\n"
+            << indent2 << "}\n"
+            << indent2 << "nlohmann::json& parent = *stack_.back();\n"
+            << indent2 << "if (parent.is_object()) return &(parent[cellKey_] = std::move(v));\n"
+            << indent2 << "parent.push_back(std::move(v));\n"
+            << indent2 << "return &parent.back();\n"
+            << indent1 << "}\n\n"
+            << indent1 << "template <typename V>\n"
+            << indent1 << "bool value(V&& v) {\n"
+            << indent2 << "insert(nlohmann::json(std::forward<V>(v)));\n"
+            << indent2 << "if (stack_.empty()) columns_.append(field_, cell_);\n"
+            << indent2 << "return true;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool open(nlohmann::json container) {\n"
+            << indent2 << "stack_.push_back(insert(std::move(container)));\n"
+            << indent2 << "return true;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "bool close() {\n"
+            << indent2 << "stack_.pop_back();\n"
+            << indent2 << "if (stack_.empty()) columns_.append(field_, cell_);\n"
+            << indent2 << "return true;\n"
+            << indent1 << "}\n"
+            << "};\n\n"
+            << "} // namespace json_model_columns\n\n";
+    }
+
+    void generateColumnsClass(const std::string& itemClassName, const json& item, std::ofstream& outFile, const Config& config) {
+        std::string columnsName = itemClassName + "Columns";
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "class " << columnsName << " {\n"
+            << "public:\n";
+
+        for (auto& [key, value] : item.items()) {
+            outFile << indent1 << columnType(itemClassName, key, value, config) << " " << key << ";\n";
+        }
+
+        // Row proxies give record-style access without materializing an item object
+        const std::pair<std::string, std::string> proxies[] = { {"Row", ""}, {"ConstRow", "const "} };
+        for (const auto& [proxyName, qualifier] : proxies) {
+            outFile << "\n" << indent1 << "class " << proxyName << " {\n"
+                << indent1 << "public:\n"
+                << indent2 << proxyName << "(" << qualifier << columnsName << "& columns, std::size_t index) : columns_(columns), index_(index) {}\n";
+            for (auto& [key, value] : item.items()) {
+                outFile << indent2 << qualifier << columnElementType(itemClassName, key, value, config) << "& " << key << "() const { return columns_." << key << "[index_]; }\n";
+            }
+            outFile << indent1 << "private:\n"
+                << indent2 << qualifier << columnsName << "& columns_;\n"
+                << indent2 << "std::size_t index_;\n"
+                << indent1 << "};\n";
+        }
+
+        outFile << "\n" << indent1 << "std::size_t size() const { return size_; }\n\n"
+            << indent1 << "Row row(std::size_t index) { return Row(*this, index); }\n"
+            << indent1 << "ConstRow row(std::size_t index) const { return ConstRow(*this, index); }\n\n"
+            << indent1 << "void reserve(std::size_t" << (item.empty() ? "" : " n") << ") {\n";
+        for (auto& [key, value] : item.items()) {
+            outFile << indent2 << key << ".reserve(n);\n";
+        }
+        outFile << indent1 << "}\n\n"
+            << indent1 << "static " << columnsName << " from_json(const nlohmann::json& j) {\n"
+            << indent2 << columnsName << " columns;\n"
+            << indent2 << "columns.reserve(j.size());\n";
+        if (!item.empty()) {
+            outFile << indent2 << "for (const auto& element : j) {\n";
+            for (auto& [key, value] : item.items()) {
+                outFile << indent3 << "columns." << key << ".emplace_back(" << columnCell(itemClassName, key, value, "element.at(\"" + key + "\")", config) << ");\n";
+            }
+            outFile << indent2 << "}\n";
+        }
+        outFile << indent2 << "columns.size_ = j.size();\n"
+            << indent2 << "return columns;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "// Decodes the JSON text of the array without building a DOM for it\n"
+            << indent1 << "static " << columnsName << " parse(std::string_view text) {\n"
+            << indent2 << columnsName << " columns;\n"
+            << indent2 << "json_model_columns::Decoder<" << columnsName << "> decoder(columns);\n"
+            << indent2 << "nlohmann::json::sax_parse(text.begin(), text.end(), &decoder);\n"
+            << indent2 << "return columns;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "// Called by json_model_columns::Decoder with each field of each element, and after each element\n"
+            << indent1 << "void append(std::string_view" << (item.empty() ? "" : " key") << ", nlohmann::json&" << (item.empty() ? "" : " cell") << ") {\n";
+        bool first = true;
+        for (auto& [key, value] : item.items()) {
+            std::string cell = columnElementType(itemClassName, key, value, config) == "std::string" ? "std::move(cell.get_ref<std::string&>())" : columnCell(itemClassName, key, value, "cell", config);
+            outFile << indent2 << (first ? "" : "else ") << "if (key == \"" << key << "\") " << key << ".emplace_back(" << cell << ");\n";
+            first = false;
+        }
+        outFile << indent1 << "}\n\n"
+            << indent1 << "void end_row() {\n"
+            << indent2 << "++size_;\n";
+        for (auto& [key, value] : item.items()) {
+            outFile << indent2 << "if (" << key << ".size() != size_) throw std::out_of_range(\"Missing or repeated field: " << key << "\");\n";
+        }
+        outFile << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "std::size_t size_ = 0;\n"
+            << "};\n\n";
+    }
+
+    // Expression for one column element decoded from the JSON value `source`, checked like a struct field
+    std::string columnCell(const std::string& itemClassName, const std::string& key, const json& value, const std::string& source, const Config& config) {
+        std::string elementType = columnElementType(itemClassName, key, value, config);
+        if (value.is_boolean()) return "static_cast<uint8_t>(" + source + ".get<bool>())";
+        if (elementType == "nlohmann::json") return source;
+        return "json_model_numbers::get<" + elementType + ">(" + source + ")";
+    }
+
+    // Type returned by a lazy accessor; arrays of objects have no generated element class here,
+    // so they are handed back as JSON, or as their column container with --soa.
+    std::string lazyFieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (value.is_object()) return className + "_" + key;
+        if (isColumnar(className, key, value, config)) return className + "_" + key + "Columns";
+        if (isArrayOfObjects(value)) return "nlohmann::json";
+        return fieldType(className, key, value, config);
+    }
+
+    void generateLazyScanner(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        outFile << "#include <array>\n"
+            << "#include <cstddef>\n"
+            << "#include <memory>\n"
+            << "#include <optional>\n"
+            << "#include <stdexcept>\n"
+            << "#include <string_view>\n\n"
+            << "// Structural scanner used by lazily decoded models: it finds where each value starts and ends\n"
+            << "// without building a DOM, so only the fields that are actually read get parsed.\n"
+            << "namespace json_model_lazy {\n\n"
+            << "struct Span {\n"
+            << indent1 << "std::size_t begin = 0;\n"
+            << indent1 << "std::size_t end = 0;\n"
+            << indent1 << "bool present() const { return end > begin; }\n"
+            << "};\n\n"
+            << "inline bool isWhitespace(char c) {\n"
+            << indent1 << "return c == ' ' || c == '\\t' || c == '\\n' || c == '\\r';\n"
+            << "}\n\n"
+            << "inline std::size_t skipWhitespace(const std::string& s, std::size_t pos, std::size_t end) {\n"
+            << indent1 << "while (pos < end && isWhitespace(s[pos])) ++pos;\n"
+            << indent1 << "return pos;\n"
+            << "}\n\n"
+            << "inline std::size_t skipString(const std::string& s, std::size_t pos, std::size_t end) {\n"
+            << indent1 << "for (++pos; pos < end; ++pos) {\n"
+            << indent2 << "if (s[pos] == '\\\\') ++pos;\n"
+            << indent2 << "else if (s[pos] == '\"') return pos + 1;\n"
+            << indent1 << "}\n"
+            << indent1 << "throw std::runtime_error(\"Unterminated JSON string\");\n"
+            << "}\n\n"
+            << "inline std::size_t skipValue(const std::string& s, std::size_t pos, std::size_t end) {\n"
+            << indent1 << "if (s[pos] == '\"') return skipString(s, pos, end);\n"
+            << indent1 << "if (s[pos] == '{' || s[pos] == '[') {\n"
+            << indent2 << "int depth = 0;\n"
+            << indent2 << "while (pos < end) {\n"
+            << indent3 << "char c = s[pos];\n"
+            << indent3 << "if (c == '\"') {\n"
+            << indent4 << "pos = skipString(s, pos, end);\n"
+            << indent4 << "continue;\n"
+            << indent3 << "}\n"
+            << indent3 << "if (c == '{' || c == '[') ++depth;\n"
+            << indent3 << "else if ((c == '}' || c == ']') && --depth == 0) return pos + 1;\n"
+            << indent3 << "++pos;\n"
+            << indent2 << "}\n"
+            << indent2 << "throw std::runtime_error(\"Unterminated JSON container\");\n"
+            << indent1 << "}\n"
+            << indent1 << "while (pos < end && s[pos] != ',' && s[pos] != '}' && s[pos] != ']' && !isWhitespace(s[pos])) ++pos;\n"
+            << indent1 << "return pos;\n"
+            << "}\n\n"
+            << "// Records the value span of every key in `keys`; keys not listed are skipped, not parsed.\n"
+            << "template <std::size_t N>\n"
+            << "void indexObject(const std::string& s, Span object, const std::array<std::string_view, N>& keys, std::array<Span, N>& spans) {\n"
+            << indent1 << "std::size_t pos = skipWhitespace(s, object.begin, object.end);\n"
+            << indent1 << "if (pos >= object.end || s[pos] != '{') throw std::runtime_error(\"Expected JSON object\");\n"
+            << indent1 << "pos = skipWhitespace(s, pos + 1, object.end);\n"
+            << indent1 << "while (pos < object.end && s[pos] != '}') {\n"
+            << indent2 << "std::size_t keyEnd = skipString(s, pos, object.end);\n"
+            << indent2 << "std::string_view key(s.data() + pos + 1, keyEnd - pos - 2);\n"
+            << indent2 << "pos = skipWhitespace(s, keyEnd, object.end);\n"
+            << indent2 << "if (pos >= object.end || s[pos] != ':') throw std::runtime_error(\"Expected ':' in JSON object\");\n"
+            << indent2 << "pos = skipWhitespace(s, pos + 1, object.end);\n"
+            << indent2 << "std::size_t valueEnd = skipValue(s, pos, object.end);\n"
+            << indent2 << "for (std::size_t i = 0; i < N; ++i) {\n"
+            << indent3 << "if (keys[i] == key) {\n"
+            << indent4 << "spans[i] = Span{pos, valueEnd};\n"
+            << indent4 << "break;\n"
+            << indent3 << "}\n"
+            << indent2 << "}\n"
+            << indent2 << "pos = skipWhitespace(s, valueEnd, object.end);\n"
+            << indent2 << "if (pos < object.end && s[pos] == ',') pos = skipWhitespace(s, pos + 1, object.end);\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "template <typename T>\n"
+            << "T decode(const std::string& s, Span span, const char* key) {\n"
+            << indent1 << "if (!span.present()) throw std::out_of_range(std::string(\"Missing field: \") + key);\n"
+            << indent1 << "return json_model_numbers::get<T>(nlohmann::json::parse(s.begin() + span.begin, s.begin() + span.end));\n"
+            << "}\n\n"
+            << "// Enum and string format values are parsed from the raw span; only strings with escapes go through\n"
+            << "// the JSON parser first\n"
+            << "template <typename T>\n"
+            << "T decodeParsed(const std::string& s, Span span, const char* key) {\n"
+            << indent1 << "std::string_view raw(s.data() + span.begin, span.end - span.begin);\n"
+            << indent1 << "T value{};\n"
+            << indent1 << "if (raw.size() >= 2 && raw.front() == '\"' && raw.find('\\\\') == std::string_view::npos && parse(raw.substr(1, raw.size() - 2), value)) return value;\n"
+            << indent1 << "return decode<T>(s, span, key);\n"
+            << "}\n\n";
+        if (config.generateColumns) {
+            outFile << "// Column containers are filled straight from the parser's events over the span\n"
+                << "template <typename T>\n"
+                << "T decodeColumns(const std::string& s, Span span, const char* key) {\n"
+                << indent1 << "if (!span.present()) throw std::out_of_range(std::string(\"Missing field: \") + key);\n"
+                << indent1 << "return T::parse(std::string_view(s.data() + span.begin, span.end - span.begin));\n"
+                << "}\n\n";
+        }
+        outFile << "} // namespace json_model_lazy\n\n";
+    }
+
+    void generateLazyClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        readFieldKinds(className, data, schema, config);
+
+        // Nested models and column containers are emitted first so the accessors below can return them by reference.
+        // Union arrays are recorded here as in generateClass, so isColumnar keeps their items as objects
+        for (auto& [key, value] : data.items()) {
+            if (TaggedUnion::read(schema, key, value, config)) {
+                unions[className].insert(key);
+            }
+            else if (value.is_object()) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateLazyClass(newClassName, value, propertySchema(schema, key), outFile, config, circHandler);
+            }
+            else if (isColumnar(className, key, value, config)) {
+                // No item class is generated here, so the columns read the item's field kinds themselves
+                readFieldKinds(className + "_" + key, value[0], nestedSchema(schema, key, value[0]), config);
+                generateColumnsClass(className + "_" + key, value[0], outFile, config);
+            }
+        }
+
+        outFile << "class " << className << " {\n"
+            << "public:\n"
+            << indent1 << "static " << className << " parse(std::string text) {\n"
+            << indent2 << "auto buffer = std::make_shared<const std::string>(std::move(text));\n"
+            << indent2 << "json_model_lazy::Span span{0, buffer->size()};\n"
+            << indent2 << "return " << className << "(std::move(buffer), span);\n"
+            << indent1 << "}\n\n"
+            << indent1 << className << "(std::shared_ptr<const std::string> buffer, json_model_lazy::Span span) : buffer_(std::move(buffer)) {\n"
+            << indent2 << "json_model_lazy::indexObject(*buffer_, span, keys_, spans_);\n"
+            << indent1 << "}\n";
+
+        size_t index = 0;
+        for (auto& [key, value] : data.items()) {
+            std::string type = lazyFieldType(className, key, value, config);
+            outFile << "\n";
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << indent1 << "// " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << indent1 << "const " << type << "& " << key << "() const {\n"
+                << indent2 << "if (!" << key << "_) {\n";
+            if (value.is_object()) {
+                outFile << indent2 << indent1 << key << "_.emplace(buffer_, spans_[" << index << "]);\n";
+            }
+            else if (isColumnar(className, key, value, config)) {
+                outFile << indent2 << indent1 << key << "_ = json_model_lazy::decodeColumns<" << type << ">(*buffer_, spans_[" << index << "], \"" << key << "\");\n";
+            }
+            else {
+                std::string decoder = enumFields[className].count(key) || stringFormats[className].count(key) ? "decodeParsed" : "decode";
+                outFile << indent2 << indent1 << key << "_ = json_model_lazy::" << decoder << "<" << type << ">(*buffer_, spans_[" << index << "], \"" << key << "\");\n";
+            }
+            outFile << indent2 << "}\n"
+                << indent2 << "return *" << key << "_;\n"
+                << indent1 << "}\n";
+            ++index;
+        }
+
+        if (config.generateValidation) {
+            outFile << "\n";
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        outFile << "\n" << "private:\n"
+            << indent1 << "static constexpr std::array<std::string_view, " << data.size() << "> keys_ = {";
+        bool first = true;
+        for (auto& [key, value] : data.items()) {
+            if (!first) {
+                outFile << ", ";
+            }
+            outFile << "\"" << key << "\"";
+            first = false;
+        }
+        outFile << "};\n"
+            << indent1 << "std::shared_ptr<const std::string> buffer_;\n"
+            << indent1 << "std::array<json_model_lazy::Span, " << data.size() << "> spans_{};\n";
+        // Decoded values are cached on first access; a model instance must not be shared across threads
+        for (auto& [key, value] : data.items()) {
+            outFile << indent1 << "mutable std::optional<" << lazyFieldType(className, key, value, config) << "> " << key << "_;\n";
+        }
+        outFile << "};\n\n";
+    }
+
+    void generateLazyUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) {
+        testFile << "#include <gtest/gtest.h>\n"
+            << "#include \"" << className << ".hpp\"\n\n"
+            << "TEST(" << className << "Test, LazyDecoding) {\n"
+            << "    nlohmann::json sampleJson = " << jsonLiteral(sampleData) << ";\n"
+            << "    " << className << " obj = " << className << "::parse(sampleJson.dump());\n";
+        for (auto& [key, value] : sampleData.items()) {
+            if (value.is_primitive()) {
+                std::string type = enumFields[className].count(key) || stringFormats[className].count(key) ? fieldType(className, key, value, config) : toLanguageType(value, config, key);
+                testFile << "    EXPECT_EQ(sampleJson.at(\"" << key << "\").get<" << type << ">(), obj." << key << "());\n";
+            }
+            else if (isColumnar(className, key, value, config) || unions[className].count(key)) {
+                testFile << "    EXPECT_EQ(sampleJson.at(\"" << key << "\").size(), obj." << key << "().size());\n";
+            }
+        }
+        testFile << "}\n";
+    }
+
+    void generateBinaryRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "#include <algorithm>\n"
+            << "#include <cmath>\n"
+            << "#include <cstddef>\n"
+            << "#include <cstdint>\n"
+            << "#include <cstring>\n"
+            << "#include <stdexcept>\n"
+            << "#include <string_view>\n\n"
+            << "// Direct MessagePack and CBOR codecs for the generated models. Values are written and read in place,\n"
+            << "// without building an intermediate nlohmann::json document.\n"
+            << "namespace json_model_binary {\n\n"
+            << "class ByteWriter {\n"
+            << "public:\n"
+            << indent1 << "std::vector<uint8_t> take() { return std::move(out_); }\n\n"
+            << "protected:\n"
+            << indent1 << "void putByte(uint8_t b) { out_.push_back(b); }\n"
+            << indent1 << "void putBigEndian(uint64_t v, int bytes) {\n"
+            << indent2 << "for (int i = bytes - 1; i >= 0; --i) out_.push_back(static_cast<uint8_t>(v >> (8 * i)));\n"
+            << indent1 << "}\n"
+            << indent1 << "void putBytes(std::string_view v) { out_.insert(out_.end(), v.begin(), v.end()); }\n"
+            << indent1 << "static uint64_t doubleBits(double v) {\n"
+            << indent2 << "uint64_t bits;\n"
+            << indent2 << "std::memcpy(&bits, &v, sizeof(bits));\n"
+            << indent2 << "return bits;\n"
+            << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "std::vector<uint8_t> out_;\n"
+            << "};\n\n"
+            << "class MsgPackWriter : public ByteWriter {\n"
+            << "public:\n"
+            << indent1 << "void writeNull() { putByte(0xc0); }\n"
+            << indent1 << "void writeBool(bool v) { putByte(v ? 0xc3 : 0xc2); }\n"
+            << indent1 << "void writeInt(int64_t v) {\n"
+            << indent2 << "if (v >= 0) return writeUInt(static_cast<uint64_t>(v));\n"
+            << indent2 << "if (v >= -32) return putByte(static_cast<uint8_t>(v));\n"
+            << indent2 << "if (v >= INT8_MIN) return putHeader(0xd0, static_cast<uint64_t>(v), 1);\n"
+            << indent2 << "if (v >= INT16_MIN) return putHeader(0xd1, static_cast<uint64_t>(v), 2);\n"
+            << indent2 << "if (v >= INT32_MIN) return putHeader(0xd2, static_cast<uint64_t>(v), 4);\n"
+            << indent2 << "putHeader(0xd3, static_cast<uint64_t>(v), 8);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeUInt(uint64_t v) {\n"
+            << indent2 << "if (v < 0x80) return putByte(static_cast<uint8_t>(v));\n"
+            << indent2 << "if (v <= UINT8_MAX) return putHeader(0xcc, v, 1);\n"
+            << indent2 << "if (v <= UINT16_MAX) return putHeader(0xcd, v, 2);\n"
+            << indent2 << "if (v <= UINT32_MAX) return putHeader(0xce, v, 4);\n"
+            << indent2 << "putHeader(0xcf, v, 8);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeDouble(double v) { putHeader(0xcb, doubleBits(v), 8); }\n"
+            << indent1 << "void writeString(std::string_view v) {\n"
+            << indent2 << "if (v.size() < 32) putByte(static_cast<uint8_t>(0xa0 | v.size()));\n"
+            << indent2 << "else if (v.size() <= UINT8_MAX) putHeader(0xd9, v.size(), 1);\n"
+            << indent2 << "else if (v.size() <= UINT16_MAX) putHeader(0xda, v.size(), 2);\n"
+            << indent2 << "else putHeader(0xdb, v.size(), 4);\n"
+            << indent2 << "putBytes(v);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeArrayHeader(std::size_t n) {\n"
+            << indent2 << "if (n < 16) putByte(static_cast<uint8_t>(0x90 | n));\n"
+            << indent2 << "else if (n <= UINT16_MAX) putHeader(0xdc, n, 2);\n"
+            << indent2 << "else putHeader(0xdd, n, 4);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeMapHeader(std::size_t n) {\n"
+            << indent2 << "if (n < 16) putByte(static_cast<uint8_t>(0x80 | n));\n"
+            << indent2 << "else if (n <= UINT16_MAX) putHeader(0xde, n, 2);\n"
+            << indent2 << "else putHeader(0xdf, n, 4);\n"
+            << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "void putHeader(uint8_t type, uint64_t v, int bytes) {\n"
+            << indent2 << "putByte(type);\n"
+            << indent2 << "putBigEndian(v, bytes);\n"
+            << indent1 << "}\n"
+            << "};\n\n"
+            << "class CborWriter : public ByteWriter {\n"
+            << "public:\n"
+            << indent1 << "void writeNull() { putByte(0xf6); }\n"
+            << indent1 << "void writeBool(bool v) { putByte(v ? 0xf5 : 0xf4); }\n"
+            << indent1 << "void writeInt(int64_t v) {\n"
+            << indent2 << "if (v >= 0) putHead(0, static_cast<uint64_t>(v));\n"
+            << indent2 << "else putHead(1, static_cast<uint64_t>(-1 - v));\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeUInt(uint64_t v) { putHead(0, v); }\n"
+            << indent1 << "void writeDouble(double v) {\n"
+            << indent2 << "putByte(0xfb);\n"
+            << indent2 << "putBigEndian(doubleBits(v), 8);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeString(std::string_view v) {\n"
+            << indent2 << "putHead(3, v.size());\n"
+            << indent2 << "putBytes(v);\n"
+            << indent1 << "}\n"
+            << indent1 << "void writeArrayHeader(std::size_t n) { putHead(4, n); }\n"
+            << indent1 << "void writeMapHeader(std::size_t n) { putHead(5, n); }\n\n"
+            << "private:\n"
+            << indent1 << "void putHead(uint8_t major, uint64_t v) {\n"
+            << indent2 << "uint8_t type = static_cast<uint8_t>(major << 5);\n"
+            << indent2 << "if (v < 24) return putByte(static_cast<uint8_t>(type | v));\n"
+            << indent2 << "if (v <= UINT8_MAX) return putByte(type | 24), putBigEndian(v, 1);\n"
+            << indent2 << "if (v <= UINT16_MAX) return putByte(type | 25), putBigEndian(v, 2);\n"
+            << indent2 << "if (v <= UINT32_MAX) return putByte(type | 26), putBigEndian(v, 4);\n"
+            << indent2 << "putByte(type | 27);\n"
+            << indent2 << "putBigEndian(v, 8);\n"
+            << indent1 << "}\n"
+            << "};\n\n"
+            << "class ByteReader {\n"
+            << "public:\n"
+            << indent1 << "ByteReader(const uint8_t* data, std::size_t size) : pos_(data), end_(data + size) {}\n"
+            << indent1 << "std::size_t remaining() const { return static_cast<std::size_t>(end_ - pos_); }\n\n"
+            << "protected:\n"
+            << indent1 << "void need(uint64_t n) const {\n"
+            << indent2 << "if (remaining() < n) throw std::runtime_error(\"Unexpected end of binary input\");\n"
+            << indent1 << "}\n"
+            << indent1 << "uint8_t peekByte() const {\n"
+            << indent2 << "need(1);\n"
+            << indent2 << "return *pos_;\n"
+            << indent1 << "}\n"
+            << indent1 << "uint8_t nextByte() {\n"
+            << indent2 << "need(1);\n"
+            << indent2 << "return *pos_++;\n"
+            << indent1 << "}\n"
+            << indent1 << "uint64_t getBigEndian(int bytes) {\n"
+            << indent2 << "need(bytes);\n"
+            << indent2 << "uint64_t v = 0;\n"
+            << indent2 << "for (int i = 0; i < bytes; ++i) v = (v << 8) | *pos_++;\n"
+            << indent2 << "return v;\n"
+            << indent1 << "}\n"
+            << indent1 << "std::string_view getBytes(uint64_t n) {\n"
+            << indent2 << "need(n);\n"
+            << indent2 << "std::string_view v(reinterpret_cast<const char*>(pos_), static_cast<std::size_t>(n));\n"
+            << indent2 << "pos_ += n;\n"
+            << indent2 << "return v;\n"
+            << indent1 << "}\n"
+            << indent1 << "// Unsigned values above INT64_MAX would turn negative in an int64_t\n"
+            << indent1 << "static int64_t toInt64(uint64_t v) {\n"
+            << indent2 << "if (v > static_cast<uint64_t>(INT64_MAX)) throw std::out_of_range(\"Integer out of range\");\n"
+            << indent2 << "return static_cast<int64_t>(v);\n"
+            << indent1 << "}\n"
+            << indent1 << "static double bitsToDouble(uint64_t bits) {\n"
+            << indent2 << "double v;\n"
+            << indent2 << "std::memcpy(&v, &bits, sizeof(v));\n"
+            << indent2 << "return v;\n"
+            << indent1 << "}\n"
+            << indent1 << "static double bitsToFloat(uint64_t bits) {\n"
+            << indent2 << "uint32_t narrow = static_cast<uint32_t>(bits);\n"
+            << indent2 << "float v;\n"
+            << indent2 << "std::memcpy(&v, &narrow, sizeof(v));\n"
+            << indent2 << "return v;\n"
+            << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "const uint8_t* pos_;\n"
+            << indent1 << "const uint8_t* end_;\n"
+            << "};\n\n"
+            << "class MsgPackReader : public ByteReader {\n"
+            << "public:\n"
+            << indent1 << "using ByteReader::ByteReader;\n\n"
+            << indent1 << "bool nextIsNull() const { return remaining() > 0 && peekByte() == 0xc0; }\n"
+            << indent1 << "void readNull() {\n"
+            << indent2 << "if (nextByte() != 0xc0) throw std::runtime_error(\"Expected MessagePack nil\");\n"
+            << indent1 << "}\n"
+            << indent1 << "bool readBool() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if (b == 0xc2 || b == 0xc3) return b == 0xc3;\n"
+            << indent2 << "throw std::runtime_error(\"Expected MessagePack bool\");\n"
+            << indent1 << "}\n"
+            << indent1 << "int64_t readInt() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if (b <= 0x7f) return b;\n"
+            << indent2 << "if (b >= 0xe0) return static_cast<int8_t>(b);\n"
+            << indent2 << "switch (b) {\n"
+            << indent2 << "case 0xcc: return static_cast<int64_t>(getBigEndian(1));\n"
+            << indent2 << "case 0xcd: return static_cast<int64_t>(getBigEndian(2));\n"
+            << indent2 << "case 0xce: return static_cast<int64_t>(getBigEndian(4));\n"
+            << indent2 << "case 0xcf: return toInt64(getBigEndian(8));\n"
+            << indent2 << "case 0xd0: return static_cast<int8_t>(getBigEndian(1));\n"
+            << indent2 << "case 0xd1: return static_cast<int16_t>(getBigEndian(2));\n"
+            << indent2 << "case 0xd2: return static_cast<int32_t>(getBigEndian(4));\n"
+            << indent2 << "case 0xd3: return static_cast<int64_t>(getBigEndian(8));\n"
+            << indent2 << "}\n"
+            << indent2 << "throw std::runtime_error(\"Expected MessagePack integer\");\n"
+            << indent1 << "}\n"
+            << indent1 << "uint64_t readUInt() {\n"
+            << indent2 << "if (peekByte() == 0xcf) return nextByte(), getBigEndian(8);\n"
+            << indent2 << "int64_t v = readInt();\n"
+            << indent2 << "if (v < 0) throw std::out_of_range(\"Negative integer for an unsigned field\");\n"
+            << indent2 << "return static_cast<uint64_t>(v);\n"
+            << indent1 << "}\n"
+            << indent1 << "double readDouble() {\n"
+            << indent2 << "uint8_t b = peekByte();\n"
+            << indent2 << "if (b == 0xcb) return nextByte(), bitsToDouble(getBigEndian(8));\n"
+            << indent2 << "if (b == 0xca) return nextByte(), bitsToFloat(getBigEndian(4));\n"
+            << indent2 << "return static_cast<double>(readInt());\n"
+            << indent1 << "}\n"
+            << indent1 << "std::string_view readStringView() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if ((b & 0xe0) == 0xa0) return getBytes(b & 0x1f);\n"
+            << indent2 << "if (b == 0xd9) return getBytes(getBigEndian(1));\n"
+            << indent2 << "if (b == 0xda) return getBytes(getBigEndian(2));\n"
+            << indent2 << "if (b == 0xdb) return getBytes(getBigEndian(4));\n"
+            << indent2 << "throw std::runtime_error(\"Expected MessagePack string\");\n"
+            << indent1 << "}\n"
+            << indent1 << "std::size_t readArrayHeader() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if ((b & 0xf0) == 0x90) return b & 0x0f;\n"
+            << indent2 << "if (b == 0xdc) return static_cast<std::size_t>(getBigEndian(2));\n"
+            << indent2 << "if (b == 0xdd) return static_cast<std::size_t>(getBigEndian(4));\n"
+            << indent2 << "throw std::runtime_error(\"Expected MessagePack array\");\n"
+            << indent1 << "}\n"
+            << indent1 << "std::size_t readMapHeader() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if ((b & 0xf0) == 0x80) return b & 0x0f;\n"
+            << indent2 << "if (b == 0xde) return static_cast<std::size_t>(getBigEndian(2));\n"
+            << indent2 << "if (b == 0xdf) return static_cast<std::size_t>(getBigEndian(4));\n"
+            << indent2 << "throw std::runtime_error(\"Expected MessagePack map\");\n"
+            << indent1 << "}\n"
+            << indent1 << "void skip() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if (b <= 0x7f || b >= 0xe0 || b == 0xc0 || b == 0xc2 || b == 0xc3) return;\n"
+            << indent2 << "if ((b & 0xe0) == 0xa0) return getBytes(b & 0x1f), void();\n"
+            << indent2 << "if ((b & 0xf0) == 0x90) return skipItems(b & 0x0f);\n"
+            << indent2 << "if ((b & 0xf0) == 0x80) return skipItems(2 * (b & 0x0f));\n"
+            << indent2 << "switch (b) {\n"
+            << indent2 << "case 0xcc: case 0xd0: getBytes(1); return;\n"
+            << indent2 << "case 0xcd: case 0xd1: case 0xd4: getBytes(2); return;\n"
+            << indent2 << "case 0xd5: getBytes(3); return;\n"
+            << indent2 << "case 0xce: case 0xd2: case 0xca: getBytes(4); return;\n"
+            << indent2 << "case 0xd6: getBytes(5); return;\n"
+            << indent2 << "case 0xcf: case 0xd3: case 0xcb: getBytes(8); return;\n"
+            << indent2 << "case 0xd7: getBytes(9); return;\n"
+            << indent2 << "case 0xd8: getBytes(17); return;\n"
+            << indent2 << "case 0xc4: case 0xd9: getBytes(getBigEndian(1)); return;\n"
+            << indent2 << "case 0xc5: case 0xda: getBytes(getBigEndian(2)); return;\n"
+            << indent2 << "case 0xc6: case 0xdb: getBytes(getBigEndian(4)); return;\n"
+            << indent2 << "case 0xc7: getBytes(getBigEndian(1) + 1); return;\n"
+            << indent2 << "case 0xc8: getBytes(getBigEndian(2) + 1); return;\n"
+            << indent2 << "case 0xc9: getBytes(getBigEndian(4) + 1); return;\n"
+            << indent2 << "case 0xdc: skipItems(getBigEndian(2)); return;\n"
+            << indent2 << "case 0xdd: skipItems(getBigEndian(4)); return;\n"
+            << indent2 << "case 0xde: skipItems(2 * getBigEndian(2)); return;\n"
+            << indent2 << "case 0xdf: skipItems(2 * getBigEndian(4)); return;\n"
+            << indent2 << "}\n"
+            << indent2 << "throw std::runtime_error(\"Invalid MessagePack type byte\");\n"
+            << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "void skipItems(uint64_t n) {\n"
+            << indent2 << "for (uint64_t i = 0; i < n; ++i) skip();\n"
+            << indent1 << "}\n"
+            << "};\n\n"
+            << "class CborReader : public ByteReader {\n"
+            << "public:\n"
+            << indent1 << "using ByteReader::ByteReader;\n\n"
+            << indent1 << "bool nextIsNull() const { return remaining() > 0 && peekByte() == 0xf6; }\n"
+            << indent1 << "void readNull() {\n"
+            << indent2 << "if (nextByte() != 0xf6) throw std::runtime_error(\"Expected CBOR null\");\n"
+            << indent1 << "}\n"
+            << indent1 << "bool readBool() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if (b == 0xf4 || b == 0xf5) return b == 0xf5;\n"
+            << indent2 << "throw std::runtime_error(\"Expected CBOR bool\");\n"
+            << indent1 << "}\n"
+            << indent1 << "int64_t readInt() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "uint64_t v = argument(b & 0x1f);\n"
+            << indent2 << "if ((b >> 5) == 0) return toInt64(v);\n"
+            << indent2 << "if ((b >> 5) == 1) return -1 - toInt64(v);\n"
+            << indent2 << "throw std::runtime_error(\"Expected CBOR integer\");\n"
+            << indent1 << "}\n"
+            << indent1 << "uint64_t readUInt() { return readHead(0); }\n"
+            << indent1 << "double readDouble() {\n"
+            << indent2 << "uint8_t b = peekByte();\n"
+            << indent2 << "if (b == 0xfb) return nextByte(), bitsToDouble(getBigEndian(8));\n"
+            << indent2 << "if (b == 0xfa) return nextByte(), bitsToFloat(getBigEndian(4));\n"
+            << indent2 << "if (b == 0xf9) return nextByte(), halfToDouble(static_cast<uint16_t>(getBigEndian(2)));\n"
+            << indent2 << "return static_cast<double>(readInt());\n"
+            << indent1 << "}\n"
+            << indent1 << "std::string_view readStringView() { return getBytes(readHead(3)); }\n"
+            << indent1 << "std::size_t readArrayHeader() { return static_cast<std::size_t>(readHead(4)); }\n"
+            << indent1 << "std::size_t readMapHeader() { return static_cast<std::size_t>(readHead(5)); }\n"
+            << indent1 << "void skip() {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "uint8_t major = b >> 5;\n"
+            << indent2 << "if (major == 7) {\n"
+            << indent3 << "uint8_t info = b & 0x1f;\n"
+            << indent3 << "if (info >= 24 && info <= 27) getBytes(uint64_t(1) << (info - 24));\n"
+            << indent3 << "return;\n"
+            << indent2 << "}\n"
+            << indent2 << "uint64_t v = argument(b & 0x1f);\n"
+            << indent2 << "switch (major) {\n"
+            << indent2 << "case 2: case 3: getBytes(v); return;\n"
+            << indent2 << "case 4: return skipItems(v);\n"
+            << indent2 << "case 5: return skipItems(2 * v);\n"
+            << indent2 << "case 6: return skip();\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << "private:\n"
+            << indent1 << "uint64_t argument(uint8_t info) {\n"
+            << indent2 << "if (info < 24) return info;\n"
+            << indent2 << "if (info <= 27) return getBigEndian(1 << (info - 24));\n"
+            << indent2 << "throw std::runtime_error(\"Indefinite-length CBOR items are not supported\");\n"
+            << indent1 << "}\n"
+            << indent1 << "uint64_t readHead(uint8_t major) {\n"
+            << indent2 << "uint8_t b = nextByte();\n"
+            << indent2 << "if ((b >> 5) != major) throw std::runtime_error(\"Unexpected CBOR major type\");\n"
+            << indent2 << "return argument(b & 0x1f);\n"
+            << indent1 << "}\n"
+            << indent1 << "void skipItems(uint64_t n) {\n"
+            << indent2 << "for (uint64_t i = 0; i < n; ++i) skip();\n"
+            << indent1 << "}\n"
+            << indent1 << "static double halfToDouble(uint16_t half) {\n"
+            << indent2 << "int exponent = (half >> 10) & 0x1f;\n"
+            << indent2 << "int mantissa = half & 0x3ff;\n"
+            << indent2 << "double v = exponent == 0 ? std::ldexp(mantissa, -24)\n"
+            << indent3 << ": exponent != 31 ? std::ldexp(mantissa + 1024, exponent - 25)\n"
+            << indent3 << ": mantissa == 0 ? INFINITY : NAN;\n"
+            << indent2 << "return (half & 0x8000) ? -v : v;\n"
+            << indent1 << "}\n"
+            << "};\n\n"
+            << "template <typename Writer> void write(Writer& w, std::nullptr_t) { w.writeNull(); }\n"
+            << "template <typename Writer> void write(Writer& w, bool v) { w.writeBool(v); }\n"
+            << "template <typename Writer> void write(Writer& w, int64_t v) { w.writeInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, uint64_t v) { w.writeUInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, double v) { w.writeDouble(v); }\n"
+            << "template <typename Writer> void write(Writer& w, float v) { w.writeDouble(v); }\n"
+            << "template <typename Writer> void write(Writer& w, int8_t v) { w.writeInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, int16_t v) { w.writeInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, int32_t v) { w.writeInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, uint8_t v) { w.writeUInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, uint16_t v) { w.writeUInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, uint32_t v) { w.writeUInt(v); }\n"
+            << "template <typename Writer> void write(Writer& w, const std::string& v) { w.writeString(v); }\n"
+            << "template <typename Writer, typename T>\n"
+            << "auto write(Writer& w, const T& v) -> decltype(v.write_binary(w), void()) { v.write_binary(w); }\n"
+            << "template <typename Writer, typename T>\n"
+            << "void write(Writer& w, const std::vector<T>& v) {\n"
+            << indent1 << "w.writeArrayHeader(v.size());\n"
+            << indent1 << "for (const auto& element : v) write(w, element);\n"
+            << "}\n\n"
+            << "template <typename Reader> void read(Reader& r, std::nullptr_t& v) { r.readNull(); v = nullptr; }\n"
+            << "template <typename Reader> void read(Reader& r, bool& v) { v = r.readBool(); }\n"
+            << "template <typename Reader> void read(Reader& r, int64_t& v) { v = r.readInt(); }\n"
+            << "template <typename Reader> void read(Reader& r, uint64_t& v) { v = r.readUInt(); }\n"
+            << "template <typename Reader> void read(Reader& r, double& v) { v = r.readDouble(); }\n"
+            << "// Narrowed fields are read at full width and throw when the value does not fit\n"
+            << "template <typename Reader> void read(Reader& r, float& v) { v = json_model_numbers::narrowFloat(r.readDouble()); }\n"
+            << "template <typename Reader> void read(Reader& r, int8_t& v) { v = json_model_numbers::narrow<int8_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, int16_t& v) { v = json_model_numbers::narrow<int16_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, int32_t& v) { v = json_model_numbers::narrow<int32_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, uint8_t& v) { v = json_model_numbers::narrow<uint8_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, uint16_t& v) { v = json_model_numbers::narrow<uint16_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, uint32_t& v) { v = json_model_numbers::narrow<uint32_t>(r.readInt()); }\n"
+            << "template <typename Reader> void read(Reader& r, std::string& v) { v = r.readStringView(); }\n"
+            << "template <typename Reader, typename T>\n"
+            << "auto read(Reader& r, T& v) -> decltype(T::read_binary(r), void()) { v = T::read_binary(r); }\n"
+            << "template <typename Reader, typename T>\n"
+            << "void read(Reader& r, std::vector<T>& v) {\n"
+            << indent1 << "std::size_t n = r.readArrayHeader();\n"
+            << indent1 << "v.clear();\n"
+            << indent1 << "// Every element takes at least one byte, which bounds the reservation on corrupt input\n"
+            << indent1 << "v.reserve(std::min(n, r.remaining()));\n"
+            << indent1 << "for (std::size_t i = 0; i < n; ++i) {\n"
+            << indent2 << "T element{};\n"
+            << indent2 << "read(r, element);\n"
+            << indent2 << "v.push_back(std::move(element));\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "} // namespace json_model_binary\n";
+
+    }
+
+    void generateBinaryMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "\n" << indent1 << "template <typename Writer>\n"
+            << indent1 << "void write_binary(Writer& w) const {\n"
+            << indent2 << "w.writeMapHeader(" << data.size() << ");\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << indent2 << "w.writeString(\"" << key << "\");\n"
+                << indent2 << "json_model_binary::write(w, " << key << ");\n";
+        }
+        outFile << indent1 << "}\n\n"
+            << indent1 << "template <typename Reader>\n"
+            << indent1 << "static " << className << " read_binary(Reader& r) {\n"
+            << indent2 << className << " obj;\n"
+            << indent2 << "std::size_t entries = r.readMapHeader();\n"
+            << indent2 << "for (std::size_t i = 0; i < entries; ++i) {\n";
+        if (data.empty()) {
+            // Nothing to match the keys against, so every key is skipped along with its value
+            outFile << indent3 << "r.skip();\n"
+                << indent3 << "r.skip();\n";
+        }
+        else {
+            outFile << indent3 << "std::string_view key = r.readStringView();\n";
+            bool first = true;
+            for (auto& [key, value] : data.items()) {
+                outFile << indent3 << (first ? "if" : "else if") << " (key == \"" << key << "\") json_model_binary::read(r, obj." << key << ");\n";
+                first = false;
+            }
+            outFile << indent3 << "else r.skip();\n";
+        }
+        outFile << indent2 << "}\n"
+            << indent2 << "return obj;\n"
+            << indent1 << "}\n";
+
+        const std::pair<std::string, std::string> formats[] = { {"msgpack", "MsgPack"}, {"cbor", "Cbor"} };
+        for (const auto& [format, prefix] : formats) {
+            outFile << "\n" << indent1 << "std::vector<uint8_t> to_" << format << "() const {\n"
+                << indent2 << "json_model_binary::" << prefix << "Writer w;\n"
+                << indent2 << "write_binary(w);\n"
+                << indent2 << "return w.take();\n"
+                << indent1 << "}\n\n"
+                << indent1 << "static " << className << " from_" << format << "(const std::vector<uint8_t>& data) {\n"
+                << indent2 << "json_model_binary::" << prefix << "Reader r(data.data(), data.size());\n"
+                << indent2 << "return read_binary(r);\n"
+                << indent1 << "}\n";
+        }
+    }
 };
\ No newline at end of file
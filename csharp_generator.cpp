@@ -1,103 +1,547 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-
-class CSharpGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "using System;\n"
-            << "using System.Collections.Generic;\n"
-            << "using Newtonsoft.Json;\n\n"
-            << "namespace JsonModel\n{\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << std::string(config.indentSize, ' ') << "public enum " << name << "\n"
-                        << std::string(config.indentSize, ' ') << "{\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize * 2, ' ') << value << ",\n";
-                    }
-                    outFile << std::string(config.indentSize, ' ') << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << std::string(config.indentSize, ' ') << "public class " << className << "\n"
-            << std::string(config.indentSize, ' ') << "{\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize * 2, ' ') << "/// <summary>\n"
-                    << std::string(config.indentSize * 2, ' ') << "/// " << schema["properties"][key]["description"] << "\n"
-                    << std::string(config.indentSize * 2, ' ') << "/// </summary>\n";
-            }
-            outFile << std::string(config.indentSize * 2, ' ') << "[JsonProperty(\"" << key << "\")]\n"
-                << std::string(config.indentSize * 2, ' ') << "public " << type << " " << key << " { get; set; }\n\n";
-
-            if (type.find("class") != std::string::npos) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-
-        outFile << std::string(config.indentSize, ' ') << "}\n\n";
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "using NUnit.Framework;\n"
-            << "using Newtonsoft.Json;\n\n"
-            << "namespace JsonModel.Tests\n"
-            << "{\n"
-            << std::string(config.indentSize, ' ') << "[TestFixture]\n"
-            << std::string(config.indentSize, ' ') << "public class " << className << "Tests\n"
-            << std::string(config.indentSize, ' ') << "{\n"
-            << std::string(config.indentSize * 2, ' ') << "[Test]\n"
-            << std::string(config.indentSize * 2, ' ') << "public void SerializationDeserialization()\n"
-            << std::string(config.indentSize * 2, ' ') << "{\n"
-            << std::string(config.indentSize * 3, ' ') << "var sampleJson = " << sampleData.dump() << ";\n"
-            << std::string(config.indentSize * 3, ' ') << "var obj = JsonConvert.DeserializeObject<" << className << ">(sampleJson);\n"
-            << std::string(config.indentSize * 3, ' ') << "var serialized = JsonConvert.SerializeObject(obj);\n"
-            << std::string(config.indentSize * 3, ' ') << "Assert.AreEqual(sampleJson, serialized);\n"
-            << std::string(config.indentSize * 2, ' ') << "}\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "object";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "int";
-        if (value.is_number_float()) return "double";
-        if (value.is_string()) return "string";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List<" + toLanguageType(value[0], config) + ">";
-            }
-            return "List<object>";
-        }
-        if (value.is_object()) return "class";
-        return "object";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize * 2, ' ') << "public bool IsValid()\n"
-            << std::string(config.indentSize * 2, ' ') << "{\n"
-            << std::string(config.indentSize * 3, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize * 3, ' ') << "return true;\n"
-            << std::string(config.indentSize * 2, ' ') << "}\n";
-    }
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+
+class CSharpGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "using System;\n"
+            << "using System.Collections.Generic;\n"
+            << (config.generateValidation ? "using System.Text.RegularExpressions;\n" : "")
+            << (config.staticCodecs ? "using System.Text.Json.Serialization;\n\n" : "using Newtonsoft.Json;\n\n")
+            << "namespace JsonModel\n{\n";
+    }
+
+    // With System.Text.Json, enums get a converter that compares the UTF-8 value in place and writes
+    // pre-encoded values; Newtonsoft.Json maps them through EnumMember names
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << indent1 << "[JsonConverter(typeof(" << (config.staticCodecs ? name + "JsonConverter" : "Newtonsoft.Json.Converters.StringEnumConverter") << "))]\n"
+                << indent1 << "public enum " << name << (cases.size() <= 256 ? " : byte" : " : ushort") << "\n"
+                << indent1 << "{\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                if (!config.staticCodecs) {
+                    outFile << indent2 << "[System.Runtime.Serialization.EnumMember(Value = " << verbatimString(definition.values[i]) << ")]\n";
+                }
+                outFile << indent2 << cases[i] << ",\n";
+            }
+            outFile << indent1 << "}\n\n";
+            if (!config.staticCodecs) {
+                continue;
+            }
+
+            outFile << indent1 << "public sealed class " << name << "JsonConverter : JsonConverter<" << name << ">\n"
+                << indent1 << "{\n"
+                << indent2 << "private static readonly System.Text.Json.JsonEncodedText[] Values =\n"
+                << indent2 << "{\n";
+            for (const auto& value : definition.values) {
+                outFile << indent3 << "System.Text.Json.JsonEncodedText.Encode(" << verbatimString(value) << "),\n";
+            }
+            outFile << indent2 << "};\n\n"
+                << indent2 << "public override " << name << " Read(ref System.Text.Json.Utf8JsonReader reader, Type typeToConvert, System.Text.Json.JsonSerializerOptions options)\n"
+                << indent2 << "{\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent3 << "if (reader.ValueTextEquals(" << verbatimString(definition.values[i]) << "u8))\n"
+                    << indent3 << "{\n"
+                    << indent4 << "return " << name << "." << cases[i] << ";\n"
+                    << indent3 << "}\n";
+            }
+            outFile << indent3 << "throw new System.Text.Json.JsonException(\"Invalid " << name << ": \" + reader.GetString());\n"
+                << indent2 << "}\n\n"
+                << indent2 << "public override void Write(System.Text.Json.Utf8JsonWriter writer, " << name << " value, System.Text.Json.JsonSerializerOptions options)\n"
+                << indent2 << "{\n"
+                << indent3 << "writer.WriteStringValue(Values[(int)value]);\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        // The serializer context lists the root, whose nested types the source generator reaches through their
+        // properties, and the union variants, which it cannot reach from their base class. Nested types are
+        // declared inside their parent, so a variant is named through every enclosing class
+        if (config.staticCodecs && (scopes.empty() || variantOf.count(className))) {
+            std::string qualifiedName;
+            for (const auto& scope : scopes) {
+                qualifiedName += scope + ".";
+            }
+            serializableTypes.push_back(qualifiedName + className);
+        }
+
+        // A variant derives from its union class, which a record struct cannot
+        if (!scopes.empty() && config.valueTypes && !variantOf.count(className) && isValueType(data)) {
+            generateRecordStruct(className, data, schema, outFile, config);
+            return;
+        }
+
+        scopes.push_back(className);
+        outFile << std::string(config.indentSize, ' ') << "public class " << className << (variantOf.count(className) ? " : " + variantOf[className] : "") << "\n"
+            << std::string(config.indentSize, ' ') << "{\n";
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config, true);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize * 2, ' ') << "/// <summary>\n"
+                    << std::string(config.indentSize * 2, ' ') << "/// " << schema["properties"][key]["description"] << "\n"
+                    << std::string(config.indentSize * 2, ' ') << "/// </summary>\n";
+            }
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            std::string attribute = propertyAttribute(key, config);
+            if (tagged && !config.staticCodecs) {
+                // Newtonsoft.Json applies a class-level converter to derived classes too, which would recurse
+                attribute.insert(attribute.size() - 1, ", ItemConverterType = typeof(" + className + "_" + key + "JsonConverter)");
+            }
+            outFile << std::string(config.indentSize * 2, ' ') << "[" << attribute << "]\n"
+                << std::string(config.indentSize * 2, ' ') << "public " << type << " " << key << " { get; set; }\n\n";
+
+            const json* nested = objectSample(value);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    variantOf[newClassName + "_" + variant.name] = newClassName;
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        outFile << std::string(config.indentSize, ' ') << "}\n\n";
+        scopes.pop_back();
+
+        if (scopes.empty()) {
+            if (config.staticCodecs) {
+                generateSerializerContext(outFile, config);
+            }
+            outFile << "}\n";
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "using NUnit.Framework;\n"
+            << (config.staticCodecs ? "using System.Text.Json;\nusing System.Text.Json.Nodes;\n\n" : "using Newtonsoft.Json;\n\n")
+            << "namespace JsonModel.Tests\n"
+            << "{\n"
+            << std::string(config.indentSize, ' ') << "[TestFixture]\n"
+            << std::string(config.indentSize, ' ') << "public class " << className << "Tests\n"
+            << std::string(config.indentSize, ' ') << "{\n"
+            << std::string(config.indentSize * 2, ' ') << "[Test]\n"
+            << std::string(config.indentSize * 2, ' ') << "public void SerializationDeserialization()\n"
+            << std::string(config.indentSize * 2, ' ') << "{\n"
+            << std::string(config.indentSize * 3, ' ') << "var sampleJson = " << verbatimString(sampleData.dump()) << ";\n";
+        if (config.staticCodecs) {
+            // System.Text.Json escapes HTML-sensitive characters, so compare documents rather than text
+            testFile << std::string(config.indentSize * 3, ' ') << "var obj = JsonSerializer.Deserialize(sampleJson, JsonModelContext.Default." << className << ");\n"
+                << std::string(config.indentSize * 3, ' ') << "var serialized = JsonSerializer.Serialize(obj, JsonModelContext.Default." << className << ");\n";
+            if (config.stringFormats) {
+                // DateTimeOffset writes UTC as +00:00, so the output is compared with its own round trip
+                testFile << std::string(config.indentSize * 3, ' ') << "var reserialized = JsonSerializer.Serialize(JsonSerializer.Deserialize(serialized, JsonModelContext.Default." << className << "), JsonModelContext.Default." << className << ");\n"
+                    << std::string(config.indentSize * 3, ' ') << "Assert.AreEqual(serialized, reserialized);\n";
+            }
+            else {
+                testFile << std::string(config.indentSize * 3, ' ') << "Assert.IsTrue(JsonNode.DeepEquals(JsonNode.Parse(sampleJson), JsonNode.Parse(serialized)));\n";
+            }
+            generateBenchmarkProject(className, sampleData, config);
+        }
+        else {
+            testFile << std::string(config.indentSize * 3, ' ') << "var obj = JsonConvert.DeserializeObject<" << className << ">(sampleJson);\n"
+                << std::string(config.indentSize * 3, ' ') << "var serialized = JsonConvert.SerializeObject(obj);\n"
+                << std::string(config.indentSize * 3, ' ') << (config.stringFormats ? "Assert.AreEqual(serialized, JsonConvert.SerializeObject(JsonConvert.DeserializeObject<" + className + ">(serialized)));\n" : "Assert.AreEqual(sampleJson, serialized);\n");
+        }
+        testFile << std::string(config.indentSize * 2, ' ') << "}\n"
+            << std::string(config.indentSize, ' ') << "}\n"
+            << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "object";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "long";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "string";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List<" + toLanguageType(value[0], config) + ">";
+            }
+            return "List<object>";
+        }
+        if (value.is_object()) return "class";
+        return "object";
+    }
+
+private:
+    std::vector<std::string> scopes;
+    std::vector<std::string> serializableTypes;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    // Union class that each variant class derives from
+    std::map<std::string, std::string> variantOf;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // An abstract class with a converter that picks the variant by its tag. Utf8JsonReader is a struct,
+    // so the System.Text.Json converter scans a copy for the tag and then deserializes the variant from
+    // the untouched original; Newtonsoft.Json has no such lookahead and loads the object first
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+        std::string converter = className + "JsonConverter";
+
+        if (config.staticCodecs) {
+            outFile << indent1 << "[JsonConverter(typeof(" << converter << "))]\n";
+        }
+        outFile << indent1 << "public abstract class " << className << "\n"
+            << indent1 << "{\n";
+        if (config.generateValidation) {
+            outFile << indent2 << "public abstract bool IsValid();\n";
+        }
+        outFile << indent1 << "}\n\n";
+
+        if (config.staticCodecs) {
+            outFile << indent1 << "public sealed class " << converter << " : JsonConverter<" << className << ">\n"
+                << indent1 << "{\n"
+                << indent2 << "public override " << className << " Read(ref System.Text.Json.Utf8JsonReader reader, Type typeToConvert, System.Text.Json.JsonSerializerOptions options)\n"
+                << indent2 << "{\n"
+                << indent3 << "if (reader.TokenType != System.Text.Json.JsonTokenType.StartObject)\n"
+                << indent3 << "{\n"
+                << indent4 << "throw new System.Text.Json.JsonException(\"Expected an object for " << className << "\");\n"
+                << indent3 << "}\n"
+                << indent3 << "var scan = reader;\n"
+                << indent3 << "while (scan.Read() && scan.TokenType == System.Text.Json.JsonTokenType.PropertyName)\n"
+                << indent3 << "{\n"
+                << indent4 << "bool isTag = scan.ValueTextEquals(" << verbatimString(tagged.property) << "u8);\n"
+                << indent4 << "scan.Read();\n"
+                << indent4 << "if (!isTag)\n"
+                << indent4 << "{\n"
+                << indent5 << "scan.Skip();\n"
+                << indent5 << "continue;\n"
+                << indent4 << "}\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent4 << "if (scan.ValueTextEquals(" << verbatimString(variant.tag) << "u8))\n"
+                    << indent4 << "{\n"
+                    << indent5 << "return System.Text.Json.JsonSerializer.Deserialize(ref reader, JsonModelContext.Default." << className << "_" << variant.name << ");\n"
+                    << indent4 << "}\n";
+            }
+            outFile << indent4 << "throw new System.Text.Json.JsonException(\"Unknown " << className << " " << tagged.property << ": \" + scan.GetString());\n"
+                << indent3 << "}\n"
+                << indent3 << "throw new System.Text.Json.JsonException(\"Missing " << className << " " << tagged.property << "\");\n"
+                << indent2 << "}\n\n"
+                << indent2 << "public override void Write(System.Text.Json.Utf8JsonWriter writer, " << className << " value, System.Text.Json.JsonSerializerOptions options)\n"
+                << indent2 << "{\n"
+                << indent3 << "switch (value)\n"
+                << indent3 << "{\n";
+            for (const auto& variant : tagged.variants) {
+                std::string variantClass = className + "_" + variant.name;
+                outFile << indent4 << "case " << variantClass << " variant:\n"
+                    << indent5 << "System.Text.Json.JsonSerializer.Serialize(writer, variant, JsonModelContext.Default." << variantClass << ");\n"
+                    << indent5 << "break;\n";
+            }
+            outFile << indent4 << "default:\n"
+                << indent5 << "writer.WriteNullValue();\n"
+                << indent5 << "break;\n"
+                << indent3 << "}\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n\n";
+            return;
+        }
+
+        outFile << indent1 << "public sealed class " << converter << " : JsonConverter<" << className << ">\n"
+            << indent1 << "{\n"
+            << indent2 << "public override " << className << " ReadJson(JsonReader reader, Type objectType, " << className << " existingValue, bool hasExistingValue, JsonSerializer serializer)\n"
+            << indent2 << "{\n"
+            << indent3 << "if (reader.TokenType == JsonToken.Null)\n"
+            << indent3 << "{\n"
+            << indent4 << "return null;\n"
+            << indent3 << "}\n"
+            << indent3 << "var item = Newtonsoft.Json.Linq.JObject.Load(reader);\n"
+            << indent3 << "var tag = (string)item[" << verbatimString(tagged.property) << "];\n"
+            << indent3 << "switch (tag)\n"
+            << indent3 << "{\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << indent4 << "case " << verbatimString(variant.tag) << ":\n"
+                << indent5 << "return item.ToObject<" << className << "_" << variant.name << ">(serializer);\n";
+        }
+        outFile << indent4 << "default:\n"
+            << indent5 << "throw new JsonSerializationException(\"Unknown " << className << " " << tagged.property << ": \" + tag);\n"
+            << indent3 << "}\n"
+            << indent2 << "}\n\n"
+            << indent2 << "public override void WriteJson(JsonWriter writer, " << className << " value, JsonSerializer serializer)\n"
+            << indent2 << "{\n"
+            << indent3 << "serializer.Serialize(writer, value, value?.GetType());\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n";
+    }
+
+    // Up to four numeric or boolean fields fit in 32 bytes, small enough to copy by value
+    bool isValueType(const json& data) {
+        if (data.empty() || data.size() > 4) return false;
+        for (auto& [key, value] : data.items()) {
+            if (!value.is_boolean() && !value.is_number()) return false;
+        }
+        return true;
+    }
+
+    // Struct-typed properties are nullable so a JSON null still round-trips
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config, bool nullable) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            // Both serializers read and write these natively; DateTimeOffset keeps the offset of the input
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "Guid";
+            case StringFormat::Kind::DATE_TIME: return "DateTimeOffset";
+            default: return "byte[]";
+            }
+        }
+        if (value.is_object()) {
+            std::string name = className + "_" + key;
+            return nullable && config.valueTypes && isValueType(value) ? name + "?" : name;
+        }
+        if (value.is_array() && !value.empty()) return "List<" + fieldType(className, key, value[0], config, false) + ">";
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            static const std::map<int, std::string> signedTypes = { {8, "sbyte"}, {16, "short"}, {32, "int"}, {64, "long"} };
+            static const std::map<int, std::string> unsignedTypes = { {8, "byte"}, {16, "ushort"}, {32, "uint"}, {64, "ulong"} };
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return format.bits == 32 ? "float" : "double";
+            return (format.isUnsigned ? unsignedTypes : signedTypes).at(format.bits);
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    std::string propertyAttribute(const std::string& key, const Config& config) {
+        return (config.staticCodecs ? "JsonPropertyName(\"" : "JsonProperty(\"") + key + "\")";
+    }
+
+    std::string verbatimString(const std::string& text) {
+        std::string result = "@\"";
+        for (char c : text) {
+            if (c == '"') {
+                result += '"';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    // Patterns are compiled once into static fields; every other keyword is a plain comparison.
+    // Lengths are counted in UTF-16 code units, as string.Length does
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << indent2 << "private static readonly Regex " << patternName(key) << " = new Regex(" << verbatimString(*constraints.pattern) << ", RegexOptions.Compiled);\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        outFile << indent2 << (variantOf.count(className) ? "public override bool IsValid()\n" : "public bool IsValid()\n")
+            << indent2 << "{\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent3 << "if (" << violation << ")\n"
+                << indent3 << "{\n"
+                << indent4 << "return false;\n"
+                << indent3 << "}\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            // A formatted field was checked by the serializer when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            // Enums are value types and always hold a value
+            bool nullable = (value.is_string() && !enumFields[className].count(key)) || value.is_object() || value.is_array();
+            // Optional fields may be absent, and only present values are checked
+            std::string guard = nullable && !constraints.required ? key + " != null && " : "";
+            if (nullable && constraints.required) check(key + " == null");
+            if (value.is_string()) {
+                if (constraints.minLength) check(guard + key + ".Length < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(guard + key + ".Length > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check(guard + "!" + patternName(key) + ".IsMatch(" + key + ")");
+            }
+            if (value.is_number()) {
+                // A comparison the type limits decide draws CS0652, so such a bound is left out
+                const NumberFormat& format = numberFormats[className][key];
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(key + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(key + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + key + " != " + candidate.dump();
+                }
+                check(guard.empty() || allowed.size() == 1 ? guard + violation : guard + "(" + violation + ")");
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(guard + key + ".Count < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(guard + key + ".Count > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    // List items of a value type are never null
+                    bool valueItems = config.valueTypes && isValueType(value[0]);
+                    outFile << indent3 << "for (int i = 0; " << (constraints.required ? "" : key + " != null && ") << "i < " << key << ".Count; i++)\n"
+                        << indent3 << "{\n"
+                        << indent4 << "if (" << (valueItems ? "!" + key + "[i].IsValid()" : key + "[i]?.IsValid() == false") << ")\n"
+                        << indent4 << "{\n"
+                        << indent5 << "return false;\n"
+                        << indent4 << "}\n"
+                        << indent3 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check(key + "?.IsValid() == false");
+            }
+        }
+        outFile << indent3 << "return true;\n"
+            << indent2 << "}\n";
+    }
+
+    std::string patternName(const std::string& key) {
+        std::string result;
+        bool upper = true;
+        for (unsigned char c : key) {
+            if (!std::isalnum(c)) {
+                upper = true;
+                continue;
+            }
+            result += upper ? static_cast<char>(std::toupper(c)) : static_cast<char>(c);
+            upper = false;
+        }
+        return result + "Pattern";
+    }
+
+    void generateRecordStruct(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        if (config.generateDocs && schema.contains("description")) {
+            outFile << std::string(config.indentSize, ' ') << "/// <summary>\n"
+                << std::string(config.indentSize, ' ') << "/// " << schema["description"] << "\n"
+                << std::string(config.indentSize, ' ') << "/// </summary>\n";
+        }
+        outFile << std::string(config.indentSize, ' ') << "public readonly record struct " << className << "(\n";
+        size_t index = 0;
+        for (auto& [key, value] : data.items()) {
+            outFile << std::string(config.indentSize * 2, ' ') << "[property: " << propertyAttribute(key, config) << "] "
+                << fieldType(className, key, value, config, false) << " " << key << (++index < data.size() ? ",\n" : ")");
+        }
+        if (!config.generateValidation) {
+            outFile << ";\n\n";
+            return;
+        }
+        outFile << "\n"
+            << std::string(config.indentSize, ' ') << "{\n";
+        generateValidationMethod(className, data, schema, outFile, config);
+        outFile << std::string(config.indentSize, ' ') << "}\n\n";
+    }
+
+    void generateSerializerContext(std::ofstream& outFile, const Config& config) {
+        for (const auto& type : serializableTypes) {
+            outFile << std::string(config.indentSize, ' ') << "[JsonSerializable(typeof(" << type << "))]\n";
+        }
+        outFile << std::string(config.indentSize, ' ') << "public partial class JsonModelContext : JsonSerializerContext\n"
+            << std::string(config.indentSize, ' ') << "{\n"
+            << std::string(config.indentSize, ' ') << "}\n";
+    }
+
+    // BenchmarkDotNet project written next to the model; it compiles only the model and the benchmark
+    void generateBenchmarkProject(const std::string& className, const json& sampleData, const Config& config) {
+        std::string directory = config.outputFile.substr(0, config.outputFile.find_last_of("/\\") + 1);
+        std::string modelFile = config.outputFile.substr(directory.size());
+        std::string name = className + "Benchmarks";
+
+        std::ofstream projectFile(directory + name + ".csproj");
+        if (projectFile.is_open()) {
+            projectFile << "<Project Sdk=\"Microsoft.NET.Sdk\">\n"
+                << "  <PropertyGroup>\n"
+                << "    <OutputType>Exe</OutputType>\n"
+                << "    <TargetFramework>net8.0</TargetFramework>\n"
+                << "    <Optimize>true</Optimize>\n"
+                << "    <EnableDefaultCompileItems>false</EnableDefaultCompileItems>\n"
+                << "  </PropertyGroup>\n"
+                << "  <ItemGroup>\n"
+                << "    <Compile Include=\"" << modelFile << "\" />\n"
+                << "    <Compile Include=\"" << name << ".cs\" />\n"
+                << "  </ItemGroup>\n"
+                << "  <ItemGroup>\n"
+                << "    <PackageReference Include=\"BenchmarkDotNet\" Version=\"0.13.12\" />\n"
+                << "  </ItemGroup>\n"
+                << "</Project>\n";
+        }
+
+        std::ofstream benchFile(directory + name + ".cs");
+        if (!benchFile.is_open()) {
+            return;
+        }
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string typeInfo = "JsonModelContext.Default." + className;
+        benchFile << "using System.Text.Json;\n"
+            << "using BenchmarkDotNet.Attributes;\n"
+            << "using BenchmarkDotNet.Running;\n\n"
+            << "namespace JsonModel.Benchmarks\n"
+            << "{\n"
+            << indent1 << "// Reflection-based System.Text.Json against the generated JsonModelContext\n"
+            << indent1 << "[MemoryDiagnoser]\n"
+            << indent1 << "public class " << name << "\n"
+            << indent1 << "{\n"
+            << indent2 << "private const string SampleJson = " << verbatimString(sampleData.dump()) << ";\n"
+            << indent2 << "private static readonly JsonSerializerOptions ReflectionOptions = new JsonSerializerOptions();\n"
+            << indent2 << "private " << className << " model;\n\n"
+            << indent2 << "[GlobalSetup]\n"
+            << indent2 << "public void Setup()\n"
+            << indent2 << "{\n"
+            << indent3 << "model = JsonSerializer.Deserialize(SampleJson, " << typeInfo << ");\n"
+            << indent2 << "}\n\n"
+            << indent2 << "[Benchmark]\n"
+            << indent2 << "public " << className << " DeserializeReflection() => JsonSerializer.Deserialize<" << className << ">(SampleJson, ReflectionOptions);\n\n"
+            << indent2 << "[Benchmark]\n"
+            << indent2 << "public " << className << " DeserializeSourceGenerated() => JsonSerializer.Deserialize(SampleJson, " << typeInfo << ");\n\n"
+            << indent2 << "[Benchmark]\n"
+            << indent2 << "public string SerializeReflection() => JsonSerializer.Serialize(model, ReflectionOptions);\n\n"
+            << indent2 << "[Benchmark]\n"
+            << indent2 << "public string SerializeSourceGenerated() => JsonSerializer.Serialize(model, " << typeInfo << ");\n"
+            << indent1 << "}\n\n"
+            << indent1 << "public static class Program\n"
+            << indent1 << "{\n"
+            << indent2 << "public static void Main(string[] args) => BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);\n"
+            << indent1 << "}\n"
+            << "}\n";
+    }
 };
\ No newline at end of file
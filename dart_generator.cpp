@@ -1,107 +1,367 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class DartGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "import 'package:json_annotation/json_annotation.dart';\n\n"
-            << "part '" << config.outputFile.substr(0, config.outputFile.find_last_of('.')) << ".g.dart';\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "enum " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << "@JsonValue('" << value << "')\n"
-                            << std::string(config.indentSize, ' ') << value << ",\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "@JsonSerializable()\n"
-            << "class " << className << " {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << "@JsonKey(name: '" << key << "')\n"
-                << std::string(config.indentSize, ' ') << "final " << type << " " << key << ";\n\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        // Constructor
-        outFile << std::string(config.indentSize, ' ') << className << "({\n";
-        for (auto& [key, value] : data.items()) {
-            outFile << std::string(config.indentSize * 2, ' ') << "required this." << key << ",\n";
-        }
-        outFile << std::string(config.indentSize, ' ') << "});\n\n";
-
-        // fromJson and toJson methods
-        outFile << std::string(config.indentSize, ' ') << "factory " << className << ".fromJson(Map<String, dynamic> json) => _$" << className << "FromJson(json);\n\n"
-            << std::string(config.indentSize, ' ') << "Map<String, dynamic> toJson() => _$" << className << "ToJson(this);\n";
-
-        outFile << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import 'package:test/test.dart';\n"
-            << "import 'dart:convert';\n"
-            << "import '" << config.outputFile << "';\n\n"
-            << "void main() {\n"
-            << std::string(config.indentSize, ' ') << "test('$" << className << " serialization and deserialization', () {\n"
-            << std::string(config.indentSize * 2, ' ') << "final sampleJson = '" << sampleData.dump() << "';\n"
-            << std::string(config.indentSize * 2, ' ') << "final jsonMap = json.decode(sampleJson) as Map<String, dynamic>;\n"
-            << std::string(config.indentSize * 2, ' ') << "final obj = " << className << ".fromJson(jsonMap);\n"
-            << std::string(config.indentSize * 2, ' ') << "final serialized = json.encode(obj.toJson());\n"
-            << std::string(config.indentSize * 2, ' ') << "expect(json.decode(serialized), equals(jsonMap));\n"
-            << std::string(config.indentSize, ' ') << "});\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "dynamic";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "int";
-        if (value.is_number_float()) return "double";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List<" + toLanguageType(value[0], config) + ">";
-            }
-            return "List<dynamic>";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "dynamic";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "extension " << className << "Validator on " << className << " {\n"
-            << std::string(config.indentSize, ' ') << "bool isValid() {\n"
-            << std::string(config.indentSize * 2, ' ') << "// TODO: Implement validation logic\n"
-            << std::string(config.indentSize * 2, ' ') << "return true;\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class DartGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "import 'dart:convert';\n"
+            << "import 'dart:isolate';\n";
+        if (config.typedArrays || config.stringFormats) {
+            outFile << "import 'dart:typed_data';\n";
+        }
+        outFile << "\n"
+            << "import 'package:json_annotation/json_annotation.dart';\n\n"
+            << "part '" << config.outputFile.substr(0, config.outputFile.find_last_of('.')) << ".g.dart';\n\n";
+        if (config.typedArrays) {
+            generateTypedListConverters(outFile, config);
+        }
+        if (config.stringFormats) {
+            generateBase64Converter(outFile, config);
+        }
+    }
+
+    // json_serializable decodes through a generated value-to-case map, so each case names its JSON value
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::CAMEL);
+            outFile << "enum " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << std::string(config.indentSize, ' ') << "@JsonValue(" << dartString(definition.values[i]) << ")\n"
+                    << std::string(config.indentSize, ' ') << cases[i] << ",\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        ++depth;
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        // Class-level converters also reach typed lists held inside other collections
+        std::string converters;
+        if (config.typedArrays) {
+            converters = "Int32ListConverter(), Int64ListConverter(), Float64ListConverter()";
+        }
+        if (config.stringFormats) {
+            converters += std::string(converters.empty() ? "" : ", ") + "Base64Converter()";
+        }
+        outFile << (converters.empty() ? "@JsonSerializable()\n" : "@JsonSerializable(converters: [" + converters + "])\n")
+            << "class " << className << (variantOf.count(className) ? " extends " + variantOf[className] : "") << " {\n";
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << "@JsonKey(name: '" << key << "')\n"
+                << std::string(config.indentSize, ' ') << "final " << type << " " << key << ";\n\n";
+        }
+
+        // Constructor; every field is final, so instances can be compile-time constants
+        outFile << std::string(config.indentSize, ' ') << "const " << className << "({\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << std::string(config.indentSize * 2, ' ') << "required this." << key << ",\n";
+        }
+        outFile << std::string(config.indentSize, ' ') << "});\n\n";
+
+        // fromJson and toJson methods
+        outFile << std::string(config.indentSize, ' ') << "factory " << className << ".fromJson(Map<String, dynamic> json) => _$" << className << "FromJson(json);\n\n"
+            << (variantOf.count(className) ? std::string(config.indentSize, ' ') + "@override\n" : "")
+            << std::string(config.indentSize, ' ') << "Map<String, dynamic> toJson() => _$" << className << "ToJson(this);\n";
+
+        outFile << "}\n\n";
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        if (depth == 1) {
+            generateBackgroundDecoder(className, outFile, config);
+        }
+
+        // Dart has no nested classes, so nested ones follow at library level
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    variantOf[newClassName + "_" + variant.name] = newClassName;
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+
+        --depth;
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "import 'package:test/test.dart';\n"
+            << "import 'dart:convert';\n"
+            << "import '" << config.outputFile << "';\n\n"
+            << "void main() {\n"
+            << std::string(config.indentSize, ' ') << "final sampleJson = '" << sampleData.dump() << "';\n\n"
+            << std::string(config.indentSize, ' ') << "test('$" << className << " serialization and deserialization', () {\n"
+            << std::string(config.indentSize * 2, ' ') << "final jsonMap = json.decode(sampleJson) as Map<String, dynamic>;\n"
+            << std::string(config.indentSize * 2, ' ') << "final obj = " << className << ".fromJson(jsonMap);\n"
+            << std::string(config.indentSize * 2, ' ') << "final serialized = json.encode(obj.toJson());\n"
+            // Date-times are written back in UTC, so the output is compared with its own round trip
+            << std::string(config.indentSize * 2, ' ') << (config.stringFormats
+                ? "expect(json.encode(" + className + ".fromJson(json.decode(serialized) as Map<String, dynamic>).toJson()), equals(serialized));\n"
+                : "expect(json.decode(serialized), equals(jsonMap));\n")
+            << std::string(config.indentSize, ' ') << "});\n\n"
+            << std::string(config.indentSize, ' ') << "test('$" << className << " background decoding', () async {\n"
+            << std::string(config.indentSize * 2, ' ') << "final obj = await decode" << className << "InBackground(sampleJson, threshold: 0);\n"
+            << std::string(config.indentSize * 2, ' ') << (config.stringFormats
+                ? "expect(json.encode(obj.toJson()), equals(json.encode(" + className + ".fromJson(json.decode(sampleJson) as Map<String, dynamic>).toJson())));\n"
+                : "expect(json.decode(json.encode(obj.toJson())), equals(json.decode(sampleJson)));\n")
+            << std::string(config.indentSize, ' ') << "});\n"
+            << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "dynamic";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "int";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List<" + toLanguageType(value[0], config) + ">";
+            }
+            return "List<dynamic>";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "dynamic";
+    }
+
+private:
+    int depth = 0;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    // Sealed union class that each variant class extends
+    std::map<std::string, std::string> variantOf;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // json_serializable calls fromJson and toJson on any class that declares them, so the sealed union
+    // needs no annotation; its factory switches on the tag and decodes only the matching variant
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string tag = dartString(tagged.property);
+        outFile << "sealed class " << className << " {\n"
+            << indent1 << "const " << className << "();\n\n"
+            << indent1 << "factory " << className << ".fromJson(Map<String, dynamic> json) {\n"
+            << indent2 << "switch (json[" << tag << "]) {\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << indent3 << "case " << dartString(variant.tag) << ":\n"
+                << indent3 << indent1 << "return " << className << "_" << variant.name << ".fromJson(json);\n";
+        }
+        outFile << indent3 << "default:\n"
+            << indent3 << indent1 << "throw ArgumentError.value(json[" << tag << "], " << tag << ", " << dartString("Unknown " + className + " " + tagged.property) << ");\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "Map<String, dynamic> toJson();\n"
+            << "}\n\n";
+        if (config.generateValidation) {
+            outFile << "extension " << className << "Validator on " << className << " {\n"
+                << indent1 << "bool isValid() => switch (this) {\n";
+            for (const auto& variant : tagged.variants) {
+                std::string variantClass = className + "_" + variant.name;
+                outFile << indent2 << variantClass << " variant => variant.isValid(),\n";
+            }
+            outFile << indent1 << "};\n"
+                << "}\n\n";
+        }
+    }
+
+    // Element kind of a non-empty array whose items are all numbers: "int32", "int64" or "float64";
+    // empty for anything else
+    std::string numericArrayKind(const json& value) {
+        if (!value.is_array() || value.empty()) return "";
+        bool fitsInt32 = true;
+        for (const auto& item : value) {
+            if (!item.is_number()) return "";
+            if (item.is_number_float()) return "float64";
+            if (item.is_number_unsigned() ? item.get<uint64_t>() > INT32_MAX : item.get<int64_t>() < INT32_MIN || item.get<int64_t>() > INT32_MAX) {
+                fitsInt32 = false;
+            }
+        }
+        return fitsInt32 ? "int32" : "int64";
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            // json_serializable reads DateTime itself; Dart has no UUID type, so those stay strings
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::DATE_TIME: return "DateTime";
+            case StringFormat::Kind::BYTES: return "Uint8List";
+            default: break;
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (config.typedArrays) {
+            std::string kind = numericArrayKind(value);
+            if (kind == "int32") return "Int32List";
+            if (kind == "int64") return "Int64List";
+            if (kind == "float64") return "Float64List";
+        }
+        if (value.is_array() && !value.empty()) return "List<" + fieldType(className, key, value[0], config) + ">";
+        return toLanguageType(value, config, key);
+    }
+
+    // json_serializable has no typed_data support; the converters fill the packed list straight from
+    // the decoded JSON list, and a typed list is itself a List<num> that jsonEncode writes as-is
+    void generateTypedListConverters(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        const std::pair<std::string, std::string> lists[] = { { "Int32List", "toInt()" }, { "Int64List", "toInt()" }, { "Float64List", "toDouble()" } };
+
+        for (const auto& [type, conversion] : lists) {
+            outFile << "class " << type << "Converter implements JsonConverter<" << type << ", List<dynamic>> {\n"
+                << indent1 << "const " << type << "Converter();\n\n"
+                << indent1 << "@override\n"
+                << indent1 << type << " fromJson(List<dynamic> json) {\n"
+                << indent2 << "final result = " << type << "(json.length);\n"
+                << indent2 << "for (var i = 0; i < json.length; i++) {\n"
+                << indent3 << "result[i] = (json[i] as num)." << conversion << ";\n"
+                << indent2 << "}\n"
+                << indent2 << "return result;\n"
+                << indent1 << "}\n\n"
+                << indent1 << "@override\n"
+                << indent1 << "List<dynamic> toJson(" << type << " object) => object;\n"
+                << "}\n\n";
+        }
+    }
+
+    void generateBase64Converter(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        outFile << "class Base64Converter implements JsonConverter<Uint8List, String> {\n"
+            << indent1 << "const Base64Converter();\n\n"
+            << indent1 << "@override\n"
+            << indent1 << "Uint8List fromJson(String json) => base64.decode(json);\n\n"
+            << indent1 << "@override\n"
+            << indent1 << "String toJson(Uint8List object) => base64.encode(object);\n"
+            << "}\n\n";
+    }
+
+    // Parsing a large payload on the UI isolate drops frames, so above the threshold both json.decode
+    // and fromJson run on a short-lived isolate; small payloads skip the isolate spawn cost
+    void generateBackgroundDecoder(const std::string& className, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string threshold = static_cast<char>(std::tolower(static_cast<unsigned char>(className[0]))) + className.substr(1) + "BackgroundThreshold";
+
+        outFile << "/// Source length, in UTF-16 code units, from which [decode" << className << "InBackground] uses a background isolate.\n"
+            << "const int " << threshold << " = 64 * 1024;\n\n"
+            << "/// Decodes [source] into a [" << className << "], on a background isolate when it is at least [threshold] long.\n"
+            << "Future<" << className << "> decode" << className << "InBackground(String source, {int threshold = " << threshold << "}) {\n"
+            << indent1 << className << " decode() => " << className << ".fromJson(json.decode(source) as Map<String, dynamic>);\n"
+            << indent1 << "return source.length < threshold ? Future.sync(decode) : Isolate.run(decode);\n"
+            << "}\n\n";
+    }
+
+    // Patterns are compiled once into static fields of the extension; every other keyword is a plain
+    // comparison. Fields are non-nullable, so `required` is enforced by fromJson; lengths are UTF-16 code units
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "extension " << className << "Validator on " << className << " {\n";
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !isParsed(className, key)) {
+                outFile << indent1 << "static final _" << key << "Pattern = RegExp(" << dartString(*constraints.pattern) << ");\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        outFile << indent1 << "bool isValid() {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if (" << violation << ") return false;\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            // A formatted field was checked by its parser when it was decoded
+            if (isParsed(className, key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check(key + ".length < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(key + ".length > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check("!_" + key + "Pattern.hasMatch(" + key + ")");
+            }
+            if (value.is_number()) {
+                if (constraints.minimum) check(key + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum) check(key + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + key + " != " + (candidate.is_string() ? dartString(candidate.get<std::string>()) : candidate.dump());
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(key + ".length < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(key + ".length > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent2 << "for (var i = 0; i < " << key << ".length; i++) {\n"
+                        << indent3 << "if (!" << key << "[i].isValid()) return false;\n"
+                        << indent2 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check("!" + key + ".isValid()");
+            }
+        }
+        outFile << indent2 << "return true;\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    // UUIDs stay strings, so only date-times and bytes lose their string constraints
+    bool isParsed(const std::string& className, const std::string& key) {
+        return stringFormats[className].count(key) && stringFormats[className][key].kind != StringFormat::Kind::UUID;
+    }
+
+    std::string dartString(const std::string& text) {
+        std::string result = "'";
+        for (char c : text) {
+            if (c == '\'' || c == '\\' || c == '$') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "'";
+    }
+};
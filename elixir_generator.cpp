@@ -1,128 +1,558 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class ElixirGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "defmodule " << config.outputFile.substr(0, config.outputFile.find_last_of('.')) << " do\n"
-            << std::string(config.indentSize, ' ') << "use Ecto.Schema\n"
-            << std::string(config.indentSize, ' ') << "import Ecto.Changeset\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << std::string(config.indentSize, ' ') << "@type " << name << " :: ";
-                    for (size_t i = 0; i < def["enum"].size(); ++i) {
-                        outFile << ":" << def["enum"][i];
-                        if (i < def["enum"].size() - 1) {
-                            outFile << " | ";
-                        }
-                    }
-                    outFile << "\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << std::string(config.indentSize, ' ') << "schema \"" << className.substr(0, 1) + className.substr(1) << "\" do\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize * 2, ' ') << "# " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize * 2, ' ') << "field :" << key << ", " << type << "\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << std::string(config.indentSize, ' ') << "end\n\n";
-
-        generateChangeset(className, data, outFile, config);
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "defmodule " << className << "Test do\n"
-            << std::string(config.indentSize, ' ') << "use ExUnit.Case\n"
-            << std::string(config.indentSize, ' ') << "alias " << config.outputFile.substr(0, config.outputFile.find_last_of('.')) << "." << className << "\n\n"
-            << std::string(config.indentSize, ' ') << "test \"serialization and deserialization\" do\n"
-            << std::string(config.indentSize * 2, ' ') << "sample_json = \"\"\"" << sampleData.dump() << "\"\"\"\n"
-            << std::string(config.indentSize * 2, ' ') << "{:ok, decoded} = Jason.decode(sample_json)\n"
-            << std::string(config.indentSize * 2, ' ') << "changeset = " << className << ".changeset(%" << className << "{}, decoded)\n"
-            << std::string(config.indentSize * 2, ' ') << "assert changeset.valid?\n"
-            << std::string(config.indentSize * 2, ' ') << "obj = Ecto.Changeset.apply_changes(changeset)\n"
-            << std::string(config.indentSize * 2, ' ') << "serialized = Jason.encode!(obj)\n"
-            << std::string(config.indentSize * 2, ' ') << "assert Jason.decode!(serialized) == decoded\n"
-            << std::string(config.indentSize, ' ') << "end\n"
-            << "end\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return ":any";
-        if (value.is_boolean()) return ":boolean";
-        if (value.is_number_integer()) return ":integer";
-        if (value.is_number_float()) return ":float";
-        if (value.is_string()) return ":string";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "{:array, " + toLanguageType(value[0], config) + "}";
-            }
-            return "{:array, :any}";
-        }
-        if (value.is_object()) return ":map";
-        return ":any";
-    }
-
-private:
-    void generateChangeset(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize, ' ') << "def changeset(struct, params \\\\ %{}) do\n"
-            << std::string(config.indentSize * 2, ' ') << "struct\n"
-            << std::string(config.indentSize * 2, ' ') << "|> cast(params, [";
-
-        bool first = true;
-        for (auto& [key, value] : data.items()) {
-            if (!first) {
-                outFile << ", ";
-            }
-            outFile << ":" << key;
-            first = false;
-        }
-
-        outFile << "])\n"
-            << std::string(config.indentSize * 2, ' ') << "|> validate_required([";
-
-        first = true;
-        for (auto& [key, value] : data.items()) {
-            if (!first) {
-                outFile << ", ";
-            }
-            outFile << ":" << key;
-            first = false;
-        }
-
-        outFile << "])\n"
-            << std::string(config.indentSize, ' ') << "end\n\n";
-    }
-
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize, ' ') << "def valid?(%" << className << "{} = struct) do\n"
-            << std::string(config.indentSize * 2, ' ') << "# TODO: Implement validation logic\n"
-            << std::string(config.indentSize * 2, ' ') << "true\n"
-            << std::string(config.indentSize, ' ') << "end\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class ElixirGenerator : public LanguageGenerator {
+public:
+    // Every class becomes a module nested in one namespace module named after the output file, so
+    // siblings refer to each other by their short alias
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "defmodule " << namespaceName(config) << " do\n";
+    }
+
+    // Each enum is a sibling module holding its atoms; the atoms exist at compile time, so decoding never
+    // creates one at runtime. Values that would read back as true, false or nil stay plain strings
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (auto it = enums.begin(); it != enums.end();) {
+            const std::vector<std::string>& values = it->second.values;
+            bool special = std::any_of(values.begin(), values.end(), [](const std::string& v) { return v == "true" || v == "false" || v == "nil"; });
+            it = special ? enums.erase(it) : std::next(it);
+        }
+        for (const auto& [name, definition] : enums) {
+            std::string atoms;
+            for (const auto& value : definition.values) {
+                atoms += (atoms.empty() ? "" : ", ") + atom(value);
+            }
+            outFile << indent1 << "defmodule " << name << " do\n"
+                << indent2 << "@type t :: ";
+            for (size_t i = 0; i < definition.values.size(); ++i) {
+                outFile << (i > 0 ? " | " : "") << atom(definition.values[i]);
+            }
+            outFile << "\n\n"
+                << indent2 << "def values, do: [" << atoms << "]\n";
+            if (config.staticCodecs) {
+                outFile << "\n"
+                    << indent2 << "@spec decode(String.t()) :: {:ok, t()} | {:error, {:invalid, module()}}\n";
+                for (const auto& value : definition.values) {
+                    outFile << indent2 << "def decode(" << quoted(value) << "), do: {:ok, " << atom(value) << "}\n";
+                }
+                outFile << indent2 << "def decode(_other), do: {:error, {:invalid, __MODULE__}}\n";
+            }
+            outFile << indent1 << "end\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        ++depth;
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        // Nested modules come first; embeds_one/embeds_many and from_map/1 need them compiled
+        for (auto& [key, value] : data.items()) {
+            // Ecto embeds have a single schema, so only the struct codecs dispatch on a union's tag
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged && config.staticCodecs) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                for (const auto& variant : tagged->variants) {
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+                generateUnion(newClassName, *tagged, outFile, config);
+            }
+            else if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                if (value.is_array()) {
+                    listItemClasses.insert(newClassName);
+                }
+                const json& sample = value.is_array() ? value[0] : value;
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+            }
+        }
+
+        outFile << std::string(config.indentSize, ' ') << "defmodule " << className << " do\n";
+        if (config.staticCodecs) {
+            generateStruct(className, data, outFile, config);
+            generateFromMap(className, data, outFile, config);
+        }
+        else {
+            generateSchema(className, data, schema, outFile, config);
+            generateChangeset(data, outFile, config);
+        }
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+        outFile << std::string(config.indentSize, ' ') << "end\n";
+
+        if (--depth == 0) {
+            outFile << "end\n";
+        }
+        else {
+            outFile << "\n";
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "defmodule " << namespaceName(config) << "." << className << "Test do\n"
+            << std::string(config.indentSize, ' ') << "use ExUnit.Case\n"
+            << std::string(config.indentSize, ' ') << "alias " << namespaceName(config) << "." << className << "\n\n"
+            << std::string(config.indentSize, ' ') << "test \"serialization and deserialization\" do\n"
+            << std::string(config.indentSize * 2, ' ') << "sample_json = ~S\"\"\"\n"
+            << std::string(config.indentSize * 2, ' ') << sampleData.dump() << "\n"
+            << std::string(config.indentSize * 2, ' ') << "\"\"\"\n"
+            << std::string(config.indentSize * 2, ' ') << "{:ok, decoded} = Jason.decode(sample_json)\n";
+        if (config.staticCodecs) {
+            testFile << std::string(config.indentSize * 2, ' ') << "{:ok, obj} = " << className << ".from_map(decoded)\n";
+        }
+        else {
+            testFile << std::string(config.indentSize * 2, ' ') << "changeset = " << className << ".changeset(%" << className << "{}, decoded)\n"
+                << std::string(config.indentSize * 2, ' ') << "assert changeset.valid?\n"
+                << std::string(config.indentSize * 2, ' ') << "obj = Ecto.Changeset.apply_changes(changeset)\n";
+        }
+        testFile << std::string(config.indentSize * 2, ' ') << "serialized = Jason.encode!(obj)\n";
+        if (config.stringFormats) {
+            // Date-times are written back in UTC, so the output is compared with its own round trip
+            testFile << std::string(config.indentSize * 2, ' ') << (config.staticCodecs
+                    ? "{:ok, reparsed} = " + className + ".from_map(Jason.decode!(serialized))\n"
+                    : "reparsed = Ecto.Changeset.apply_changes(" + className + ".changeset(%" + className + "{}, Jason.decode!(serialized)))\n")
+                << std::string(config.indentSize * 2, ' ') << "assert Jason.encode!(reparsed) == serialized\n";
+        }
+        else {
+            testFile << std::string(config.indentSize * 2, ' ') << "assert Jason.decode!(serialized) == decoded\n";
+        }
+        testFile << std::string(config.indentSize, ' ') << "end\n"
+            << "end\n";
+
+        if (config.staticCodecs) {
+            generateBenchmark(className, sampleData, config);
+        }
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return ":any";
+        if (value.is_boolean()) return ":boolean";
+        if (value.is_number_integer()) return ":integer";
+        if (value.is_number_float()) return ":float";
+        if (value.is_string()) return ":string";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "{:array, " + toLanguageType(value[0], config) + "}";
+            }
+            return "{:array, :any}";
+        }
+        if (value.is_object()) return ":map";
+        return ":any";
+    }
+
+private:
+    std::set<std::string> listItemClasses;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    int depth = 0;
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    // The output file name, camel-cased: out/user_model.ex -> UserModel
+    std::string namespaceName(const Config& config) {
+        std::string stem = config.outputFile.substr(config.outputFile.find_last_of("/\\") + 1);
+        stem = stem.substr(0, stem.find('.'));
+        std::string result;
+        bool upper = true;
+        for (unsigned char c : stem) {
+            if (!std::isalnum(c)) {
+                upper = true;
+                continue;
+            }
+            result += upper ? static_cast<char>(std::toupper(c)) : static_cast<char>(c);
+            upper = false;
+        }
+        if (result.empty() || std::isdigit(static_cast<unsigned char>(result[0]))) {
+            result = "Model" + result;
+        }
+        return result;
+    }
+
+    bool isIdentifier(const std::string& key) {
+        if (key.empty() || !(std::islower(static_cast<unsigned char>(key[0])) || key[0] == '_')) return false;
+        return std::all_of(key.begin(), key.end(), [](unsigned char c) { return std::isalnum(c) || c == '_'; });
+    }
+
+    std::string quoted(const std::string& key) {
+        std::string result = "\"";
+        for (char c : key) {
+            if (c == '"' || c == '\\' || c == '#') result += '\\';
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    // :name, or :"first name" for keys that are not plain identifiers; the atoms exist at compile time
+    std::string atom(const std::string& key) {
+        return ":" + (isIdentifier(key) ? key : quoted(key));
+    }
+
+    std::string keywordKey(const std::string& key) {
+        return (isIdentifier(key) ? key : quoted(key)) + ":";
+    }
+
+    std::string fieldAccess(const std::string& key) {
+        return isIdentifier(key) ? "struct." + key : "Map.get(struct, " + atom(key) + ")";
+    }
+
+    std::string variableName(const std::string& key) {
+        static const std::set<std::string> reserved = {
+            "after", "and", "catch", "do", "else", "end", "false", "fn", "in", "nil", "not", "or", "rescue", "true", "when"
+        };
+        std::string result;
+        for (unsigned char c : key) {
+            result += std::isalnum(c) ? static_cast<char>(std::tolower(c)) : '_';
+        }
+        if (result.empty() || std::isdigit(static_cast<unsigned char>(result[0]))) {
+            result = "v_" + result;
+        }
+        return reserved.count(result) ? result + "_" : result;
+    }
+
+    // Date-times decode to DateTime; Elixir has no UUID or binary type that Jason would write back as
+    // text, so those stay strings (Ecto.UUID still checks UUIDs in changesets)
+    bool isDateTime(const std::string& className, const std::string& key) {
+        return stringFormats[className].count(key) && stringFormats[className][key].kind == StringFormat::Kind::DATE_TIME;
+    }
+
+    std::string typeSpec(const std::string& className, const std::string& key, const json& value) {
+        if (enumFields[className].count(key)) return enumFields[className][key] + ".t()";
+        if (isDateTime(className, key)) return "DateTime.t()";
+        if (value.is_boolean()) return "boolean()";
+        if (value.is_number_integer()) return "integer()";
+        if (value.is_number_float()) return "number()";
+        if (value.is_string()) return "String.t()";
+        if (value.is_object()) return className + "_" + key + ".t()";
+        if (isArrayOfObjects(value)) return "[" + className + "_" + key + ".t()]";
+        if (value.is_array()) return value.empty() ? "list()" : "[" + typeSpec(className, key, value[0]) + "]";
+        return "any()";
+    }
+
+    std::string typeGuard(const json& value, const std::string& variable) {
+        if (value.is_boolean()) return "is_boolean(" + variable + ")";
+        if (value.is_number_integer()) return "is_integer(" + variable + ")";
+        if (value.is_number_float()) return "is_number(" + variable + ")";
+        if (value.is_string()) return "is_binary(" + variable + ")";
+        if (value.is_array()) return "is_list(" + variable + ")";
+        if (value.is_object()) return "is_map(" + variable + ")";
+        return "";
+    }
+
+    void generateDocComment(const json& schema, const std::string& key, std::ofstream& outFile, const Config& config) {
+        if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+            outFile << std::string(config.indentSize * 2, ' ') << "# " << schema["properties"][key]["description"].get<std::string>() << "\n";
+        }
+    }
+
+    void generateSchema(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        outFile << std::string(config.indentSize * 2, ' ') << "use Ecto.Schema\n"
+            << std::string(config.indentSize * 2, ' ') << "import Ecto.Changeset\n\n"
+            << std::string(config.indentSize * 2, ' ') << "@primary_key false\n"
+            << std::string(config.indentSize * 2, ' ') << "@derive Jason.Encoder\n"
+            << std::string(config.indentSize * 2, ' ') << "embedded_schema do\n";
+        for (auto& [key, value] : data.items()) {
+            generateDocComment(schema, key, outFile, config);
+            outFile << std::string(config.indentSize * 3, ' ');
+            if (value.is_object()) {
+                outFile << "embeds_one " << atom(key) << ", " << className << "_" << key << "\n";
+            }
+            else if (isArrayOfObjects(value)) {
+                outFile << "embeds_many " << atom(key) << ", " << className << "_" << key << "\n";
+            }
+            else if (enumFields[className].count(key)) {
+                std::string atoms;
+                for (const auto& option : enums[enumFields[className][key]].values) {
+                    atoms += (atoms.empty() ? "" : ", ") + atom(option);
+                }
+                outFile << "field " << atom(key) << ", Ecto.Enum, values: [" << atoms << "]\n";
+            }
+            else if (value.is_string() && stringFormats[className].count(key) && stringFormats[className][key].kind != StringFormat::Kind::BYTES) {
+                outFile << "field " << atom(key) << ", " << (isDateTime(className, key) ? ":utc_datetime_usec" : "Ecto.UUID") << "\n";
+            }
+            else {
+                outFile << "field " << atom(key) << ", " << toLanguageType(value, config, key) << "\n";
+            }
+        }
+        outFile << std::string(config.indentSize * 2, ' ') << "end\n\n";
+    }
+
+    void generateChangeset(const json& data, std::ofstream& outFile, const Config& config) {
+        std::string fields;
+        for (auto& [key, value] : data.items()) {
+            if (!value.is_object() && !isArrayOfObjects(value)) {
+                fields += (fields.empty() ? "" : ", ") + atom(key);
+            }
+        }
+
+        outFile << std::string(config.indentSize * 2, ' ') << "def changeset(struct, params \\\\ %{}) do\n"
+            << std::string(config.indentSize * 3, ' ') << "struct\n"
+            << std::string(config.indentSize * 3, ' ') << "|> cast(params, [" << fields << "])\n";
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                outFile << std::string(config.indentSize * 3, ' ') << "|> cast_embed(" << atom(key) << ", required: true)\n";
+            }
+        }
+        outFile << std::string(config.indentSize * 3, ' ') << "|> validate_required([" << fields << "])\n"
+            << std::string(config.indentSize * 2, ' ') << "end\n";
+    }
+
+    void generateStruct(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        outFile << std::string(config.indentSize * 2, ' ') << "@type t :: %__MODULE__{";
+        bool first = true;
+        for (auto& [key, value] : data.items()) {
+            outFile << (first ? "\n" : ",\n") << std::string(config.indentSize * 3, ' ') << keywordKey(key) << " " << typeSpec(className, key, value);
+            first = false;
+        }
+        outFile << (first ? "}\n\n" : "\n" + std::string(config.indentSize * 2, ' ') + "}\n\n");
+
+        outFile << std::string(config.indentSize * 2, ' ') << "@derive Jason.Encoder\n"
+            << std::string(config.indentSize * 2, ' ') << "defstruct [";
+        first = true;
+        for (auto& [key, value] : data.items()) {
+            outFile << (first ? "" : ", ") << atom(key);
+            first = false;
+        }
+        outFile << "]\n\n";
+    }
+
+    // Decoding is a single function head that matches every field by its binary key, with type guards.
+    // Struct keys are literal atoms, so nothing is converted at runtime and no changeset is allocated
+    void generateFromMap(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string pattern;
+        std::string guards;
+        std::vector<std::string> nestedDecodes;
+        std::string fields;
+        for (auto& [key, value] : data.items()) {
+            std::string variable = variableName(key);
+            pattern += (pattern.empty() ? "" : ", ") + quoted(key) + " => " + variable;
+            std::string guard = typeGuard(value, variable);
+            if (!guard.empty()) {
+                guards += (guards.empty() ? "" : " and ") + guard;
+            }
+            if (value.is_object()) {
+                nestedDecodes.push_back("{:ok, " + variable + "} <- " + className + "_" + key + ".from_map(" + variable + ")");
+            }
+            else if (isArrayOfObjects(value)) {
+                nestedDecodes.push_back("{:ok, " + variable + "} <- " + className + "_" + key + ".from_list(" + variable + ")");
+            }
+            else if (enumFields[className].count(key)) {
+                nestedDecodes.push_back("{:ok, " + variable + "} <- " + enumFields[className][key] + ".decode(" + variable + ")");
+            }
+            else if (isDateTime(className, key)) {
+                nestedDecodes.push_back("{:ok, " + variable + "} <- decode_date_time(" + variable + ")");
+            }
+            fields += (fields.empty() ? "" : ", ") + keywordKey(key) + " " + variable;
+        }
+
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        outFile << indent2 << "@spec from_map(map()) :: {:ok, t()} | {:error, {:invalid, module()}}\n"
+            << indent2 << "def from_map(" << (pattern.empty() ? "map" : "%{" + pattern + "}") << ")"
+            << (pattern.empty() ? " when is_map(map)" : guards.empty() ? "" : " when " + guards) << " do\n";
+        std::string result = "{:ok, %__MODULE__{" + fields + "}}";
+        if (nestedDecodes.empty()) {
+            outFile << indent3 << result << "\n";
+        }
+        else {
+            for (size_t i = 0; i < nestedDecodes.size(); ++i) {
+                outFile << (i == 0 ? indent3 + "with " : indent3 + "     ") << nestedDecodes[i] << (i + 1 < nestedDecodes.size() ? ",\n" : " do\n");
+            }
+            outFile << indent4 << result << "\n"
+                << indent3 << "end\n";
+        }
+        outFile << indent2 << "end\n\n"
+            << indent2 << "def from_map(_other), do: {:error, {:invalid, __MODULE__}}\n";
+
+        if (std::any_of(data.items().begin(), data.items().end(), [&](const auto& item) { return isDateTime(className, item.key()); })) {
+            outFile << "\n"
+                << indent2 << "defp decode_date_time(text) do\n"
+                << indent3 << "case DateTime.from_iso8601(text) do\n"
+                << indent4 << "{:ok, date_time, _offset} -> {:ok, date_time}\n"
+                << indent4 << "{:error, _reason} -> {:error, {:invalid, __MODULE__}}\n"
+                << indent3 << "end\n"
+                << indent2 << "end\n";
+        }
+
+        if (listItemClasses.count(className)) {
+            generateFromList(outFile, config);
+        }
+    }
+
+    // A union is a module whose from_map/1 clauses match the tag and hand the map to that variant
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        outFile << indent1 << "defmodule " << className << " do\n"
+            << indent2 << "@type t :: ";
+        for (size_t i = 0; i < tagged.variants.size(); ++i) {
+            outFile << (i > 0 ? " | " : "") << className << "_" << tagged.variants[i].name << ".t()";
+        }
+        outFile << "\n\n"
+            << indent2 << "@spec from_map(map()) :: {:ok, t()} | {:error, {:invalid, module()}}\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << indent2 << "def from_map(%{" << quoted(tagged.property) << " => " << quoted(variant.tag) << "} = map), do: "
+                << className << "_" << variant.name << ".from_map(map)\n";
+        }
+        outFile << indent2 << "def from_map(_other), do: {:error, {:invalid, __MODULE__}}\n";
+        generateFromList(outFile, config);
+        if (config.generateValidation) {
+            outFile << "\n";
+            for (const auto& variant : tagged.variants) {
+                std::string variantClass = className + "_" + variant.name;
+                outFile << indent2 << "def valid?(%" << variantClass << "{} = struct), do: " << variantClass << ".valid?(struct)\n";
+            }
+            outFile << indent2 << "def valid?(_other), do: false\n";
+        }
+        outFile << indent1 << "end\n\n";
+    }
+
+    void generateFromList(std::ofstream& outFile, const Config& config) {
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        outFile << "\n"
+            << indent2 << "@doc false\n"
+            << indent2 << "def from_list(items), do: from_list(items, [])\n\n"
+            << indent2 << "defp from_list([item | rest], acc) do\n"
+            << indent3 << "case from_map(item) do\n"
+            << indent4 << "{:ok, value} -> from_list(rest, [value | acc])\n"
+            << indent4 << "error -> error\n"
+            << indent3 << "end\n"
+            << indent2 << "end\n\n"
+            << indent2 << "defp from_list([], acc), do: {:ok, :lists.reverse(acc)}\n"
+            << indent2 << "defp from_list(_other, _acc), do: {:error, {:invalid, __MODULE__}}\n";
+    }
+
+    // Benchee script written next to the model as <Class>_bench.exs. The changeset side casts the same
+    // top-level fields through a schemaless changeset, with nested objects as plain maps
+    void generateBenchmark(const std::string& className, const json& sampleData, const Config& config) {
+        size_t slash = config.outputFile.find_last_of("/\\");
+        std::string directory = config.outputFile.substr(0, slash + 1);
+        std::ofstream benchFile(directory + className + "_bench.exs");
+        if (!benchFile.is_open()) {
+            return;
+        }
+
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        benchFile << "# Pattern-matching from_map/1 versus an Ecto changeset for the " << className << " sample.\n"
+            << "# Needs {:jason, :benchee, :ecto} and the model compiled; run with: mix run " << className << "_bench.exs\n"
+            << "alias " << namespaceName(config) << "." << className << "\n\n"
+            << "sample = Jason.decode!(~S\"\"\"\n"
+            << sampleData.dump() << "\n"
+            << "\"\"\")\n\n"
+            << "types = %{";
+        bool first = true;
+        for (auto& [key, value] : sampleData.items()) {
+            std::string type = value.is_object() ? ":map" : isArrayOfObjects(value) ? "{:array, :map}" : toLanguageType(value, config, key);
+            benchFile << (first ? "" : ", ") << keywordKey(key) << " " << type;
+            first = false;
+        }
+        benchFile << "}\n"
+            << "fields = Map.keys(types)\n\n"
+            << "Benchee.run(\n"
+            << indent1 << "%{\n"
+            << indent2 << "\"from_map/1\" => fn -> {:ok, _} = " << className << ".from_map(sample) end,\n"
+            << indent2 << "\"Ecto changeset\" => fn ->\n"
+            << indent3 << "{%{}, types}\n"
+            << indent3 << "|> Ecto.Changeset.cast(sample, fields)\n"
+            << indent3 << "|> Ecto.Changeset.validate_required(fields)\n"
+            << indent3 << "|> Ecto.Changeset.apply_changes()\n"
+            << indent2 << "end\n"
+            << indent1 << "},\n"
+            << indent1 << "time: 5,\n"
+            << indent1 << "memory_time: 2\n"
+            << ")\n";
+    }
+
+    // A single `and` chain; ~r sigils are compiled with the module, and fields that are not required
+    // are only checked when present. Lengths are String.length graphemes
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::vector<std::string> conditions;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = fieldAccess(key);
+            std::vector<std::string> checks;
+            // A date-time field was checked by its parser when it was decoded
+            if (value.is_string() && !isDateTime(className, key)) {
+                if (constraints.minLength) checks.push_back("String.length(" + field + ") >= " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) checks.push_back("String.length(" + field + ") <= " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) checks.push_back("Regex.match?(" + regexSigil(*constraints.pattern) + ", " + field + ")");
+            }
+            if (value.is_number()) {
+                if (constraints.minimum) checks.push_back(field + " >= " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum) checks.push_back(field + " <= " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string candidates;
+                for (const auto& candidate : allowed) {
+                    candidates += (candidates.empty() ? "" : ", ") + candidate.dump();
+                }
+                checks.push_back(field + " in [" + candidates + "]");
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) checks.push_back("length(" + field + ") >= " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) checks.push_back("length(" + field + ") <= " + std::to_string(*constraints.maxItems));
+                if (isArrayOfObjects(value)) {
+                    checks.push_back("Enum.all?(" + field + ", &" + className + "_" + key + ".valid?/1)");
+                }
+            }
+            if (value.is_object()) {
+                checks.push_back(className + "_" + key + ".valid?(" + field + ")");
+            }
+
+            std::string joined;
+            for (const auto& check : checks) {
+                joined += (joined.empty() ? "" : " and ") + check;
+            }
+            if (constraints.required) {
+                conditions.push_back("not is_nil(" + field + ")");
+                if (!joined.empty()) conditions.push_back(joined);
+            }
+            else if (!joined.empty()) {
+                conditions.push_back("(is_nil(" + field + ") or " + (checks.size() > 1 ? "(" + joined + ")" : joined) + ")");
+            }
+        }
+
+        outFile << "\n";
+        if (conditions.empty()) {
+            outFile << std::string(config.indentSize * 2, ' ') << "def valid?(%__MODULE__{}), do: true\n";
+            return;
+        }
+        outFile << std::string(config.indentSize * 2, ' ') << "def valid?(%__MODULE__{} = struct) do\n";
+        for (size_t i = 0; i < conditions.size(); ++i) {
+            outFile << std::string(config.indentSize * (i == 0 ? 3 : 4), ' ') << conditions[i] << (i + 1 < conditions.size() ? " and\n" : "\n");
+        }
+        outFile << std::string(config.indentSize * 2, ' ') << "end\n";
+    }
+
+    // Only the delimiter and interpolation need escaping; regex escapes pass through ~r unchanged
+    std::string regexSigil(const std::string& pattern) {
+        std::string result = "~r/";
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] == '/' || (pattern[i] == '#' && i + 1 < pattern.size() && pattern[i + 1] == '{')) {
+                result += '\\';
+            }
+            result += pattern[i];
+        }
+        return result + "/u";
+    }
+};
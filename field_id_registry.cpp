@@ -0,0 +1,54 @@
+#include "json_model_generator.hpp"
+#include <algorithm>
+#include <iostream>
+
+void FieldIdRegistry::load(const std::string& filename) {
+    this->filename = filename;
+    std::ifstream file(filename);
+    if (file.is_open()) {
+        file >> ids;
+    }
+}
+
+void FieldIdRegistry::save() const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to write field id file: " + filename);
+    }
+    file << ids.dump(4) << std::endl;
+}
+
+int FieldIdRegistry::assign(const std::string& typeName, const std::string& fieldName, const std::string& fieldType, int firstId) {
+    json& typeIds = ids[typeName];
+    if (typeIds.contains(fieldName)) {
+        if (typeIds[fieldName]["type"] == fieldType) {
+            return typeIds[fieldName]["id"].get<int>();
+        }
+        // Data written with the old type must not be read as the new one, so the old id is retired under
+        // a name of its own, like a removed field, and the field gets a fresh id below
+        json previous = typeIds[fieldName];
+        std::string retiredName = fieldName + "_retired" + std::to_string(previous["id"].get<int>());
+        previous["retired"] = true;
+        typeIds[retiredName] = previous;
+        typeIds.erase(fieldName);
+        std::cerr << "Warning: " << typeName << "." << fieldName << " changed type from " << previous["type"].get<std::string>()
+            << " to " << fieldType << "; id " << previous["id"].get<int>() << " is retired as " << retiredName << std::endl;
+    }
+    int nextId = firstId;
+    for (auto& [name, entry] : typeIds.items()) {
+        nextId = std::max(nextId, entry["id"].get<int>() + 1);
+    }
+    typeIds[fieldName] = { {"id", nextId}, {"type", fieldType} };
+    return nextId;
+}
+
+std::vector<FieldIdRegistry::Field> FieldIdRegistry::fields(const std::string& typeName) const {
+    std::vector<Field> result;
+    if (ids.contains(typeName)) {
+        for (auto& [name, entry] : ids[typeName].items()) {
+            result.push_back({ entry["id"].get<int>(), name, entry["type"].get<std::string>(), entry.value("retired", false) });
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Field& a, const Field& b) { return a.id < b.id; });
+    return result;
+}
@@ -0,0 +1,184 @@
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class FlatBuffersGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        fieldIds.load(config.outputFile + ".ids.json");
+        outFile << "// Field ids are persisted in " << config.outputFile << ".ids.json; keep it under version control.\n\n"
+            << "namespace JsonModel;\n\n";
+    }
+
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        if (schema.contains("definitions")) {
+            for (auto& [name, def] : schema["definitions"].items()) {
+                if (def.contains("enum")) {
+                    enumNames.insert(name);
+                    declaredTypes.insert(name);
+                    outFile << "enum " << name << " : ubyte {\n";
+                    for (size_t i = 0; i < def["enum"].size(); ++i) {
+                        const json& value = def["enum"][i];
+                        outFile << std::string(config.indentSize, ' ') << (value.is_string() ? value.get<std::string>() : value.dump());
+                        if (i < def["enum"].size() - 1) {
+                            outFile << ",";
+                        }
+                        outFile << "\n";
+                    }
+                    outFile << "}\n\n";
+                }
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        ++depth;
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+
+        // Nested types are declared first; FlatBuffers has no nested declarations
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                const json& sample = value.is_array() ? value[0] : value;
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+            }
+        }
+
+        // Fixed-size all-scalar objects are stored inline as structs; the root must stay a table
+        if (depth > 1 && isInlineStruct(className, data)) {
+            generateStruct(className, data, schema, outFile, config);
+        }
+        else {
+            generateTable(className, data, schema, outFile, config);
+        }
+
+        if (--depth == 0) {
+            outFile << "root_type " << className << ";\n";
+            fieldIds.save();
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "// Round-trip check for " << className << " against the generated schema:\n"
+            << "//   flatc --binary --strict-json " << config.outputFile << " sample.json\n"
+            << "//   flatc --json --strict-json --raw-binary -o roundtrip " << config.outputFile << " -- sample.bin\n"
+            << "//   diff <(jq -S . sample.json) <(jq -S . roundtrip/sample.json)\n"
+            << "//\n"
+            << "// sample.json:\n"
+            << "// " << sampleData.dump() << "\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "[ubyte]";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "long";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "string";
+        if (value.is_array()) {
+            // Vectors of vectors are not allowed, so untyped and nested arrays fall back to a flexbuffer
+            if (!value.empty() && !value[0].is_null() && !value[0].is_array()) {
+                return "[" + toLanguageType(value[0], config, key) + "]";
+            }
+            return "[ubyte]";
+        }
+        if (value.is_object()) return key;
+        return "[ubyte]";
+    }
+
+private:
+    FieldIdRegistry fieldIds;
+    std::set<std::string> enumNames;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, bool> structTypes;
+    std::set<std::string> declaredTypes;
+    int depth = 0;
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    bool isInlineStruct(const std::string& className, const json& data) {
+        if (data.empty()) return false;
+        for (auto& [key, value] : data.items()) {
+            bool scalar = value.is_boolean() || value.is_number();
+            bool nestedStruct = value.is_object() && structTypes[className + "_" + key];
+            if (!scalar && !nestedStruct) return false;
+        }
+        return structTypes[className] = true;
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const json& schema) {
+        const json& property = propertySchema(schema, key);
+        if (property.contains("$ref")) {
+            std::string ref = property["$ref"].get<std::string>();
+            std::string name = ref.substr(ref.find_last_of('/') + 1);
+            if (enumNames.count(name)) return name;
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (isArrayOfObjects(value)) return "[" + className + "_" + key + "]";
+        if (NumberFormat::isNumeric(value) && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            static const std::map<int, std::string> widths = { { 8, "byte" }, { 16, "short" }, { 32, "int" }, { 64, "long" } };
+            std::string type = format.isFloat ? (format.bits == 32 ? "float" : "double") : (format.isUnsigned ? "u" : "") + widths.at(format.bits);
+            return value.is_array() ? "[" + type + "]" : type;
+        }
+        return toLanguageType(value, Config(), key);
+    }
+
+    void generateDocComment(const json& schema, const std::string& key, std::ofstream& outFile, const Config& config) {
+        if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+            outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"].get<std::string>() << "\n";
+        }
+    }
+
+    // Type for a deprecated field; it only reserves its id, so an enum or table that is no longer
+    // declared can be replaced by a byte vector
+    std::string retiredType(const std::string& type) {
+        static const std::set<std::string> builtins = { "bool", "byte", "ubyte", "short", "ushort", "int", "uint", "long", "ulong", "float", "double", "string" };
+        std::string base = type;
+        base.erase(std::remove(base.begin(), base.end(), '['), base.end());
+        base.erase(std::remove(base.begin(), base.end(), ']'), base.end());
+        return builtins.count(base) || declaredTypes.count(base) ? type : "[ubyte]";
+    }
+
+    void generateStruct(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        declaredTypes.insert(className);
+        outFile << "struct " << className << " {\n";
+        for (auto& [key, value] : data.items()) {
+            generateDocComment(schema, key, outFile, config);
+            outFile << std::string(config.indentSize, ' ') << key << ":" << fieldType(className, key, value, schema) << ";\n";
+        }
+        outFile << "}\n\n";
+    }
+
+    void generateTable(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        for (auto& [key, value] : data.items()) {
+            fieldIds.assign(className, key, fieldType(className, key, value, schema));
+        }
+
+        declaredTypes.insert(className);
+        outFile << "table " << className << " {\n";
+        for (const auto& field : fieldIds.fields(className)) {
+            std::string type = field.type;
+            std::string attributes = "id: " + std::to_string(field.id);
+            if (field.retired || !data.contains(field.name)) {
+                // Ids must stay contiguous, so fields missing from the sample or retired for a type change are kept as deprecated
+                type = retiredType(field.type);
+                attributes += ", deprecated";
+            }
+            else {
+                generateDocComment(schema, field.name, outFile, config);
+                // A narrowed array of small numbers is a real [ubyte], not the flexbuffer fallback
+                if (field.type == "[ubyte]" && !NumberFormat::isNumeric(data[field.name])) {
+                    attributes += ", flexbuffer";
+                }
+            }
+            outFile << std::string(config.indentSize, ' ') << field.name << ":" << type << " (" << attributes << ");\n";
+        }
+        outFile << "}\n\n";
+    }
+};
@@ -1,110 +1,1126 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class GoGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "package model\n\n"
-            << "import (\n"
-            << "\t\"encoding/json\"\n"
-            << ")\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "type " << name << " string\n\n"
-                        << "const (\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << name << value << " " << name << " = \"" << value << "\"\n";
-                    }
-                    outFile << ")\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "type " << className << " struct {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            std::string capitalizedKey = key;
-            capitalizedKey[0] = std::toupper(capitalizedKey[0]);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "// " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << capitalizedKey << " " << type << " `json:\"" << key << "\"`\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + capitalizedKey;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "package model_test\n\n"
-            << "import (\n"
-            << "\t\"encoding/json\"\n"
-            << "\t\"testing\"\n\n"
-            << "\t\"github.com/stretchr/testify/assert\"\n"
-            << "\t\"your_project/model\"\n"
-            << ")\n\n"
-            << "func Test" << className << "SerializationDeserialization(t *testing.T) {\n"
-            << std::string(config.indentSize, ' ') << "sampleJSON := []byte(`" << sampleData.dump() << "`)\n"
-            << std::string(config.indentSize, ' ') << "var obj model." << className << "\n"
-            << std::string(config.indentSize, ' ') << "err := json.Unmarshal(sampleJSON, &obj)\n"
-            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
-            << std::string(config.indentSize, ' ') << "serialized, err := json.Marshal(obj)\n"
-            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
-            << std::string(config.indentSize, ' ') << "var deserialized map[string]interface{}\n"
-            << std::string(config.indentSize, ' ') << "err = json.Unmarshal(serialized, &deserialized)\n"
-            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
-            << std::string(config.indentSize, ' ') << "var original map[string]interface{}\n"
-            << std::string(config.indentSize, ' ') << "err = json.Unmarshal(sampleJSON, &original)\n"
-            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
-            << std::string(config.indentSize, ' ') << "assert.Equal(t, original, deserialized)\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "interface{}";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "int";
-        if (value.is_number_float()) return "float64";
-        if (value.is_string()) return "string";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "[]" + toLanguageType(value[0], config);
-            }
-            return "[]interface{}";
-        }
-        if (value.is_object()) {
-            std::string capitalizedKey = key;
-            capitalizedKey[0] = std::toupper(capitalizedKey[0]);
-            return "*" + capitalizedKey;
-        }
-        return "interface{}";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "func (m *" << className << ") IsValid() bool {\n"
-            << std::string(config.indentSize, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize, ' ') << "return true\n"
-            << "}\n\n";
-    }
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+class GoGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        // Go rejects unused imports; struct tags alone need no package, so encoding/json is only imported
+        // for the codec runtime and the union decoders that call it, and regexp and unicode/utf8 only for the
+        // validation checks and the lexer that call them
+        std::vector<std::string> imports;
+        if (config.staticCodecs && config.stringFormats) imports.push_back("encoding/base64");
+        if (config.staticCodecs || config.taggedUnions) imports.push_back("encoding/json");
+        if (config.stringFormats) imports.push_back("errors");
+        if (config.staticCodecs || config.taggedUnions) imports.push_back("fmt");
+        if (config.stringPatterns) imports.push_back("regexp");
+        if (config.staticCodecs) {
+            imports.insert(imports.end(), { "sort", "strconv" });
+        }
+        if (config.stringFormats) imports.push_back("time");
+        if (config.staticCodecs) imports.push_back("unicode/utf16");
+        if (config.staticCodecs || config.stringLengths) imports.push_back("unicode/utf8");
+        outFile << "package model\n\n";
+        if (!imports.empty()) {
+            outFile << "import (\n";
+            for (const auto& path : imports) {
+                outFile << "\t\"" << path << "\"\n";
+            }
+            outFile << ")\n\n";
+        }
+        if (config.stringFormats) {
+            generateFormatsRuntime(outFile, config);
+        }
+        if (config.staticCodecs) {
+            generateCodecRuntime(outFile, config);
+        }
+    }
+
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << "type " << name << " string\n\n"
+                << "const (\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent1 << name << cases[i] << " " << name << " = " << goQuote(definition.values[i]) << "\n";
+            }
+            outFile << ")\n\n";
+            if (config.generateValidation) {
+                outFile << "func (v " << name << ") IsValid() bool {\n"
+                    << indent1 << "switch v {\n"
+                    << indent1 << "case ";
+                for (size_t i = 0; i < cases.size(); ++i) {
+                    outFile << (i > 0 ? ", " : "") << name << cases[i];
+                }
+                outFile << ":\n"
+                    << indent2 << "return true\n"
+                    << indent1 << "}\n"
+                    << indent1 << "return false\n"
+                    << "}\n\n";
+            }
+            if (config.staticCodecs) {
+                // Known values decode to the shared constants, so decoding them allocates nothing
+                outFile << "func parse" << name << "(b []byte) " << name << " {\n"
+                    << indent1 << "switch string(b) {\n";
+                for (size_t i = 0; i < cases.size(); ++i) {
+                    outFile << indent1 << "case " << goQuote(definition.values[i]) << ":\n"
+                        << indent2 << "return " << name << cases[i] << "\n";
+                }
+                outFile << indent1 << "}\n"
+                    << indent1 << "return " << name << "(b)\n"
+                    << "}\n\n";
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        outFile << "type " << className << " struct {\n";
+
+        for (auto& [key, value] : data.items()) {
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "// " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << exportedName(key) << " " << fieldType(className, key, value, config) << " `json:\"" << key << "\"`\n";
+        }
+
+        outFile << "}\n\n";
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        if (config.staticCodecs) {
+            generateCodecMethods(className, data, outFile, config);
+        }
+
+        // Go has no nested type declarations, so nested structs follow their parent
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + exportedName(key);
+                unions[className].insert(key);
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + exportedName(key);
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        // Benchmarks come first, since their reflection types decide whether the test imports "time"
+        std::ostringstream benchmarks;
+        if (config.staticCodecs) {
+            generateBenchmarks(className, sampleData, benchmarks, config);
+        }
+        testFile << "package model_test\n\n"
+            << "import (\n"
+            << "\t\"encoding/json\"\n"
+            << "\t\"testing\"\n"
+            << (reflectionUsesTime ? "\t\"time\"\n" : "") << "\n"
+            << "\t\"github.com/stretchr/testify/assert\"\n"
+            << "\t\"your_project/model\"\n"
+            << ")\n\n"
+            << "func Test" << className << "SerializationDeserialization(t *testing.T) {\n"
+            << std::string(config.indentSize, ' ') << "sampleJSON := []byte(`" << sampleData.dump() << "`)\n"
+            << std::string(config.indentSize, ' ') << "var obj model." << className << "\n"
+            << std::string(config.indentSize, ' ') << "err := json.Unmarshal(sampleJSON, &obj)\n"
+            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
+            << std::string(config.indentSize, ' ') << "serialized, err := json.Marshal(obj)\n"
+            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
+            << std::string(config.indentSize, ' ') << "var deserialized map[string]interface{}\n"
+            << std::string(config.indentSize, ' ') << "err = json.Unmarshal(serialized, &deserialized)\n"
+            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
+            << std::string(config.indentSize, ' ') << "var original map[string]interface{}\n"
+            << std::string(config.indentSize, ' ') << "err = json.Unmarshal(sampleJSON, &original)\n"
+            << std::string(config.indentSize, ' ') << "assert.NoError(t, err)\n\n"
+            << std::string(config.indentSize, ' ') << "assert.Equal(t, original, deserialized)\n"
+            << "}\n"
+            << benchmarks.str();
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "interface{}";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "int";
+        if (value.is_number_float()) return "float64";
+        if (value.is_string()) return "string";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "[]" + toLanguageType(value[0], config);
+            }
+            return "[]interface{}";
+        }
+        if (value.is_object()) {
+            std::string capitalizedKey = key;
+            capitalizedKey[0] = std::toupper(capitalizedKey[0]);
+            return "*" + capitalizedKey;
+        }
+        return "interface{}";
+    }
+
+private:
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    std::map<std::string, std::set<std::string>> unions;
+    bool reflectionUsesTime = false;
+
+    std::string exportedName(const std::string& key) {
+        std::string name = key;
+        if (!name.empty()) {
+            name[0] = std::toupper(name[0]);
+        }
+        return name;
+    }
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // Go interfaces cannot have methods of their own, so the union is a struct holding one variant behind
+    // an interface, with codecs that pick the variant by its tag. The variants keep their tag field.
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string variantType = className + "Variant";
+        std::string marker = "is" + className;
+        std::string tagField = goQuote(tagged.property);
+
+        outFile << "// " << className << " holds one of the " << className << "_* types, chosen by its " << tagField << " property.\n"
+            << "type " << className << " struct {\n"
+            << indent1 << "Value " << variantType << "\n"
+            << "}\n\n"
+            << "type " << variantType << " interface {\n"
+            << indent1 << marker << "()\n";
+        if (config.generateValidation) {
+            outFile << indent1 << "IsValid() bool\n";
+        }
+        if (config.staticCodecs) {
+            outFile << indent1 << "appendJSON(buf []byte) []byte\n";
+        }
+        outFile << "}\n\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << "func (*" << className << "_" << variant.name << ") " << marker << "() {}\n";
+        }
+        outFile << "\n";
+
+        if (config.generateValidation) {
+            outFile << "func (m *" << className << ") IsValid() bool {\n"
+                << indent1 << "return m.Value == nil || m.Value.IsValid()\n"
+                << "}\n\n";
+        }
+
+        if (config.staticCodecs) {
+            outFile << "// UnmarshalJSON decodes m without reflection.\n"
+                << "func (m *" << className << ") UnmarshalJSON(data []byte) error {\n"
+                << indent1 << "l := jsonLexer{data: data}\n"
+                << indent1 << "m.decodeJSON(&l)\n"
+                << indent1 << "l.end()\n"
+                << indent1 << "return l.err\n"
+                << "}\n\n"
+                << "func (m *" << className << ") decodeJSON(l *jsonLexer) {\n"
+                << indent1 << "if l.isNull() {\n"
+                << indent2 << "m.Value = nil\n"
+                << indent2 << "return\n"
+                << indent1 << "}\n"
+                // The lexer is a small struct, so a copy can look ahead for a tag that follows other properties
+                << indent1 << "scan := *l\n"
+                << indent1 << "scan.delim('{')\n"
+                << indent1 << "var tag []byte\n"
+                << indent1 << "for scan.more('}') {\n"
+                << indent2 << "if string(scan.readKey()) == " << tagField << " {\n"
+                << indent3 << "tag = scan.readStringBytes()\n"
+                << indent3 << "break\n"
+                << indent2 << "}\n"
+                << indent2 << "scan.skip()\n"
+                << indent1 << "}\n"
+                << indent1 << "if scan.err != nil {\n"
+                << indent2 << "l.err, l.pos = scan.err, len(l.data)\n"
+                << indent2 << "return\n"
+                << indent1 << "}\n"
+                << indent1 << "switch string(tag) {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent1 << "case " << goQuote(variant.tag) << ":\n"
+                    << indent2 << "variant := new(" << className << "_" << variant.name << ")\n"
+                    << indent2 << "variant.decodeJSON(l)\n"
+                    << indent2 << "m.Value = variant\n";
+            }
+            outFile << indent1 << "default:\n"
+                << indent2 << "l.fail(\"unknown " << className << " " << tagged.property << " \" + strconv.Quote(string(tag)))\n"
+                << indent1 << "}\n"
+                << "}\n\n"
+                << "// MarshalJSON encodes m without reflection.\n"
+                << "func (m " << className << ") MarshalJSON() ([]byte, error) {\n"
+                << indent1 << "return m.appendJSON(nil), nil\n"
+                << "}\n\n"
+                << "func (m *" << className << ") appendJSON(buf []byte) []byte {\n"
+                << indent1 << "if m.Value == nil {\n"
+                << indent2 << "return append(buf, \"null\"...)\n"
+                << indent1 << "}\n"
+                << indent1 << "return m.Value.appendJSON(buf)\n"
+                << "}\n\n";
+            return;
+        }
+
+        // encoding/json has no lookahead, so the tag is decoded on its own before the variant
+        outFile << "func (m *" << className << ") UnmarshalJSON(data []byte) error {\n"
+            << indent1 << "var probe struct {\n"
+            << indent2 << "Tag string `json:" << goQuote(tagged.property) << "`\n"
+            << indent1 << "}\n"
+            << indent1 << "if err := json.Unmarshal(data, &probe); err != nil {\n"
+            << indent2 << "return err\n"
+            << indent1 << "}\n"
+            << indent1 << "switch probe.Tag {\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << indent1 << "case " << goQuote(variant.tag) << ":\n"
+                << indent2 << "m.Value = new(" << className << "_" << variant.name << ")\n";
+        }
+        outFile << indent1 << "default:\n"
+            << indent2 << "return fmt.Errorf(\"unknown " << className << " " << tagged.property << " %q\", probe.Tag)\n"
+            << indent1 << "}\n"
+            << indent1 << "return json.Unmarshal(data, m.Value)\n"
+            << "}\n\n"
+            << "func (m " << className << ") MarshalJSON() ([]byte, error) {\n"
+            << indent1 << "return json.Marshal(m.Value)\n"
+            << "}\n\n";
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            // encoding/json already writes time.Time as RFC 3339 and []byte as base64
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "UUID";
+            case StringFormat::Kind::DATE_TIME: return "time.Time";
+            default: return "[]byte";
+            }
+        }
+        if (value.is_object()) return "*" + className + "_" + exportedName(key);
+        if (value.is_array() && !value.empty()) {
+            // encoding/json writes a []uint8 as base64, so byte-sized elements widen to uint16
+            std::string element = fieldType(className, key, value[0], config);
+            return "[]" + (element == "uint8" ? std::string("uint16") : element);
+        }
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return "float" + std::to_string(format.bits);
+            return (format.isUnsigned ? "uint" : "int") + std::to_string(format.bits);
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    std::string goQuote(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    void generateCodecMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "// UnmarshalJSON decodes m without reflection.\n"
+            << "func (m *" << className << ") UnmarshalJSON(data []byte) error {\n"
+            << indent1 << "l := jsonLexer{data: data}\n"
+            << indent1 << "m.decodeJSON(&l)\n"
+            << indent1 << "l.end()\n"
+            << indent1 << "return l.err\n"
+            << "}\n\n"
+            << "func (m *" << className << ") decodeJSON(l *jsonLexer) {\n"
+            << indent1 << "if l.isNull() {\n"
+            << indent2 << "return\n"
+            << indent1 << "}\n"
+            << indent1 << "l.delim('{')\n"
+            << indent1 << "for l.more('}') {\n"
+            // switch on string(bytes) compiles to a comparison without allocating the key
+            << indent2 << "switch string(l.readKey()) {\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << indent2 << "case " << goQuote(key) << ":\n";
+            generateDecode("m." + exportedName(key), fieldType(className, key, value, config), value, 3, outFile, config);
+        }
+        outFile << indent2 << "default:\n"
+            << indent3 << "l.skip()\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+
+        // The sample size is a good first guess for the output buffer
+        outFile << "// MarshalJSON encodes m without reflection.\n"
+            << "func (m " << className << ") MarshalJSON() ([]byte, error) {\n"
+            << indent1 << "return m.appendJSON(make([]byte, 0, " << data.dump().size() << ")), nil\n"
+            << "}\n\n"
+            << "func (m *" << className << ") appendJSON(buf []byte) []byte {\n";
+        if (data.empty()) {
+            outFile << indent1 << "buf = append(buf, '{')\n";
+        }
+        bool first = true;
+        for (auto& [key, value] : data.items()) {
+            outFile << indent1 << "buf = append(buf, " << goQuote((first ? "{" : ",") + json(key).dump() + ":") << "...)\n";
+            generateEncode("m." + exportedName(key), fieldType(className, key, value, config), value, 1, outFile, config);
+            first = false;
+        }
+        outFile << indent1 << "return append(buf, '}')\n"
+            << "}\n\n";
+    }
+
+    void generateDecode(const std::string& target, const std::string& type, const json& value, int level, std::ofstream& outFile, const Config& config) {
+        std::string pad(config.indentSize * level, ' ');
+        std::string indent(config.indentSize, ' ');
+        if (value.is_object()) {
+            outFile << pad << "if l.isNull() {\n"
+                << pad << indent << target << " = nil\n"
+                << pad << "} else {\n"
+                << pad << indent << "if " << target << " == nil {\n"
+                << pad << indent << indent << target << " = new(" << type.substr(1) << ")\n"
+                << pad << indent << "}\n"
+                << pad << indent << target << ".decodeJSON(l)\n"
+                << pad << "}\n";
+        }
+        else if (value.is_array()) {
+            // Decoding into a previously used value reuses its backing array, as encoding/json does
+            std::string slice = "s" + std::to_string(level);
+            std::string element = "v" + std::to_string(level);
+            std::string elementType = type.substr(2);
+            outFile << pad << "if l.isNull() {\n"
+                << pad << indent << target << " = nil\n"
+                << pad << "} else {\n"
+                << pad << indent << "l.delim('[')\n"
+                << pad << indent << slice << " := " << target << "[:0]\n"
+                << pad << indent << "if " << slice << " == nil {\n"
+                << pad << indent << indent << slice << " = make(" << type << ", 0, 8)\n"
+                << pad << indent << "}\n"
+                << pad << indent << "for l.more(']') {\n"
+                << pad << indent << indent << "var " << element << " " << elementType << "\n";
+            generateDecode(element, elementType, value.empty() ? json() : value[0], level + 2, outFile, config);
+            outFile << pad << indent << indent << slice << " = append(" << slice << ", " << element << ")\n"
+                << pad << indent << "}\n"
+                << pad << indent << target << " = " << slice << "\n"
+                << pad << "}\n";
+        }
+        else if (value.is_null()) {
+            outFile << pad << target << " = l.readInterface()\n";
+        }
+        else if (value.is_string() && (type == "UUID" || type == "time.Time" || type == "[]byte")) {
+            std::string reader = type == "UUID" ? "readUUID" : type == "time.Time" ? "readTime" : "readBase64";
+            outFile << pad << "if !l.isNull() {\n"
+                << pad << indent << target << " = l." << reader << "()\n"
+                << pad << "}\n";
+        }
+        else if (value.is_string() && type != "string") {
+            outFile << pad << "if !l.isNull() {\n"
+                << pad << indent << target << " = parse" << type << "(l.readStringBytes())\n"
+                << pad << "}\n";
+        }
+        else {
+            // Like encoding/json, null leaves a scalar field unchanged
+            std::string read = value.is_number() ? numberRead(type) : value.is_boolean() ? "l.readBool()" : "l.readString()";
+            outFile << pad << "if !l.isNull() {\n"
+                << pad << indent << target << " = " << read << "\n"
+                << pad << "}\n";
+        }
+    }
+
+    // Like encoding/json, a value that does not fit a narrowed field is an error rather than wrapped
+    std::string numberRead(const std::string& type) {
+        if (type == "float64") return "l.readFloat()";
+        if (type == "float32") return "l.readFloat32()";
+        if (type == "int") return "l.readInt()";
+        if (type == "int64") return "int64(l.readInt())";
+        if (type == "uint64") return "uint64(l.readIntIn(0, int(^uint(0)>>1)))";
+        bool isUnsigned = type[0] == 'u';
+        int bits = std::stoi(type.substr(isUnsigned ? 4 : 3));
+        std::string minimum = isUnsigned ? "0" : std::to_string(-(int64_t(1) << (bits - 1)));
+        std::string maximum = std::to_string((int64_t(1) << (isUnsigned ? bits : bits - 1)) - 1);
+        return type + "(l.readIntIn(" + minimum + ", " + maximum + "))";
+    }
+
+    void generateEncode(const std::string& source, const std::string& type, const json& value, int level, std::ofstream& outFile, const Config& config) {
+        std::string pad(config.indentSize * level, ' ');
+        std::string indent(config.indentSize, ' ');
+        if (value.is_object() || value.is_array()) {
+            outFile << pad << "if " << source << " == nil {\n"
+                << pad << indent << "buf = append(buf, \"null\"...)\n"
+                << pad << "} else {\n";
+            if (value.is_object()) {
+                outFile << pad << indent << "buf = " << source << ".appendJSON(buf)\n";
+            }
+            else {
+                std::string index = "i" + std::to_string(level);
+                std::string element = "v" + std::to_string(level);
+                outFile << pad << indent << "buf = append(buf, '[')\n"
+                    << pad << indent << "for " << index << ", " << element << " := range " << source << " {\n"
+                    << pad << indent << indent << "if " << index << " > 0 {\n"
+                    << pad << indent << indent << indent << "buf = append(buf, ',')\n"
+                    << pad << indent << indent << "}\n";
+                generateEncode(element, type.substr(2), value.empty() ? json() : value[0], level + 2, outFile, config);
+                outFile << pad << indent << "}\n"
+                    << pad << indent << "buf = append(buf, ']')\n";
+            }
+            outFile << pad << "}\n";
+        }
+        else if (value.is_boolean()) {
+            outFile << pad << "buf = strconv.AppendBool(buf, " << source << ")\n";
+        }
+        else if (value.is_number() && type.rfind("uint", 0) == 0) {
+            outFile << pad << "buf = strconv.AppendUint(buf, uint64(" << source << "), 10)\n";
+        }
+        else if (value.is_number() && type.rfind("float", 0) != 0) {
+            outFile << pad << "buf = strconv.AppendInt(buf, int64(" << source << "), 10)\n";
+        }
+        else if (value.is_number() && type == "float32") {
+            outFile << pad << "buf = strconv.AppendFloat(buf, float64(" << source << "), 'g', -1, 32)\n";
+        }
+        else if (value.is_number()) {
+            outFile << pad << "buf = strconv.AppendFloat(buf, " << source << ", 'g', -1, 64)\n";
+        }
+        else if (value.is_string() && type == "UUID") {
+            outFile << pad << "buf = append(" << source << ".appendText(append(buf, '\"')), '\"')\n";
+        }
+        else if (value.is_string() && type == "time.Time") {
+            outFile << pad << "buf = append(" << source << ".AppendFormat(append(buf, '\"'), time.RFC3339Nano), '\"')\n";
+        }
+        else if (value.is_string() && type == "[]byte") {
+            outFile << pad << "buf = appendJSONBase64(buf, " << source << ")\n";
+        }
+        else if (value.is_string()) {
+            outFile << pad << "buf = appendJSONString(buf, " << (type == "string" ? source : "string(" + source + ")") << ")\n";
+        }
+        else {
+            outFile << pad << "buf = appendJSONInterface(buf, " << source << ")\n";
+        }
+    }
+
+    void generateBenchmarks(const std::string& className, const json& sampleData, std::ostream& testFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string reflectType = "reflect" + className;
+        std::string sample = "benchmark" + className + "JSON";
+
+        testFile << "\n// The reflect types mirror the model structs without their methods, so encoding/json uses\n"
+            << "// reflection at every level. Union items have no such form and decode into maps.\n";
+        generateReflectionType(className, sampleData, testFile, config);
+        testFile << "\nvar " << sample << " = []byte(`" << sampleData.dump() << "`)\n";
+
+        const std::pair<std::string, std::string> decoders[] = {
+            { "Generated", "var obj model." + className + "\n" + indent2 + "if err := obj.UnmarshalJSON(" + sample + "); err != nil {\n" },
+            { "Reflection", "var obj " + reflectType + "\n" + indent2 + "if err := json.Unmarshal(" + sample + ", &obj); err != nil {\n" },
+        };
+        for (const auto& [name, body] : decoders) {
+            testFile << "\nfunc Benchmark" << className << "Unmarshal" << name << "(b *testing.B) {\n"
+                << indent1 << "b.ReportAllocs()\n"
+                << indent1 << "b.SetBytes(int64(len(" << sample << ")))\n"
+                << indent1 << "for i := 0; i < b.N; i++ {\n"
+                << indent2 << body
+                << indent2 << indent1 << "b.Fatal(err)\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n"
+                << "}\n";
+        }
+
+        struct Encoder { std::string name, type, call; };
+        const Encoder encoders[] = {
+            { "Generated", "model." + className, "obj.MarshalJSON()" },
+            { "Reflection", reflectType, "json.Marshal(&obj)" },
+        };
+        for (const auto& encoder : encoders) {
+            testFile << "\nfunc Benchmark" << className << "Marshal" << encoder.name << "(b *testing.B) {\n"
+                << indent1 << "var obj " << encoder.type << "\n"
+                << indent1 << "if err := json.Unmarshal(" << sample << ", &obj); err != nil {\n"
+                << indent2 << "b.Fatal(err)\n"
+                << indent1 << "}\n"
+                << indent1 << "b.ReportAllocs()\n"
+                << indent1 << "for i := 0; i < b.N; i++ {\n"
+                << indent2 << "if _, err := " << encoder.call << "; err != nil {\n"
+                << indent2 << indent1 << "b.Fatal(err)\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n"
+                << "}\n";
+        }
+    }
+
+    void generateReflectionType(const std::string& className, const json& data, std::ostream& testFile, const Config& config) {
+        testFile << "\ntype reflect" << className << " struct {\n";
+        for (auto& [key, value] : data.items()) {
+            testFile << std::string(config.indentSize, ' ') << exportedName(key) << " " << reflectionFieldType(className, key, value, config) << " `json:\"" << key << "\"`\n";
+        }
+        testFile << "}\n";
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            if (nested && !unions[className].count(key)) {
+                generateReflectionType(className + "_" + exportedName(key), *nested, testFile, config);
+            }
+        }
+    }
+
+    // The model field type, with nested structs replaced by their mirrors and model types qualified
+    std::string reflectionFieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        std::string type = fieldType(className, key, value, config);
+        std::string nested = "*" + className + "_" + exportedName(key);
+        reflectionUsesTime = reflectionUsesTime || type.find("time.Time") != std::string::npos;
+        if (objectSample(value)) {
+            return type.substr(0, type.size() - nested.size()) + (unions[className].count(key) ? "map[string]interface{}" : "*reflect" + nested.substr(1));
+        }
+        std::string named;
+        if (enumFields[className].count(key)) named = enumFields[className][key];
+        else if (stringFormats[className].count(key) && stringFormats[className][key].kind == StringFormat::Kind::UUID) named = "UUID";
+        return named.empty() ? type : type.substr(0, type.size() - named.size()) + "model." + named;
+    }
+
+    // UUID fields are kept as their 16 bytes; time.Time and []byte already have JSON forms in encoding/json
+    void generateFormatsRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "// Keeps \"time\" imported when no field is a date-time\n"
+            << "var _ = time.Time{}\n\n"
+            << "// UUID is a UUID in its 16-byte form. It is read and written as the usual hyphenated string.\n"
+            << "type UUID [16]byte\n\n"
+            << "// Offsets of the 16 hex digit pairs in the hyphenated form\n"
+            << "var uuidHexOffsets = [16]int{0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34}\n\n"
+            << "func uuidHexValue(c byte) byte {\n"
+            << indent1 << "switch {\n"
+            << indent1 << "case c >= '0' && c <= '9':\n"
+            << indent2 << "return c - '0'\n"
+            << indent1 << "case c >= 'a' && c <= 'f':\n"
+            << indent2 << "return c - 'a' + 10\n"
+            << indent1 << "case c >= 'A' && c <= 'F':\n"
+            << indent2 << "return c - 'A' + 10\n"
+            << indent1 << "}\n"
+            << indent1 << "return 0xff\n"
+            << "}\n\n"
+            << "func (u *UUID) UnmarshalText(text []byte) error {\n"
+            << indent1 << "if len(text) != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-' {\n"
+            << indent2 << "return errors.New(\"invalid UUID\")\n"
+            << indent1 << "}\n"
+            << indent1 << "for i, offset := range uuidHexOffsets {\n"
+            << indent2 << "high, low := uuidHexValue(text[offset]), uuidHexValue(text[offset+1])\n"
+            << indent2 << "if high > 15 || low > 15 {\n"
+            << indent3 << "return errors.New(\"invalid UUID\")\n"
+            << indent2 << "}\n"
+            << indent2 << "u[i] = high<<4 | low\n"
+            << indent1 << "}\n"
+            << indent1 << "return nil\n"
+            << "}\n\n"
+            << "func (u UUID) appendText(buf []byte) []byte {\n"
+            << indent1 << "const digits = \"0123456789abcdef\"\n"
+            << indent1 << "for i, b := range u {\n"
+            << indent2 << "if i == 4 || i == 6 || i == 8 || i == 10 {\n"
+            << indent3 << "buf = append(buf, '-')\n"
+            << indent2 << "}\n"
+            << indent2 << "buf = append(buf, digits[b>>4], digits[b&0xf])\n"
+            << indent1 << "}\n"
+            << indent1 << "return buf\n"
+            << "}\n\n"
+            << "func (u UUID) MarshalText() ([]byte, error) {\n"
+            << indent1 << "return u.appendText(make([]byte, 0, 36)), nil\n"
+            << "}\n\n"
+            << "func (u UUID) String() string {\n"
+            << indent1 << "return string(u.appendText(make([]byte, 0, 36)))\n"
+            << "}\n\n";
+    }
+
+    void generateCodecRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+
+        outFile << "// jsonLexer is the small tokenizer behind the generated MarshalJSON/UnmarshalJSON methods.\n"
+            << "// It works directly on the input bytes, so decoding needs no reflection and no intermediate maps.\n"
+            << "type jsonLexer struct {\n"
+            << indent1 << "data []byte\n"
+            << indent1 << "pos  int\n"
+            << indent1 << "err  error\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) fail(msg string) {\n"
+            << indent1 << "if l.err == nil {\n"
+            << indent2 << "l.err = fmt.Errorf(\"json: %s at offset %d\", msg, l.pos)\n"
+            << indent1 << "}\n"
+            << indent1 << "l.pos = len(l.data)\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) peek() byte {\n"
+            << indent1 << "for l.pos < len(l.data) {\n"
+            << indent2 << "switch l.data[l.pos] {\n"
+            << indent2 << "case ' ', '\\t', '\\n', '\\r':\n"
+            << indent3 << "l.pos++\n"
+            << indent2 << "default:\n"
+            << indent3 << "return l.data[l.pos]\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << indent1 << "return 0\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) delim(c byte) {\n"
+            << indent1 << "if l.peek() != c {\n"
+            << indent2 << "l.fail(\"expected '\" + string(c) + \"'\")\n"
+            << indent2 << "return\n"
+            << indent1 << "}\n"
+            << indent1 << "l.pos++\n"
+            << "}\n\n"
+            << "// more reports whether another element follows in the container closed by c.\n"
+            << "func (l *jsonLexer) more(c byte) bool {\n"
+            << indent1 << "switch l.peek() {\n"
+            << indent1 << "case c:\n"
+            << indent2 << "l.pos++\n"
+            << indent2 << "return false\n"
+            << indent1 << "case ',':\n"
+            << indent2 << "l.pos++\n"
+            << indent1 << "case 0:\n"
+            << indent2 << "l.fail(\"unexpected end of input\")\n"
+            << indent1 << "}\n"
+            << indent1 << "return l.err == nil\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) end() {\n"
+            << indent1 << "if l.peek() != 0 {\n"
+            << indent2 << "l.fail(\"unexpected data after top-level value\")\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) literal(word string) {\n"
+            << indent1 << "if len(l.data)-l.pos < len(word) || string(l.data[l.pos:l.pos+len(word)]) != word {\n"
+            << indent2 << "l.fail(\"invalid literal\")\n"
+            << indent2 << "return\n"
+            << indent1 << "}\n"
+            << indent1 << "l.pos += len(word)\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) isNull() bool {\n"
+            << indent1 << "if l.peek() == 'n' {\n"
+            << indent2 << "l.literal(\"null\")\n"
+            << indent2 << "return true\n"
+            << indent1 << "}\n"
+            << indent1 << "return false\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readBool() bool {\n"
+            << indent1 << "switch l.peek() {\n"
+            << indent1 << "case 't':\n"
+            << indent2 << "l.literal(\"true\")\n"
+            << indent2 << "return true\n"
+            << indent1 << "case 'f':\n"
+            << indent2 << "l.literal(\"false\")\n"
+            << indent2 << "return false\n"
+            << indent1 << "}\n"
+            << indent1 << "l.fail(\"expected boolean\")\n"
+            << indent1 << "return false\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) numberBytes() []byte {\n"
+            << indent1 << "l.peek()\n"
+            << indent1 << "start := l.pos\n"
+            << indent1 << "for l.pos < len(l.data) {\n"
+            << indent2 << "c := l.data[l.pos]\n"
+            << indent2 << "if (c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E' {\n"
+            << indent3 << "break\n"
+            << indent2 << "}\n"
+            << indent2 << "l.pos++\n"
+            << indent1 << "}\n"
+            << indent1 << "if start == l.pos {\n"
+            << indent2 << "l.fail(\"expected number\")\n"
+            << indent1 << "}\n"
+            << indent1 << "return l.data[start:l.pos]\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readInt() int {\n"
+            << indent1 << "b := l.numberBytes()\n"
+            << indent1 << "negative := len(b) > 0 && b[0] == '-'\n"
+            << indent1 << "if negative {\n"
+            << indent2 << "b = b[1:]\n"
+            << indent1 << "}\n"
+            << indent1 << "if len(b) == 0 {\n"
+            << indent2 << "l.fail(\"expected integer\")\n"
+            << indent2 << "return 0\n"
+            << indent1 << "}\n"
+            << indent1 << "const maxInt = int(^uint(0) >> 1)\n"
+            << indent1 << "n := 0\n"
+            << indent1 << "for _, c := range b {\n"
+            << indent2 << "if c < '0' || c > '9' {\n"
+            << indent3 << "l.fail(\"expected integer\")\n"
+            << indent3 << "return 0\n"
+            << indent2 << "}\n"
+            << indent2 << "d := int(c - '0')\n"
+            << indent2 << "if n > (maxInt-d)/10 {\n"
+            << indent3 << "l.fail(\"integer overflow\")\n"
+            << indent3 << "return 0\n"
+            << indent2 << "}\n"
+            << indent2 << "n = n*10 + d\n"
+            << indent1 << "}\n"
+            << indent1 << "if negative {\n"
+            << indent2 << "return -n\n"
+            << indent1 << "}\n"
+            << indent1 << "return n\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readIntIn(min, max int) int {\n"
+            << indent1 << "n := l.readInt()\n"
+            << indent1 << "if n < min || n > max {\n"
+            << indent2 << "l.fail(\"integer out of range\")\n"
+            << indent1 << "}\n"
+            << indent1 << "return n\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readFloat() float64 {\n"
+            << indent1 << "f, err := strconv.ParseFloat(string(l.numberBytes()), 64)\n"
+            << indent1 << "if err != nil {\n"
+            << indent2 << "l.fail(\"invalid number\")\n"
+            << indent1 << "}\n"
+            << indent1 << "return f\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readFloat32() float32 {\n"
+            << indent1 << "f, err := strconv.ParseFloat(string(l.numberBytes()), 32)\n"
+            << indent1 << "if err != nil {\n"
+            << indent2 << "l.fail(\"invalid number\")\n"
+            << indent1 << "}\n"
+            << indent1 << "return float32(f)\n"
+            << "}\n\n"
+            << "// readStringBytes returns the contents of the next string. The result aliases the input\n"
+            << "// unless the string contains escape sequences.\n"
+            << "func (l *jsonLexer) readStringBytes() []byte {\n"
+            << indent1 << "if l.peek() != '\"' {\n"
+            << indent2 << "l.fail(\"expected string\")\n"
+            << indent2 << "return nil\n"
+            << indent1 << "}\n"
+            << indent1 << "l.pos++\n"
+            << indent1 << "start := l.pos\n"
+            << indent1 << "for l.pos < len(l.data) {\n"
+            << indent2 << "switch c := l.data[l.pos]; {\n"
+            << indent2 << "case c == '\"':\n"
+            << indent3 << "l.pos++\n"
+            << indent3 << "return l.data[start : l.pos-1]\n"
+            << indent2 << "case c == '\\\\':\n"
+            << indent3 << "return l.unescape(start)\n"
+            << indent2 << "case c < 0x20:\n"
+            << indent3 << "l.fail(\"control character in string\")\n"
+            << indent3 << "return nil\n"
+            << indent2 << "}\n"
+            << indent2 << "l.pos++\n"
+            << indent1 << "}\n"
+            << indent1 << "l.fail(\"unterminated string\")\n"
+            << indent1 << "return nil\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) unescape(start int) []byte {\n"
+            << indent1 << "out := append([]byte(nil), l.data[start:l.pos]...)\n"
+            << indent1 << "for l.pos < len(l.data) {\n"
+            << indent2 << "c := l.data[l.pos]\n"
+            << indent2 << "if c == '\"' {\n"
+            << indent3 << "l.pos++\n"
+            << indent3 << "return out\n"
+            << indent2 << "}\n"
+            << indent2 << "if c != '\\\\' {\n"
+            << indent3 << "out = append(out, c)\n"
+            << indent3 << "l.pos++\n"
+            << indent3 << "continue\n"
+            << indent2 << "}\n"
+            << indent2 << "if l.pos+1 >= len(l.data) {\n"
+            << indent3 << "break\n"
+            << indent2 << "}\n"
+            << indent2 << "escaped := l.data[l.pos+1]\n"
+            << indent2 << "l.pos += 2\n"
+            << indent2 << "switch escaped {\n"
+            << indent2 << "case '\"', '\\\\', '/':\n"
+            << indent3 << "out = append(out, escaped)\n"
+            << indent2 << "case 'b':\n"
+            << indent3 << "out = append(out, '\\b')\n"
+            << indent2 << "case 'f':\n"
+            << indent3 << "out = append(out, '\\f')\n"
+            << indent2 << "case 'n':\n"
+            << indent3 << "out = append(out, '\\n')\n"
+            << indent2 << "case 'r':\n"
+            << indent3 << "out = append(out, '\\r')\n"
+            << indent2 << "case 't':\n"
+            << indent3 << "out = append(out, '\\t')\n"
+            << indent2 << "case 'u':\n"
+            << indent3 << "r := l.hex4()\n"
+            << indent3 << "if utf16.IsSurrogate(r) && l.pos+1 < len(l.data) && l.data[l.pos] == '\\\\' && l.data[l.pos+1] == 'u' {\n"
+            << indent4 << "l.pos += 2\n"
+            << indent4 << "r = utf16.DecodeRune(r, l.hex4())\n"
+            << indent3 << "}\n"
+            << indent3 << "out = utf8.AppendRune(out, r)\n"
+            << indent2 << "default:\n"
+            << indent3 << "l.fail(\"invalid escape sequence\")\n"
+            << indent3 << "return nil\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << indent1 << "l.fail(\"unterminated string\")\n"
+            << indent1 << "return nil\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) hex4() rune {\n"
+            << indent1 << "if len(l.data)-l.pos < 4 {\n"
+            << indent2 << "l.fail(\"invalid unicode escape\")\n"
+            << indent2 << "return utf8.RuneError\n"
+            << indent1 << "}\n"
+            << indent1 << "var r rune\n"
+            << indent1 << "for _, c := range l.data[l.pos : l.pos+4] {\n"
+            << indent2 << "r <<= 4\n"
+            << indent2 << "switch {\n"
+            << indent2 << "case c >= '0' && c <= '9':\n"
+            << indent3 << "r |= rune(c - '0')\n"
+            << indent2 << "case c >= 'a' && c <= 'f':\n"
+            << indent3 << "r |= rune(c - 'a' + 10)\n"
+            << indent2 << "case c >= 'A' && c <= 'F':\n"
+            << indent3 << "r |= rune(c - 'A' + 10)\n"
+            << indent2 << "default:\n"
+            << indent3 << "l.fail(\"invalid unicode escape\")\n"
+            << indent3 << "return utf8.RuneError\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << indent1 << "l.pos += 4\n"
+            << indent1 << "return r\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readString() string {\n"
+            << indent1 << "return string(l.readStringBytes())\n"
+            << "}\n\n"
+            << "// readKey reads an object key and the colon after it.\n"
+            << "func (l *jsonLexer) readKey() []byte {\n"
+            << indent1 << "key := l.readStringBytes()\n"
+            << indent1 << "l.delim(':')\n"
+            << indent1 << "return key\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) skip() {\n"
+            << indent1 << "switch l.peek() {\n"
+            << indent1 << "case '\"':\n"
+            << indent2 << "l.readStringBytes()\n"
+            << indent1 << "case '{', '[':\n"
+            << indent2 << "closing := byte('}')\n"
+            << indent2 << "if l.data[l.pos] == '[' {\n"
+            << indent3 << "closing = ']'\n"
+            << indent2 << "}\n"
+            << indent2 << "l.pos++\n"
+            << indent2 << "for l.more(closing) {\n"
+            << indent3 << "if closing == '}' {\n"
+            << indent4 << "l.readKey()\n"
+            << indent3 << "}\n"
+            << indent3 << "l.skip()\n"
+            << indent2 << "}\n"
+            << indent1 << "case 't', 'f':\n"
+            << indent2 << "l.readBool()\n"
+            << indent1 << "case 'n':\n"
+            << indent2 << "l.literal(\"null\")\n"
+            << indent1 << "default:\n"
+            << indent2 << "l.numberBytes()\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "func (l *jsonLexer) readInterface() interface{} {\n"
+            << indent1 << "switch l.peek() {\n"
+            << indent1 << "case '\"':\n"
+            << indent2 << "return l.readString()\n"
+            << indent1 << "case '{':\n"
+            << indent2 << "l.pos++\n"
+            << indent2 << "m := map[string]interface{}{}\n"
+            << indent2 << "for l.more('}') {\n"
+            << indent3 << "key := string(l.readKey())\n"
+            << indent3 << "m[key] = l.readInterface()\n"
+            << indent2 << "}\n"
+            << indent2 << "return m\n"
+            << indent1 << "case '[':\n"
+            << indent2 << "l.pos++\n"
+            << indent2 << "s := []interface{}{}\n"
+            << indent2 << "for l.more(']') {\n"
+            << indent3 << "s = append(s, l.readInterface())\n"
+            << indent2 << "}\n"
+            << indent2 << "return s\n"
+            << indent1 << "case 't', 'f':\n"
+            << indent2 << "return l.readBool()\n"
+            << indent1 << "case 'n':\n"
+            << indent2 << "l.literal(\"null\")\n"
+            << indent2 << "return nil\n"
+            << indent1 << "}\n"
+            << indent1 << "return l.readFloat()\n"
+            << "}\n\n"
+            << "const jsonHexDigits = \"0123456789abcdef\"\n\n"
+            << "func appendJSONString(buf []byte, s string) []byte {\n"
+            << indent1 << "buf = append(buf, '\"')\n"
+            << indent1 << "start := 0\n"
+            << indent1 << "for i := 0; i < len(s); i++ {\n"
+            << indent2 << "c := s[i]\n"
+            << indent2 << "if c >= 0x20 && c != '\"' && c != '\\\\' {\n"
+            << indent3 << "continue\n"
+            << indent2 << "}\n"
+            << indent2 << "buf = append(buf, s[start:i]...)\n"
+            << indent2 << "switch c {\n"
+            << indent2 << "case '\"', '\\\\':\n"
+            << indent3 << "buf = append(buf, '\\\\', c)\n"
+            << indent2 << "case '\\n':\n"
+            << indent3 << "buf = append(buf, '\\\\', 'n')\n"
+            << indent2 << "case '\\r':\n"
+            << indent3 << "buf = append(buf, '\\\\', 'r')\n"
+            << indent2 << "case '\\t':\n"
+            << indent3 << "buf = append(buf, '\\\\', 't')\n"
+            << indent2 << "default:\n"
+            << indent3 << "buf = append(buf, '\\\\', 'u', '0', '0', jsonHexDigits[c>>4], jsonHexDigits[c&0xf])\n"
+            << indent2 << "}\n"
+            << indent2 << "start = i + 1\n"
+            << indent1 << "}\n"
+            << indent1 << "buf = append(buf, s[start:]...)\n"
+            << indent1 << "return append(buf, '\"')\n"
+            << "}\n\n"
+            << "func appendJSONInterface(buf []byte, v interface{}) []byte {\n"
+            << indent1 << "switch x := v.(type) {\n"
+            << indent1 << "case nil:\n"
+            << indent2 << "return append(buf, \"null\"...)\n"
+            << indent1 << "case string:\n"
+            << indent2 << "return appendJSONString(buf, x)\n"
+            << indent1 << "case bool:\n"
+            << indent2 << "return strconv.AppendBool(buf, x)\n"
+            << indent1 << "case float64:\n"
+            << indent2 << "return strconv.AppendFloat(buf, x, 'g', -1, 64)\n"
+            << indent1 << "case []interface{}:\n"
+            << indent2 << "buf = append(buf, '[')\n"
+            << indent2 << "for i, element := range x {\n"
+            << indent3 << "if i > 0 {\n"
+            << indent4 << "buf = append(buf, ',')\n"
+            << indent3 << "}\n"
+            << indent3 << "buf = appendJSONInterface(buf, element)\n"
+            << indent2 << "}\n"
+            << indent2 << "return append(buf, ']')\n"
+            << indent1 << "case map[string]interface{}:\n"
+            << indent2 << "keys := make([]string, 0, len(x))\n"
+            << indent2 << "for key := range x {\n"
+            << indent3 << "keys = append(keys, key)\n"
+            << indent2 << "}\n"
+            << indent2 << "sort.Strings(keys)\n"
+            << indent2 << "buf = append(buf, '{')\n"
+            << indent2 << "for i, key := range keys {\n"
+            << indent3 << "if i > 0 {\n"
+            << indent4 << "buf = append(buf, ',')\n"
+            << indent3 << "}\n"
+            << indent3 << "buf = appendJSONString(buf, key)\n"
+            << indent3 << "buf = append(buf, ':')\n"
+            << indent3 << "buf = appendJSONInterface(buf, x[key])\n"
+            << indent2 << "}\n"
+            << indent2 << "return append(buf, '}')\n"
+            << indent1 << "}\n"
+            << indent1 << "// Values that did not come from JSON decoding fall back to encoding/json\n"
+            << indent1 << "encoded, _ := json.Marshal(v)\n"
+            << indent1 << "return append(buf, encoded...)\n"
+            << "}\n";
+        if (config.stringFormats) {
+            outFile << "\nfunc (l *jsonLexer) readUUID() (u UUID) {\n"
+                << indent1 << "if err := u.UnmarshalText(l.readStringBytes()); err != nil {\n"
+                << indent2 << "l.fail(err.Error())\n"
+                << indent1 << "}\n"
+                << indent1 << "return u\n"
+                << "}\n\n"
+                << "func (l *jsonLexer) readTime() time.Time {\n"
+                << indent1 << "t, err := time.Parse(time.RFC3339Nano, l.readString())\n"
+                << indent1 << "if err != nil {\n"
+                << indent2 << "l.fail(\"invalid date-time\")\n"
+                << indent1 << "}\n"
+                << indent1 << "return t\n"
+                << "}\n\n"
+                << "func (l *jsonLexer) readBase64() []byte {\n"
+                << indent1 << "src := l.readStringBytes()\n"
+                << indent1 << "dst := make([]byte, base64.StdEncoding.DecodedLen(len(src)))\n"
+                << indent1 << "n, err := base64.StdEncoding.Decode(dst, src)\n"
+                << indent1 << "if err != nil {\n"
+                << indent2 << "l.fail(\"invalid base64\")\n"
+                << indent1 << "}\n"
+                << indent1 << "return dst[:n]\n"
+                << "}\n\n"
+                << "// appendJSONBase64 encodes straight into buf; like encoding/json, a nil slice is null.\n"
+                << "func appendJSONBase64(buf, src []byte) []byte {\n"
+                << indent1 << "if src == nil {\n"
+                << indent2 << "return append(buf, \"null\"...)\n"
+                << indent1 << "}\n"
+                << indent1 << "start := len(buf) + 1\n"
+                << indent1 << "buf = append(buf, make([]byte, base64.StdEncoding.EncodedLen(len(src))+2)...)\n"
+                << indent1 << "buf[start-1] = '\"'\n"
+                << indent1 << "base64.StdEncoding.Encode(buf[start:], src)\n"
+                << indent1 << "buf[len(buf)-1] = '\"'\n"
+                << indent1 << "return buf\n"
+                << "}\n";
+        }
+
+    }
+
+    // Patterns are compiled once into package-level variables; every other keyword is a plain comparison
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string patternPrefix = static_cast<char>(std::tolower(static_cast<unsigned char>(className[0]))) + className.substr(1);
+
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << "var " << patternPrefix << exportedName(key) << "Pattern = regexp.MustCompile(" << goQuote(*constraints.pattern) << ")\n\n";
+            }
+        }
+
+        outFile << "func (m *" << className << ") IsValid() bool {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent1 << "if " << violation << " {\n"
+                << indent2 << "return false\n"
+                << indent1 << "}\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "m." + exportedName(key);
+            // A formatted field was checked by its parser when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            // Enum types accept any string when decoded, like every named string type
+            if (enumFields[className].count(key)) check("!" + field + ".IsValid()");
+            if (value.is_string()) {
+                if (constraints.minLength) check("utf8.RuneCountInString(" + field + ") < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check("utf8.RuneCountInString(" + field + ") > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check("!" + patternPrefix + exportedName(key) + "Pattern.MatchString(" + field + ")");
+            }
+            if (value.is_number()) {
+                // Bounds the narrowed field type already keeps, such as a minimum of 0 on a uint8, are left out
+                const NumberFormat& format = numberFormats[className][key];
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + field + " != " + (candidate.is_string() ? goQuote(candidate.get<std::string>()) : candidate.dump());
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.required) check(field + " == nil");
+                if (constraints.minItems) check("len(" + field + ") < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check("len(" + field + ") > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent1 << "for _, item := range " << field << " {\n"
+                        << indent2 << "if item != nil && !item.IsValid() {\n"
+                        << indent2 << indent1 << "return false\n"
+                        << indent2 << "}\n"
+                        << indent1 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                if (constraints.required) check(field + " == nil");
+                check(field + " != nil && !" + field + ".IsValid()");
+            }
+        }
+        outFile << indent1 << "return true\n"
+            << "}\n\n";
+    }
 };
\ No newline at end of file
@@ -1,112 +1,847 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-
-class JavaGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "import java.util.List;\n"
-            << "import com.fasterxml.jackson.annotation.JsonProperty;\n"
-            << "import com.fasterxml.jackson.databind.ObjectMapper;\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "public enum " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << value << ",\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "public class " << className << " {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/**\n"
-                    << std::string(config.indentSize, ' ') << " * " << schema["properties"][key]["description"] << "\n"
-                    << std::string(config.indentSize, ' ') << " */\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << "@JsonProperty(\"" << key << "\")\n"
-                << std::string(config.indentSize, ' ') << "private " << type << " " << key << ";\n\n";
-
-            if (type == "class") {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        generateGettersAndSetters(data, outFile, config);
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-
-        outFile << "}\n\n";
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import org.junit.jupiter.api.Test;\n"
-            << "import static org.junit.jupiter.api.Assertions.*;\n"
-            << "import com.fasterxml.jackson.databind.ObjectMapper;\n\n"
-            << "public class " << className << "Test {\n"
-            << std::string(config.indentSize, ' ') << "@Test\n"
-            << std::string(config.indentSize, ' ') << "public void testSerializationDeserialization() throws Exception {\n"
-            << std::string(config.indentSize * 2, ' ') << "String sampleJson = " << sampleData.dump() << ";\n"
-            << std::string(config.indentSize * 2, ' ') << "ObjectMapper objectMapper = new ObjectMapper();\n"
-            << std::string(config.indentSize * 2, ' ') << className << " obj = objectMapper.readValue(sampleJson, " << className << ".class);\n"
-            << std::string(config.indentSize * 2, ' ') << "String serialized = objectMapper.writeValueAsString(obj);\n"
-            << std::string(config.indentSize * 2, ' ') << "assertEquals(sampleJson, serialized);\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Object";
-        if (value.is_boolean()) return "boolean";
-        if (value.is_number_integer()) return "int";
-        if (value.is_number_float()) return "double";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List<" + toLanguageType(value[0], config) + ">";
-            }
-            return "List<Object>";
-        }
-        if (value.is_object()) return "class";
-        return "Object";
-    }
-
-private:
-    void generateGettersAndSetters(const json& data, std::ofstream& outFile, const Config& config) {
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            std::string capitalizedKey = key;
-            capitalizedKey[0] = std::toupper(capitalizedKey[0]);
-
-            outFile << std::string(config.indentSize, ' ') << "public " << type << " get" << capitalizedKey << "() {\n"
-                << std::string(config.indentSize * 2, ' ') << "return " << key << ";\n"
-                << std::string(config.indentSize, ' ') << "}\n\n"
-                << std::string(config.indentSize, ' ') << "public void set" << capitalizedKey << "(" << type << " " << key << ") {\n"
-                << std::string(config.indentSize * 2, ' ') << "this." << key << " = " << key << ";\n"
-                << std::string(config.indentSize, ' ') << "}\n\n";
-        }
-    }
-
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << std::string(config.indentSize, ' ') << "public boolean isValid() {\n"
-            << std::string(config.indentSize * 2, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize * 2, ' ') << "return true;\n"
-            << std::string(config.indentSize, ' ') << "}\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+
+class JavaGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        typedArrays = config.typedArrays;
+        outFile << "import java.util.List;\n"
+            << "import com.fasterxml.jackson.annotation.JsonProperty;\n"
+            << "import com.fasterxml.jackson.databind.ObjectMapper;\n";
+        if (config.generateValidation) {
+            outFile << "import java.util.regex.Pattern;\n";
+        }
+        if (config.taggedUnions) {
+            outFile << "import com.fasterxml.jackson.annotation.JsonSubTypes;\n"
+                << "import com.fasterxml.jackson.annotation.JsonTypeInfo;\n";
+            if (config.staticCodecs) {
+                outFile << "import com.fasterxml.jackson.databind.util.TokenBuffer;\n";
+            }
+        }
+        if (config.stringFormats) {
+            outFile << "import java.time.Instant;\n"
+                << "import java.time.OffsetDateTime;\n"
+                << "import java.time.format.DateTimeParseException;\n"
+                << "import java.util.UUID;\n"
+                << "import com.fasterxml.jackson.databind.DeserializationContext;\n"
+                << "import com.fasterxml.jackson.databind.SerializerProvider;\n"
+                << "import com.fasterxml.jackson.databind.annotation.JsonDeserialize;\n"
+                << "import com.fasterxml.jackson.databind.annotation.JsonSerialize;\n"
+                << "import com.fasterxml.jackson.databind.deser.std.StdDeserializer;\n"
+                << "import com.fasterxml.jackson.databind.ser.std.StdSerializer;\n";
+            if (!config.staticCodecs) {
+                outFile << "import java.io.IOException;\n"
+                    << "import com.fasterxml.jackson.core.JsonGenerator;\n"
+                    << "import com.fasterxml.jackson.core.JsonParseException;\n"
+                    << "import com.fasterxml.jackson.core.JsonParser;\n";
+            }
+        }
+        if (config.staticCodecs) {
+            outFile << "import java.io.IOException;\n"
+                << "import java.math.BigDecimal;\n"
+                << "import java.math.BigInteger;\n"
+                << "import java.util.ArrayList;\n";
+            if (typedArrays) {
+                outFile << "import java.util.Arrays;\n";
+            }
+            outFile << "import java.util.LinkedHashMap;\n"
+                << "import java.util.Map;\n"
+                << "import com.fasterxml.jackson.core.JsonGenerator;\n"
+                << "import com.fasterxml.jackson.core.JsonParseException;\n"
+                << "import com.fasterxml.jackson.core.JsonParser;\n"
+                << "import com.fasterxml.jackson.core.JsonToken;\n"
+                << "import com.fasterxml.jackson.core.io.SerializedString;\n";
+        }
+        outFile << "\n";
+        if (config.stringFormats) {
+            generateFormatSupport(outFile, config);
+        }
+        if (config.staticCodecs) {
+            generateStreamingSupport(outFile, config);
+        }
+    }
+
+    // fromValue is a string switch, which javac compiles to a hash lookup followed by one equals call
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::UPPER_SNAKE);
+            outFile << "public enum " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent1 << "@JsonProperty(" << javaString(definition.values[i]) << ")\n"
+                    << indent1 << cases[i] << "(" << javaString(definition.values[i]) << ")" << (i + 1 < cases.size() ? ",\n" : ";\n\n");
+            }
+            outFile << indent1 << "private final String value;\n\n"
+                << indent1 << name << "(String value) {\n"
+                << indent2 << "this.value = value;\n"
+                << indent1 << "}\n\n"
+                << indent1 << "public String value() {\n"
+                << indent2 << "return value;\n"
+                << indent1 << "}\n\n"
+                << indent1 << "public static " << name << " fromValue(String value) {\n"
+                << indent2 << "switch (value) {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent3 << "case " << javaString(definition.values[i]) << ": return " << cases[i] << ";\n";
+            }
+            outFile << indent3 << "default: throw new IllegalArgumentException(\"Invalid " << name << ": \" + value);\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n"
+                << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        // Nested classes are static so databind and the static readers can instantiate them
+        outFile << (depth > 0 ? "public static class " : "public class ") << className
+            << (variantOf.count(className) ? " extends " + variantOf[className] : "") << " {\n";
+        ++depth;
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, false);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "/**\n"
+                    << std::string(config.indentSize, ' ') << " * " << schema["properties"][key]["description"] << "\n"
+                    << std::string(config.indentSize, ' ') << " */\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << "@JsonProperty(\"" << key << "\")\n";
+            if (type == "Instant") {
+                outFile << std::string(config.indentSize, ' ') << "@JsonSerialize(using = JsonFormats.InstantSerializer.class)\n"
+                    << std::string(config.indentSize, ' ') << "@JsonDeserialize(using = JsonFormats.InstantDeserializer.class)\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << "private " << type << " " << key << ";\n\n";
+
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                // Variants are siblings of the union class, which names them in its annotations
+                for (const auto& variant : tagged->variants) {
+                    variantOf[newClassName + "_" + variant.name] = newClassName;
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+
+        generateGettersAndSetters(className, data, outFile, config);
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        if (config.staticCodecs) {
+            generateStreamingMethods(className, data, outFile, config);
+        }
+
+        --depth;
+        outFile << "}\n\n";
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "import org.junit.jupiter.api.Test;\n"
+            << "import static org.junit.jupiter.api.Assertions.*;\n"
+            << "import com.fasterxml.jackson.databind.ObjectMapper;\n";
+        if (config.staticCodecs) {
+            testFile << "import java.io.StringWriter;\n"
+                << "import com.fasterxml.jackson.core.JsonFactory;\n"
+                << "import com.fasterxml.jackson.core.JsonGenerator;\n"
+                << "import com.fasterxml.jackson.core.JsonParser;\n";
+        }
+        testFile << "\n"
+            << "public class " << className << "Test {\n"
+            << std::string(config.indentSize, ' ') << "@Test\n"
+            << std::string(config.indentSize, ' ') << "public void testSerializationDeserialization() throws Exception {\n"
+            << std::string(config.indentSize * 2, ' ') << "String sampleJson = " << javaString(sampleData.dump()) << ";\n"
+            << std::string(config.indentSize * 2, ' ') << "ObjectMapper objectMapper = new ObjectMapper();\n"
+            << std::string(config.indentSize * 2, ' ') << className << " obj = objectMapper.readValue(sampleJson, " << className << ".class);\n"
+            << std::string(config.indentSize * 2, ' ') << "String serialized = objectMapper.writeValueAsString(obj);\n";
+        if (config.stringFormats) {
+            // Date-times are written back in UTC, so the output is compared with its own round trip
+            testFile << std::string(config.indentSize * 2, ' ') << "assertEquals(serialized, objectMapper.writeValueAsString(objectMapper.readValue(serialized, " << className << ".class)));\n";
+        }
+        else {
+            testFile << std::string(config.indentSize * 2, ' ') << "assertEquals(sampleJson, serialized);\n";
+        }
+        testFile << std::string(config.indentSize, ' ') << "}\n";
+        if (config.staticCodecs) {
+            testFile << "\n"
+                << std::string(config.indentSize, ' ') << "@Test\n"
+                << std::string(config.indentSize, ' ') << "public void testStreamingRoundTrip() throws Exception {\n"
+                << std::string(config.indentSize * 2, ' ') << "String sampleJson = " << javaString(sampleData.dump()) << ";\n"
+                << std::string(config.indentSize * 2, ' ') << "JsonFactory factory = new JsonFactory();\n"
+                << std::string(config.indentSize * 2, ' ') << className << " obj;\n"
+                << std::string(config.indentSize * 2, ' ') << "try (JsonParser parser = factory.createParser(sampleJson)) {\n"
+                << std::string(config.indentSize * 3, ' ') << "obj = " << className << ".read(parser);\n"
+                << std::string(config.indentSize * 2, ' ') << "}\n"
+                << std::string(config.indentSize * 2, ' ') << "StringWriter writer = new StringWriter();\n"
+                << std::string(config.indentSize * 2, ' ') << "try (JsonGenerator generator = factory.createGenerator(writer)) {\n"
+                << std::string(config.indentSize * 3, ' ') << "obj.write(generator);\n"
+                << std::string(config.indentSize * 2, ' ') << "}\n"
+                << std::string(config.indentSize * 2, ' ') << "ObjectMapper objectMapper = new ObjectMapper();\n"
+                << std::string(config.indentSize * 2, ' ') << "assertEquals(objectMapper.readTree(" << (config.stringFormats ? "objectMapper.writeValueAsString(obj)" : "sampleJson") << "), objectMapper.readTree(writer.toString()));\n"
+                << std::string(config.indentSize, ' ') << "}\n";
+            generateBenchmark(className, sampleData, config);
+        }
+        testFile << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Object";
+        if (value.is_boolean()) return "boolean";
+        if (value.is_number_integer()) return "long";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List<" + toLanguageType(value[0], config) + ">";
+            }
+            return "List<Object>";
+        }
+        if (value.is_object()) return "class";
+        return "Object";
+    }
+
+private:
+    int depth = 0;
+    bool typedArrays = false;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    // Union class that each variant class extends
+    std::map<std::string, std::string> variantOf;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // Databind picks the subclass from the tag, which stays an ordinary property of every variant.
+    // The static reader buffers the object once, so the tag may come anywhere in it, and replays
+    // the tokens into the variant's reader
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string tag = javaString(tagged.property);
+
+        outFile << "@JsonTypeInfo(use = JsonTypeInfo.Id.NAME, include = JsonTypeInfo.As.EXISTING_PROPERTY, property = " << tag << ", visible = true)\n"
+            << "@JsonSubTypes({\n";
+        for (size_t i = 0; i < tagged.variants.size(); ++i) {
+            outFile << indent1 << "@JsonSubTypes.Type(value = " << className << "_" << tagged.variants[i].name << ".class, name = " << javaString(tagged.variants[i].tag) << ")"
+                << (i + 1 < tagged.variants.size() ? ",\n" : "\n");
+        }
+        outFile << "})\n"
+            << "public static abstract class " << className << " {\n";
+        if (config.generateValidation) {
+            outFile << indent1 << "public abstract boolean isValid();\n";
+        }
+        if (config.staticCodecs) {
+            outFile << (config.generateValidation ? "\n" : "")
+                << indent1 << "public abstract void write(JsonGenerator generator) throws IOException;\n\n"
+                << indent1 << "public static " << className << " read(JsonParser parser) throws IOException {\n"
+                << indent2 << "JsonToken token = parser.currentToken() == null ? parser.nextToken() : parser.currentToken();\n"
+                << indent2 << "if (token == JsonToken.VALUE_NULL) {\n"
+                << indent3 << "return null;\n"
+                << indent2 << "}\n"
+                << indent2 << "if (token != JsonToken.START_OBJECT) {\n"
+                << indent3 << "throw new JsonParseException(parser, \"Expected an object for " << className << "\");\n"
+                << indent2 << "}\n"
+                << indent2 << "TokenBuffer buffer = new TokenBuffer(parser);\n"
+                << indent2 << "buffer.copyCurrentStructure(parser);\n"
+                << indent2 << "String tag = null;\n"
+                << indent2 << "try (JsonParser scan = buffer.asParser()) {\n"
+                << indent3 << "scan.nextToken();\n"
+                << indent3 << "String field;\n"
+                << indent3 << "while (tag == null && (field = scan.nextFieldName()) != null) {\n"
+                << indent4 << "scan.nextToken();\n"
+                << indent4 << "if (field.equals(" << tag << ")) {\n"
+                << indent4 << indent1 << "tag = scan.getValueAsString();\n"
+                << indent4 << "}\n"
+                << indent4 << "scan.skipChildren();\n"
+                << indent3 << "}\n"
+                << indent2 << "}\n"
+                << indent2 << "JsonParser replay = buffer.asParser();\n"
+                << indent2 << "replay.nextToken();\n"
+                << indent2 << "switch (tag == null ? \"\" : tag) {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent3 << "case " << javaString(variant.tag) << ": return " << className << "_" << variant.name << ".read(replay);\n";
+            }
+            outFile << indent3 << "default: throw new JsonParseException(parser, \"Unknown " << className << " " << tagged.property << ": \" + tag);\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n";
+        }
+        outFile << "}\n\n";
+    }
+
+    // Element kind of a non-empty array whose items are all numbers: "int32", "int64" or "float64";
+    // empty for anything else
+    std::string numericArrayKind(const json& value) {
+        if (!value.is_array() || value.empty()) return "";
+        bool fitsInt32 = true;
+        for (const auto& item : value) {
+            if (!item.is_number()) return "";
+            if (item.is_number_float()) return "float64";
+            if (item.is_number_unsigned() ? item.get<uint64_t>() > INT32_MAX : item.get<int64_t>() < INT32_MIN || item.get<int64_t>() > INT32_MAX) {
+                fitsInt32 = false;
+            }
+        }
+        return fitsInt32 ? "int32" : "int64";
+    }
+
+    // Primitive array type for an all-number array when typed arrays are enabled, else empty
+    std::string primitiveArrayType(const json& value) {
+        if (!typedArrays) return "";
+        std::string kind = numericArrayKind(value);
+        if (kind == "int32") return "int[]";
+        if (kind == "int64") return "long[]";
+        if (kind == "float64") return "double[]";
+        return "";
+    }
+
+    // Accessor for a primitive number type; the narrow ones fail on overflow instead of wrapping. Jackson's
+    // getByteValue also takes 128..255 and getFloatValue turns large doubles into infinity, so byte and
+    // float go through checked helpers
+    std::string numberGetter(const std::string& type) {
+        if (type == "byte") return "JsonStreaming.readByte(parser)";
+        if (type == "short") return "parser.getShortValue()";
+        if (type == "int") return "parser.getIntValue()";
+        if (type == "long") return "parser.getLongValue()";
+        if (type == "float") return "JsonStreaming.readFloat(parser)";
+        return "parser.getDoubleValue()";
+    }
+
+    // Declared type of a field; list elements must be boxed
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, bool boxed) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "UUID";
+            case StringFormat::Kind::DATE_TIME: return "Instant";
+            default: return "byte[]";
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (!primitiveArrayType(value).empty()) return primitiveArrayType(value);
+        if (value.is_array() && !value.empty()) return "List<" + fieldType(className, key, value[0], true) + ">";
+        if (boxed && value.is_boolean()) return "Boolean";
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            // Java has no unsigned types, so unsigned formats take the next wider signed type
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return format.bits == 32 ? (boxed ? "Float" : "float") : (boxed ? "Double" : "double");
+            int bits = format.asSigned().bits;
+            if (bits == 8) return boxed ? "Byte" : "byte";
+            if (bits == 16) return boxed ? "Short" : "short";
+            if (bits == 32) return boxed ? "Integer" : "int";
+            return boxed ? "Long" : "long";
+        }
+        if (boxed && value.is_number_integer()) return "Long";
+        if (boxed && value.is_number_float()) return "Double";
+        return toLanguageType(value, Config(), key);
+    }
+
+    std::string javaString(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    std::string constantName(const std::string& key) {
+        std::string result = "FIELD_";
+        for (unsigned char c : key) {
+            result += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+        }
+        return result;
+    }
+
+    void generateGettersAndSetters(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, false);
+            std::string capitalizedKey = key;
+            capitalizedKey[0] = std::toupper(capitalizedKey[0]);
+
+            outFile << std::string(config.indentSize, ' ') << "public " << type << " get" << capitalizedKey << "() {\n"
+                << std::string(config.indentSize * 2, ' ') << "return " << key << ";\n"
+                << std::string(config.indentSize, ' ') << "}\n\n"
+                << std::string(config.indentSize, ' ') << "public void set" << capitalizedKey << "(" << type << " " << key << ") {\n"
+                << std::string(config.indentSize * 2, ' ') << "this." << key << " = " << key << ";\n"
+                << std::string(config.indentSize, ' ') << "}\n\n";
+        }
+    }
+
+    // Patterns are compiled once into static fields; every other keyword is a plain comparison.
+    // Lengths count code points as JSON Schema does, without copying the string
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern) {
+                outFile << indent1 << "private static final Pattern " << patternName(key) << " = Pattern.compile(" << javaString(*constraints.pattern) << ");\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        outFile << indent1 << "public boolean isValid() {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if (" << violation << ") {\n"
+                << indent3 << "return false;\n"
+                << indent2 << "}\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "this." + key;
+            bool nullable = value.is_string() || value.is_object() || value.is_array();
+            // Optional fields may be absent, and only present values are checked
+            std::string guard = nullable && !constraints.required ? field + " != null && " : "";
+            if (nullable && constraints.required) check(field + " == null");
+            // A formatted field was checked by its parser when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check(guard + field + ".codePointCount(0, " + field + ".length()) < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(guard + field + ".codePointCount(0, " + field + ".length()) > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check(guard + "!" + patternName(key) + ".matcher(" + field + ").find()");
+            }
+            if (value.is_number()) {
+                // Only the limits of the declared type, widened for unsigned formats, make a bound redundant
+                NumberFormat format = numberFormats[className][key].asSigned();
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + (value.is_string() ? "!" + javaString(candidate.get<std::string>()) + ".equals(" + field + ")" : field + " != " + candidate.dump());
+                }
+                check(guard.empty() || allowed.size() == 1 ? guard + violation : guard + "(" + violation + ")");
+            }
+            if (value.is_array()) {
+                std::string size = primitiveArrayType(value).empty() ? ".size()" : ".length";
+                if (constraints.minItems) check(guard + field + size + " < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(guard + field + size + " > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent2 << "for (int i = 0; " << (constraints.required ? "" : field + " != null && ") << "i < " << field << ".size(); i++) {\n"
+                        << indent3 << "if (" << field << ".get(i) != null && !" << field << ".get(i).isValid()) {\n"
+                        << indent4 << "return false;\n"
+                        << indent3 << "}\n"
+                        << indent2 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check(guard + "!" + field + ".isValid()");
+            }
+        }
+        outFile << indent2 << "return true;\n"
+            << indent1 << "}\n";
+    }
+
+    std::string patternName(const std::string& key) {
+        std::string result;
+        for (unsigned char c : key) {
+            result += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+        }
+        return result + "_PATTERN";
+    }
+
+    void generateStreamingMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+
+        // Pre-encoded names skip the per-call UTF-8 encoding of field names when writing
+        for (auto& [key, value] : data.items()) {
+            outFile << indent1 << "private static final SerializedString " << constantName(key) << " = new SerializedString(" << javaString(key) << ");\n";
+        }
+        if (!data.empty()) {
+            outFile << "\n";
+        }
+
+        outFile << indent1 << "/**\n"
+            << indent1 << " * Reads an instance at the parser's current token, advancing to the first token of a fresh parser.\n"
+            << indent1 << " */\n"
+            << indent1 << "public static " << className << " read(JsonParser parser) throws IOException {\n"
+            << indent2 << "JsonToken token = parser.currentToken() == null ? parser.nextToken() : parser.currentToken();\n"
+            << indent2 << "if (token == JsonToken.VALUE_NULL) {\n"
+            << indent3 << "return null;\n"
+            << indent2 << "}\n"
+            << indent2 << "if (token != JsonToken.START_OBJECT) {\n"
+            << indent3 << "throw new JsonParseException(parser, \"Expected an object for " << className << "\");\n"
+            << indent2 << "}\n"
+            << indent2 << className << " result = new " << className << "();\n"
+            << indent2 << "String field;\n"
+            << indent2 << "while ((field = parser.nextFieldName()) != null) {\n"
+            << indent3 << "parser.nextToken();\n"
+            << indent3 << "switch (field) {\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << indent4 << "case " << javaString(key) << ":\n";
+            generateRead("result." + key, className, key, value, false, 5, outFile, config);
+            outFile << indent4 << indent1 << "break;\n";
+        }
+        outFile << indent4 << "default:\n"
+            << indent4 << indent1 << "parser.skipChildren();\n"
+            << indent4 << indent1 << "break;\n"
+            << indent3 << "}\n"
+            << indent2 << "}\n"
+            << indent2 << "return result;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "public void write(JsonGenerator generator) throws IOException {\n"
+            << indent2 << "generator.writeStartObject();\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << indent2 << "generator.writeFieldName(" << constantName(key) << ");\n";
+            generateWrite("this." + key, className, key, value, false, 2, outFile, config);
+        }
+        outFile << indent2 << "generator.writeEndObject();\n"
+            << indent1 << "}\n";
+    }
+
+    void generateRead(const std::string& target, const std::string& className, const std::string& key, const json& value, bool boxed, int level, std::ofstream& outFile, const Config& config) {
+        std::string pad(config.indentSize * level, ' ');
+        std::string indent(config.indentSize, ' ');
+        if (value.is_object()) {
+            outFile << pad << target << " = " << fieldType(className, key, value, boxed) << ".read(parser);\n";
+        }
+        else if (!primitiveArrayType(value).empty()) {
+            // Grows a primitive buffer in place, so no element is ever boxed
+            std::string type = primitiveArrayType(value);
+            std::string element = type.substr(0, type.size() - 2);
+            std::string array = "array" + std::to_string(level);
+            std::string size = "size" + std::to_string(level);
+            std::string getter = element == "int" ? "parser.getIntValue()" : element == "long" ? "parser.getLongValue()" : "parser.getDoubleValue()";
+            outFile << pad << "if (parser.currentToken() == JsonToken.VALUE_NULL) {\n"
+                << pad << indent << target << " = null;\n"
+                << pad << "} else {\n"
+                << pad << indent << type << " " << array << " = new " << element << "[16];\n"
+                << pad << indent << "int " << size << " = 0;\n"
+                << pad << indent << "while (parser.nextToken() != JsonToken.END_ARRAY) {\n"
+                << pad << indent << indent << "if (" << size << " == " << array << ".length) {\n"
+                << pad << indent << indent << indent << array << " = Arrays.copyOf(" << array << ", " << size << " * 2);\n"
+                << pad << indent << indent << "}\n"
+                << pad << indent << indent << array << "[" << size << "++] = " << getter << ";\n"
+                << pad << indent << "}\n"
+                << pad << indent << target << " = Arrays.copyOf(" << array << ", " << size << ");\n"
+                << pad << "}\n";
+        }
+        else if (value.is_array()) {
+            std::string list = "list" + std::to_string(level);
+            std::string item = "item" + std::to_string(level);
+            const json element = value.empty() ? json() : value[0];
+            std::string elementType = fieldType(className, key, element, true);
+            outFile << pad << "if (parser.currentToken() == JsonToken.VALUE_NULL) {\n"
+                << pad << indent << target << " = null;\n"
+                << pad << "} else {\n"
+                << pad << indent << "List<" << elementType << "> " << list << " = new ArrayList<>();\n"
+                << pad << indent << "while (parser.nextToken() != JsonToken.END_ARRAY) {\n"
+                << pad << indent << indent << elementType << " " << item << ";\n";
+            generateRead(item, className, key, element, true, level + 2, outFile, config);
+            outFile << pad << indent << indent << list << ".add(" << item << ");\n"
+                << pad << indent << "}\n"
+                << pad << indent << target << " = " << list << ";\n"
+                << pad << "}\n";
+        }
+        else if (value.is_string() && enumFields[className].count(key)) {
+            outFile << pad << target << " = parser.currentToken() == JsonToken.VALUE_NULL ? null : " << enumFields[className][key] << ".fromValue(parser.getText());\n";
+        }
+        else if (value.is_string() && stringFormats[className].count(key)) {
+            std::string type = fieldType(className, key, value, boxed);
+            std::string read = type == "UUID" ? "UUID.fromString(parser.getText())" : type == "Instant" ? "JsonFormats.readInstant(parser)" : "parser.getBinaryValue()";
+            outFile << pad << target << " = parser.currentToken() == JsonToken.VALUE_NULL ? null : " << read << ";\n";
+        }
+        else if (value.is_string()) {
+            outFile << pad << target << " = parser.getValueAsString();\n";
+        }
+        else if (value.is_null()) {
+            outFile << pad << target << " = JsonStreaming.readAny(parser);\n";
+        }
+        else {
+            std::string getter = value.is_boolean() ? "parser.getBooleanValue()" : numberGetter(fieldType(className, key, value, false));
+            if (boxed) {
+                outFile << pad << target << " = parser.currentToken() == JsonToken.VALUE_NULL ? null : " << getter << ";\n";
+            }
+            else {
+                // Like databind, null leaves a primitive at its default
+                outFile << pad << "if (parser.currentToken() != JsonToken.VALUE_NULL) {\n"
+                    << pad << indent << target << " = " << getter << ";\n"
+                    << pad << "}\n";
+            }
+        }
+    }
+
+    void generateWrite(const std::string& source, const std::string& className, const std::string& key, const json& value, bool boxed, int level, std::ofstream& outFile, const Config& config) {
+        std::string pad(config.indentSize * level, ' ');
+        std::string indent(config.indentSize, ' ');
+        if (value.is_string() && enumFields[className].count(key)) {
+            outFile << pad << "generator.writeString(" << source << " == null ? null : " << source << ".value());\n";
+        }
+        else if (value.is_string() && fieldType(className, key, value, boxed) == "byte[]") {
+            outFile << pad << "if (" << source << " == null) {\n"
+                << pad << indent << "generator.writeNull();\n"
+                << pad << "} else {\n"
+                << pad << indent << "generator.writeBinary(" << source << ");\n"
+                << pad << "}\n";
+        }
+        else if (value.is_string() && stringFormats[className].count(key)) {
+            outFile << pad << "generator.writeString(" << source << " == null ? null : " << source << ".toString());\n";
+        }
+        else if (value.is_string()) {
+            outFile << pad << "generator.writeString(" << source << ");\n";
+        }
+        else if (value.is_null()) {
+            outFile << pad << "JsonStreaming.writeAny(generator, " << source << ");\n";
+        }
+        else if (value.is_object() || value.is_array() || boxed) {
+            outFile << pad << "if (" << source << " == null) {\n"
+                << pad << indent << "generator.writeNull();\n"
+                << pad << "} else {\n";
+            if (value.is_object()) {
+                outFile << pad << indent << source << ".write(generator);\n";
+            }
+            else if (!primitiveArrayType(value).empty()) {
+                outFile << pad << indent << "generator.writeArray(" << source << ", 0, " << source << ".length);\n";
+            }
+            else if (value.is_array()) {
+                std::string item = "item" + std::to_string(level);
+                const json element = value.empty() ? json() : value[0];
+                outFile << pad << indent << "generator.writeStartArray();\n"
+                    << pad << indent << "for (" << fieldType(className, key, element, true) << " " << item << " : " << source << ") {\n";
+                generateWrite(item, className, key, element, true, level + 2, outFile, config);
+                outFile << pad << indent << "}\n"
+                    << pad << indent << "generator.writeEndArray();\n";
+            }
+            else {
+                generateWrite(source, className, key, value, false, level + 1, outFile, config);
+            }
+            outFile << pad << "}\n";
+        }
+        else {
+            outFile << pad << "generator." << (value.is_boolean() ? "writeBoolean(" : "writeNumber(") << source << ");\n";
+        }
+    }
+
+    // JMH sources are written next to the model as <Class>Benchmark.java
+    void generateBenchmark(const std::string& className, const json& sampleData, const Config& config) {
+        std::string directory = config.outputFile.substr(0, config.outputFile.find_last_of("/\\") + 1);
+        std::ofstream benchFile(directory + className + "Benchmark.java");
+        if (!benchFile.is_open()) {
+            return;
+        }
+
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        benchFile << "import java.io.IOException;\n"
+            << "import java.io.StringWriter;\n"
+            << "import java.util.concurrent.TimeUnit;\n"
+            << "import com.fasterxml.jackson.core.JsonFactory;\n"
+            << "import com.fasterxml.jackson.core.JsonGenerator;\n"
+            << "import com.fasterxml.jackson.core.JsonParser;\n"
+            << "import com.fasterxml.jackson.databind.ObjectMapper;\n"
+            << "import org.openjdk.jmh.annotations.*;\n\n"
+            << "// Throughput of the generated streaming codecs against ObjectMapper databind\n"
+            << "@BenchmarkMode(Mode.Throughput)\n"
+            << "@OutputTimeUnit(TimeUnit.MILLISECONDS)\n"
+            << "@State(Scope.Benchmark)\n"
+            << "@Warmup(iterations = 3)\n"
+            << "@Measurement(iterations = 5)\n"
+            << "@Fork(1)\n"
+            << "public class " << className << "Benchmark {\n"
+            << indent1 << "private static final String SAMPLE_JSON = " << javaString(sampleData.dump()) << ";\n\n"
+            << indent1 << "private final JsonFactory factory = new JsonFactory();\n"
+            << indent1 << "private final ObjectMapper objectMapper = new ObjectMapper();\n"
+            << indent1 << "private " << className << " model;\n\n"
+            << indent1 << "@Setup\n"
+            << indent1 << "public void setup() throws IOException {\n"
+            << indent2 << "model = objectMapper.readValue(SAMPLE_JSON, " << className << ".class);\n"
+            << indent1 << "}\n\n"
+            << indent1 << "@Benchmark\n"
+            << indent1 << "public " << className << " readStreaming() throws IOException {\n"
+            << indent2 << "try (JsonParser parser = factory.createParser(SAMPLE_JSON)) {\n"
+            << indent3 << "return " << className << ".read(parser);\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "@Benchmark\n"
+            << indent1 << "public " << className << " readDatabind() throws IOException {\n"
+            << indent2 << "return objectMapper.readValue(SAMPLE_JSON, " << className << ".class);\n"
+            << indent1 << "}\n\n"
+            << indent1 << "@Benchmark\n"
+            << indent1 << "public String writeStreaming() throws IOException {\n"
+            << indent2 << "StringWriter writer = new StringWriter();\n"
+            << indent2 << "try (JsonGenerator generator = factory.createGenerator(writer)) {\n"
+            << indent3 << "model.write(generator);\n"
+            << indent2 << "}\n"
+            << indent2 << "return writer.toString();\n"
+            << indent1 << "}\n\n"
+            << indent1 << "@Benchmark\n"
+            << indent1 << "public String writeDatabind() throws IOException {\n"
+            << indent2 << "return objectMapper.writeValueAsString(model);\n"
+            << indent1 << "}\n"
+            << "}\n";
+    }
+
+    // Databind reads UUID and byte[] (as base64) itself, but Instant needs the jsr310 module, so it gets
+    // its own serializers. Offsets are accepted on input and Instant.toString writes UTC with a Z
+    void generateFormatSupport(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "// String format helpers shared by databind and the generated read/write methods\n"
+            << "final class JsonFormats {\n"
+            << indent1 << "private JsonFormats() {\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static Instant readInstant(JsonParser parser) throws IOException {\n"
+            << indent2 << "try {\n"
+            << indent3 << "return OffsetDateTime.parse(parser.getText()).toInstant();\n"
+            << indent2 << "} catch (DateTimeParseException e) {\n"
+            << indent3 << "throw new JsonParseException(parser, \"Invalid date-time: \" + parser.getText(), e);\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "public static final class InstantSerializer extends StdSerializer<Instant> {\n"
+            << indent2 << "public InstantSerializer() {\n"
+            << indent3 << "super(Instant.class);\n"
+            << indent2 << "}\n\n"
+            << indent2 << "@Override\n"
+            << indent2 << "public void serialize(Instant value, JsonGenerator generator, SerializerProvider provider) throws IOException {\n"
+            << indent3 << "generator.writeString(value.toString());\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "public static final class InstantDeserializer extends StdDeserializer<Instant> {\n"
+            << indent2 << "public InstantDeserializer() {\n"
+            << indent3 << "super(Instant.class);\n"
+            << indent2 << "}\n\n"
+            << indent2 << "@Override\n"
+            << indent2 << "public Instant deserialize(JsonParser parser, DeserializationContext context) throws IOException {\n"
+            << indent3 << "return readInstant(parser);\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    void generateStreamingSupport(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+
+        outFile << "// Streaming helpers shared by the generated read/write methods\n"
+            << "final class JsonStreaming {\n"
+            << indent1 << "private JsonStreaming() {\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static byte readByte(JsonParser parser) throws IOException {\n"
+            << indent2 << "int value = parser.getIntValue();\n"
+            << indent2 << "if (value < Byte.MIN_VALUE || value > Byte.MAX_VALUE) {\n"
+            << indent3 << "throw new JsonParseException(parser, \"Numeric value (\" + value + \") out of range of byte\");\n"
+            << indent2 << "}\n"
+            << indent2 << "return (byte) value;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static float readFloat(JsonParser parser) throws IOException {\n"
+            << indent2 << "double value = parser.getDoubleValue();\n"
+            << indent2 << "if (!Double.isInfinite(value) && Math.abs(value) > Float.MAX_VALUE) {\n"
+            << indent3 << "throw new JsonParseException(parser, \"Numeric value (\" + value + \") out of range of float\");\n"
+            << indent2 << "}\n"
+            << indent2 << "return (float) value;\n"
+            << indent1 << "}\n\n"
+            << indent1 << "// Untyped values decode to the same Map/List/scalar shapes databind uses for Object\n"
+            << indent1 << "static Object readAny(JsonParser parser) throws IOException {\n"
+            << indent2 << "switch (parser.currentToken()) {\n"
+            << indent3 << "case START_OBJECT:\n"
+            << indent4 << "Map<String, Object> map = new LinkedHashMap<>();\n"
+            << indent4 << "String field;\n"
+            << indent4 << "while ((field = parser.nextFieldName()) != null) {\n"
+            << indent5 << "parser.nextToken();\n"
+            << indent5 << "map.put(field, readAny(parser));\n"
+            << indent4 << "}\n"
+            << indent4 << "return map;\n"
+            << indent3 << "case START_ARRAY:\n"
+            << indent4 << "List<Object> list = new ArrayList<>();\n"
+            << indent4 << "while (parser.nextToken() != JsonToken.END_ARRAY) {\n"
+            << indent5 << "list.add(readAny(parser));\n"
+            << indent4 << "}\n"
+            << indent4 << "return list;\n"
+            << indent3 << "case VALUE_STRING:\n"
+            << indent4 << "return parser.getText();\n"
+            << indent3 << "case VALUE_NUMBER_INT:\n"
+            << indent3 << "case VALUE_NUMBER_FLOAT:\n"
+            << indent4 << "return parser.getNumberValue();\n"
+            << indent3 << "case VALUE_TRUE:\n"
+            << indent4 << "return Boolean.TRUE;\n"
+            << indent3 << "case VALUE_FALSE:\n"
+            << indent4 << "return Boolean.FALSE;\n"
+            << indent3 << "default:\n"
+            << indent4 << "return null;\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static void writeAny(JsonGenerator generator, Object value) throws IOException {\n"
+            << indent2 << "if (value == null) {\n"
+            << indent3 << "generator.writeNull();\n"
+            << indent2 << "} else if (value instanceof String) {\n"
+            << indent3 << "generator.writeString((String) value);\n"
+            << indent2 << "} else if (value instanceof Boolean) {\n"
+            << indent3 << "generator.writeBoolean((Boolean) value);\n"
+            << indent2 << "} else if (value instanceof Integer) {\n"
+            << indent3 << "generator.writeNumber((Integer) value);\n"
+            << indent2 << "} else if (value instanceof Long) {\n"
+            << indent3 << "generator.writeNumber((Long) value);\n"
+            << indent2 << "} else if (value instanceof BigInteger) {\n"
+            << indent3 << "generator.writeNumber((BigInteger) value);\n"
+            << indent2 << "} else if (value instanceof BigDecimal) {\n"
+            << indent3 << "generator.writeNumber((BigDecimal) value);\n"
+            << indent2 << "} else if (value instanceof Number) {\n"
+            << indent3 << "generator.writeNumber(((Number) value).doubleValue());\n"
+            << indent2 << "} else if (value instanceof Map) {\n"
+            << indent3 << "generator.writeStartObject();\n"
+            << indent3 << "for (Map.Entry<?, ?> entry : ((Map<?, ?>) value).entrySet()) {\n"
+            << indent4 << "generator.writeFieldName(String.valueOf(entry.getKey()));\n"
+            << indent4 << "writeAny(generator, entry.getValue());\n"
+            << indent3 << "}\n"
+            << indent3 << "generator.writeEndObject();\n"
+            << indent2 << "} else if (value instanceof List) {\n"
+            << indent3 << "generator.writeStartArray();\n"
+            << indent3 << "for (Object item : (List<?>) value) {\n"
+            << indent4 << "writeAny(generator, item);\n"
+            << indent3 << "}\n"
+            << indent3 << "generator.writeEndArray();\n"
+            << indent2 << "} else {\n"
+            << indent3 << "// Anything else needs an ObjectCodec configured on the generator\n"
+            << indent3 << "generator.writeObject(value);\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << "}\n";
+
+    }
+};
@@ -1,306 +1,704 @@
-#include "json_model_generator.hpp"
-#include "cpp_generator.cpp"
-#include "csharp_generator.cpp"
-#include "dart_generator.cpp"
-#include "elixir_generator.cpp"
-#include "go_generator.cpp"
-#include "java_generator.cpp"
-#include "kotlin_generator.cpp"
-#include "python_generator.cpp"
-#include "rust_generator.cpp"
-#include "scala_generator.cpp"
-#include "swift_generator.cpp"
-#include "typescript_generator.cpp"
-#include <iostream>
-#include <algorithm>
-#include <cstring>
-
-int main(int argc, char* argv[]) {
-    Config config = parseConfig(argc, argv);
-
-    if (config.showHelp) {
-        printUsage(argv[0]);
-        return 0;
-    }
-
-    try {
-        json inputJson = readJsonFromFile(config.inputFile);
-        json schema;
-
-        if (config.useSchema) {
-            schema = readSchemaFromFile(config.schemaFile);
-        }
-        else {
-            schema = inferSchemaFromJson(inputJson);
-        }
-
-        if (config.verbose) {
-            std::cout << "Input JSON file: " << config.inputFile << std::endl;
-            if (config.useSchema) {
-                std::cout << "JSON Schema file: " << config.schemaFile << std::endl;
-            }
-            else {
-                std::cout << "Using inferred schema" << std::endl;
-            }
-            std::cout << "Output language: " << languageToString(config.lang) << std::endl;
-            std::cout << "Output file: " << config.outputFile << std::endl;
-        }
-
-        if (config.dryRun) {
-            std::cout << "Dry run mode. No files will be generated." << std::endl;
-            return 0;
-        }
-
-        std::ofstream outFile(config.outputFile);
-        if (!outFile.is_open()) {
-            throw std::runtime_error("Unable to create output file: " + config.outputFile);
-        }
-
-        LanguageGenerator* generator = createLanguageGenerator(config.lang);
-        CircularReferenceHandler circHandler;
-
-        if (config.verbose) {
-            std::cout << "Generating file header..." << std::endl;
-        }
-        generator->generateFileHeader(outFile, config);
-
-        if (config.verbose) {
-            std::cout << "Generating enums..." << std::endl;
-        }
-        generator->generateEnums(schema, outFile, config);
-
-        if (config.verbose) {
-            std::cout << "Resolving circular references..." << std::endl;
-        }
-        circHandler.resolveCircularReferences(outFile, config, generator);
-
-        if (config.verbose) {
-            std::cout << "Generating main class..." << std::endl;
-        }
-        generator->generateClass("RootModel", inputJson, schema, outFile, config, circHandler);
-
-        outFile.close();
-
-        if (config.verbose) {
-            std::cout << "Generating unit tests..." << std::endl;
-        }
-        std::ofstream testFile(config.outputFile + "_test." + getFileExtension(config.lang));
-        if (testFile.is_open()) {
-            generator->generateUnitTests("RootModel", inputJson, testFile, config);
-            testFile.close();
-            if (config.verbose) {
-                std::cout << "Test file '" << config.outputFile + "_test." + getFileExtension(config.lang) << "' has been generated." << std::endl;
-            }
-        }
-
-        if (config.verbose) {
-            std::cout << "Model file '" << config.outputFile << "' has been generated." << std::endl;
-        }
-
-        delete generator;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-        return 1;
-    }
-
-    return 0;
-}
-
-Config parseConfig(int argc, char* argv[]) {
-    Config config;
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            config.showHelp = true;
-        }
-        else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
-            if (i + 1 < argc) config.inputFile = argv[++i];
-        }
-        else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--schema") == 0) {
-            if (i + 1 < argc) {
-                config.schemaFile = argv[++i];
-                config.useSchema = true;
-            }
-        }
-        else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--language") == 0) {
-            if (i + 1 < argc) config.lang = stringToLanguage(argv[++i]);
-        }
-        else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
-            if (i + 1 < argc) config.outputFile = argv[++i];
-        }
-        else if (strcmp(argv[i], "--docs") == 0) {
-            config.generateDocs = true;
-        }
-        else if (strcmp(argv[i], "--validation") == 0) {
-            config.generateValidation = true;
-        }
-        else if (strcmp(argv[i], "--builder") == 0) {
-            config.useBuilderPattern = true;
-        }
-        else if (strcmp(argv[i], "--immutable") == 0) {
-            config.generateImmutable = true;
-        }
-        else if (strcmp(argv[i], "--indent") == 0) {
-            if (i + 1 < argc) config.indentSize = std::stoi(argv[++i]);
-        }
-        else if (strcmp(argv[i], "--brace-style") == 0) {
-            if (i + 1 < argc) config.braceStyle = argv[++i];
-        }
-        else if (strcmp(argv[i], "--custom-types") == 0) {
-            if (i + 1 < argc) config.customTypeMappingsFile = argv[++i];
-        }
-        else if (strcmp(argv[i], "--verbose") == 0) {
-            config.verbose = true;
-        }
-        else if (strcmp(argv[i], "--dry-run") == 0) {
-            config.dryRun = true;
-        }
-    }
-    return config;
-}
-
-void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " [options]\n"
-        << "Options:\n"
-        << "  -h, --help                 Show this help message\n"
-        << "  -i, --input <file>         Input JSON file\n"
-        << "  -s, --schema <file>        JSON Schema file (optional)\n"
-        << "  -l, --language <lang>      Output language (cpp, csharp, java, python, go, typescript, rust, swift, dart, kotlin, elixir, scala)\n"
-        << "  -o, --output <file>        Output file name\n"
-        << "  --docs                     Generate documentation comments\n"
-        << "  --validation               Generate validation methods\n"
-        << "  --builder                  Use builder pattern (for supported languages)\n"
-        << "  --immutable                Generate immutable objects\n"
-        << "  --indent <size>            Indentation size (default: 4)\n"
-        << "  --brace-style <style>      Brace style (same-line, new-line)\n"
-        << "  --custom-types <file>      JSON file with custom type mappings\n"
-        << "  --verbose                  Enable verbose output\n"
-        << "  --dry-run                  Show what would be generated without creating files\n";
-}
-
-json readJsonFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Unable to open file: " + filename);
-    }
-    json j;
-    file >> j;
-    return j;
-}
-
-json readSchemaFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Unable to open schema file: " + filename);
-    }
-    json schema_json;
-    file >> schema_json;
-    return schema_json;
-}
-
-json inferSchemaFromJson(const json& data) {
-    json schema;
-    schema["type"] = "object";
-    schema["properties"] = json::object();
-
-    for (auto& [key, value] : data.items()) {
-        if (value.is_null()) {
-            schema["properties"][key]["type"] = "null";
-        }
-        else if (value.is_boolean()) {
-            schema["properties"][key]["type"] = "boolean";
-        }
-        else if (value.is_number_integer()) {
-            schema["properties"][key]["type"] = "integer";
-        }
-        else if (value.is_number_float()) {
-            schema["properties"][key]["type"] = "number";
-        }
-        else if (value.is_string()) {
-            schema["properties"][key]["type"] = "string";
-        }
-        else if (value.is_array()) {
-            schema["properties"][key]["type"] = "array";
-            if (!value.empty()) {
-                schema["properties"][key]["items"] = inferSchemaFromJson(value[0]);
-            }
-        }
-        else if (value.is_object()) {
-            schema["properties"][key] = inferSchemaFromJson(value);
-        }
-    }
-
-    return schema;
-}
-
-LanguageGenerator* createLanguageGenerator(Language lang) {
-    switch (lang) {
-    case Language::CPP: return new CppGenerator();
-    case Language::CSHARP: return new CSharpGenerator();
-    case Language::JAVA: return new JavaGenerator();
-    case Language::PYTHON: return new PythonGenerator();
-    case Language::GO: return new GoGenerator();
-    case Language::TYPESCRIPT: return new TypeScriptGenerator();
-    case Language::RUST: return new RustGenerator();
-    case Language::SWIFT: return new SwiftGenerator();
-    case Language::DART: return new DartGenerator();
-    case Language::KOTLIN: return new KotlinGenerator();
-    case Language::ELIXIR: return new ElixirGenerator();
-    case Language::SCALA: return new ScalaGenerator();
-    default: throw std::runtime_error("Unsupported language");
-    }
-}
-
-std::string languageToString(Language lang) {
-    switch (lang) {
-    case Language::CPP: return "C++";
-    case Language::CSHARP: return "C#";
-    case Language::JAVA: return "Java";
-    case Language::PYTHON: return "Python";
-    case Language::GO: return "Go";
-    case Language::TYPESCRIPT: return "TypeScript";
-    case Language::RUST: return "Rust";
-    case Language::SWIFT: return "Swift";
-    case Language::DART: return "Dart";
-    case Language::KOTLIN: return "Kotlin";
-    case Language::ELIXIR: return "Elixir";
-    case Language::SCALA: return "Scala";
-    default: return "Unknown";
-    }
-}
-
-Language stringToLanguage(const std::string& lang) {
-    std::string lowerLang = lang;
-    std::transform(lowerLang.begin(), lowerLang.end(), lowerLang.begin(), ::tolower);
-    if (lowerLang == "cpp") return Language::CPP;
-    if (lowerLang == "csharp") return Language::CSHARP;
-    if (lowerLang == "java") return Language::JAVA;
-    if (lowerLang == "python") return Language::PYTHON;
-    if (lowerLang == "go") return Language::GO;
-    if (lowerLang == "typescript") return Language::TYPESCRIPT;
-    if (lowerLang == "rust") return Language::RUST;
-    if (lowerLang == "swift") return Language::SWIFT;
-    if (lowerLang == "dart") return Language::DART;
-    if (lowerLang == "kotlin") return Language::KOTLIN;
-    if (lowerLang == "elixir") return Language::ELIXIR;
-    if (lowerLang == "scala") return Language::SCALA;
-    throw std::runtime_error("Unsupported language: " + lang);
-}
-
-std::string getFileExtension(Language lang) {
-    switch (lang) {
-    case Language::CPP: return "hpp";
-    case Language::CSHARP: return "cs";
-    case Language::JAVA: return "java";
-    case Language::PYTHON: return "py";
-    case Language::GO: return "go";
-    case Language::TYPESCRIPT: return "ts";
-    case Language::RUST: return "rs";
-    case Language::SWIFT: return "swift";
-    case Language::DART: return "dart";
-    case Language::KOTLIN: return "kt";
-    case Language::ELIXIR: return "ex";
-    case Language::SCALA: return "scala";
-    default: return "txt";
-    }
+#include "json_model_generator.hpp"
+#include "arrow_generator.cpp"
+#include "capnproto_generator.cpp"
+#include "cpp_generator.cpp"
+#include "csharp_generator.cpp"
+#include "dart_generator.cpp"
+#include "elixir_generator.cpp"
+#include "flatbuffers_generator.cpp"
+#include "go_generator.cpp"
+#include "java_generator.cpp"
+#include "kotlin_generator.cpp"
+#include "protobuf_generator.cpp"
+#include "python_generator.cpp"
+#include "rust_generator.cpp"
+#include "scala_generator.cpp"
+#include "swift_generator.cpp"
+#include "typescript_generator.cpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <memory>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// The benchmark target links these sources with its own main
+#ifndef JSON_MODEL_GENERATOR_NO_MAIN
+namespace {
+
+// Everything after the command line: validation, or reading, inference and generation
+int run(Config& config) {
+    try {
+        if (!config.validateFile.empty()) {
+            return runValidation(config);
+        }
+
+        std::unique_ptr<Profiler> profiler(config.profile ? new Profiler() : nullptr);
+        json inputJson;
+        {
+            Profiler::Scope scope(profiler.get(), "read");
+            inputJson = readJsonFromFile(config.inputFile, config.inputFormat);
+        }
+        json schema;
+
+        if (config.useSchema) {
+            Profiler::Scope scope(profiler.get(), "read schema");
+            schema = readSchemaFromFile(config.schemaFile);
+            TaggedUnion::inlineVariants(schema);
+        }
+        else {
+            Profiler::Scope scope(profiler.get(), "infer");
+            schema = inferSchemaFromJson(inputJson, config.enumThreshold);
+        }
+        NumberFormat::conform(inputJson, schema);
+        // Headers need to know up front whether the compact string types and their imports are used
+        config.stringFormats = StringFormat::usedBy(schema, config);
+        config.taggedUnions = TaggedUnion::usedBy(schema, config);
+        if (config.generateValidation) {
+            config.stringPatterns = FieldConstraints::usedBy(schema, inputJson, { "pattern" }, config);
+            config.stringLengths = FieldConstraints::usedBy(schema, inputJson, { "minLength", "maxLength" }, config);
+        }
+
+        if (config.verbose) {
+            std::cout << "Input JSON file: " << config.inputFile << std::endl;
+            std::cout << "Input format: " << inputFormatToString(config.inputFormat == InputFormat::AUTO ? detectInputFormat(config.inputFile) : config.inputFormat) << std::endl;
+            if (config.useSchema) {
+                std::cout << "JSON Schema file: " << config.schemaFile << std::endl;
+            }
+            else {
+                std::cout << "Using inferred schema" << std::endl;
+            }
+            std::cout << "Output language: " << languageToString(config.lang) << std::endl;
+            std::cout << "Output file: " << config.outputFile << std::endl;
+        }
+
+        if (config.dryRun) {
+            std::cout << "Dry run mode. No files will be generated." << std::endl;
+            return 0;
+        }
+
+        std::ofstream outFile(config.outputFile);
+        if (!outFile.is_open()) {
+            throw std::runtime_error("Unable to create output file: " + config.outputFile);
+        }
+
+        LanguageGenerator* generator = createLanguageGenerator(config.lang, profiler.get());
+        CircularReferenceHandler circHandler;
+
+        if (config.verbose) {
+            std::cout << "Generating file header..." << std::endl;
+        }
+        {
+            Profiler::Scope scope(profiler.get(), "header");
+            generator->generateFileHeader(outFile, config);
+        }
+
+        if (config.verbose) {
+            std::cout << "Generating enums..." << std::endl;
+        }
+        {
+            Profiler::Scope scope(profiler.get(), "enums");
+            generator->generateEnums(schema, outFile, config);
+        }
+
+        if (config.verbose) {
+            std::cout << "Resolving circular references..." << std::endl;
+        }
+        {
+            Profiler::Scope scope(profiler.get(), "circular refs");
+            circHandler.resolveCircularReferences(outFile, config, generator);
+        }
+
+        if (config.verbose) {
+            std::cout << "Generating main class..." << std::endl;
+        }
+        {
+            Profiler::Scope scope(profiler.get(), "classes");
+            generator->generateClass("RootModel", inputJson, schema, outFile, config, circHandler);
+        }
+
+        {
+            // Output is buffered, so the last of it reaches the file here
+            Profiler::Scope scope(profiler.get(), "write");
+            outFile.close();
+        }
+
+        if (config.verbose) {
+            std::cout << "Generating unit tests..." << std::endl;
+        }
+        std::ofstream testFile(config.outputFile + "_test." + getFileExtension(config.lang));
+        if (testFile.is_open()) {
+            {
+                Profiler::Scope scope(profiler.get(), "unit tests");
+                generator->generateUnitTests("RootModel", inputJson, testFile, config);
+            }
+            {
+                Profiler::Scope scope(profiler.get(), "write");
+                testFile.close();
+            }
+            if (config.verbose) {
+                std::cout << "Test file '" << config.outputFile + "_test." + getFileExtension(config.lang) << "' has been generated." << std::endl;
+            }
+        }
+
+        if (config.verbose) {
+            std::cout << "Model file '" << config.outputFile << "' has been generated." << std::endl;
+        }
+
+        delete generator;
+
+        if (profiler) {
+            profiler->writeSummary(std::cerr);
+            profiler->writeTrace(config.outputFile + ".trace.json");
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Inference and the generators recurse once per nesting level of the input, which overflows a default
+// stack of a few megabytes within some thousand levels. The work runs on a thread whose stack is only
+// reserved up front, so shallow input commits no more memory than before; Windows links a larger main
+// stack instead, and where the thread cannot start the work runs here
+int runOnLargeStack(Config& config) {
+#ifdef _WIN32
+    return run(config);
+#else
+    const size_t stackBytes = size_t(256) << 20;
+    struct Call {
+        Config* config;
+        int result;
+    } call{ &config, 1 };
+    pthread_attr_t attributes;
+    if (pthread_attr_init(&attributes) != 0) {
+        return run(config);
+    }
+    pthread_t thread;
+    bool started = pthread_attr_setstacksize(&attributes, stackBytes) == 0
+        && pthread_create(&thread, &attributes, [](void* argument) -> void* {
+            Call* call = static_cast<Call*>(argument);
+            call->result = run(*call->config);
+            return nullptr;
+        }, &call) == 0;
+    pthread_attr_destroy(&attributes);
+    if (!started) {
+        return run(config);
+    }
+    pthread_join(thread, nullptr);
+    return call.result;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        config = parseConfig(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    return runOnLargeStack(config);
+}
+#endif
+
+Config parseConfig(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            config.showHelp = true;
+        }
+        else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 < argc) config.inputFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--input-format") == 0) {
+            if (i + 1 < argc) config.inputFormat = stringToInputFormat(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--schema") == 0) {
+            if (i + 1 < argc) {
+                config.schemaFile = argv[++i];
+                config.useSchema = true;
+            }
+        }
+        else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--language") == 0) {
+            if (i + 1 < argc) config.lang = stringToLanguage(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
+            if (i + 1 < argc) config.outputFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--docs") == 0) {
+            config.generateDocs = true;
+        }
+        else if (strcmp(argv[i], "--validation") == 0) {
+            config.generateValidation = true;
+        }
+        else if (strcmp(argv[i], "--builder") == 0) {
+            config.useBuilderPattern = true;
+        }
+        else if (strcmp(argv[i], "--immutable") == 0) {
+            config.generateImmutable = true;
+        }
+        else if (strcmp(argv[i], "--indent") == 0) {
+            if (i + 1 < argc) config.indentSize = std::stoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--brace-style") == 0) {
+            if (i + 1 < argc) config.braceStyle = argv[++i];
+        }
+        else if (strcmp(argv[i], "--custom-types") == 0) {
+            if (i + 1 < argc) config.customTypeMappingsFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--verbose") == 0) {
+            config.verbose = true;
+        }
+        else if (strcmp(argv[i], "--dry-run") == 0) {
+            config.dryRun = true;
+        }
+        else if (strcmp(argv[i], "--soa") == 0) {
+            config.generateColumns = true;
+        }
+        else if (strcmp(argv[i], "--lazy") == 0) {
+            config.lazyDecoding = true;
+        }
+        else if (strcmp(argv[i], "--binary-codecs") == 0) {
+            config.generateBinaryCodecs = true;
+        }
+        else if (strcmp(argv[i], "--static-codecs") == 0) {
+            config.staticCodecs = true;
+        }
+        else if (strcmp(argv[i], "--python-style") == 0) {
+            if (i + 1 < argc) config.pythonStyle = argv[++i];
+        }
+        else if (strcmp(argv[i], "--value-types") == 0) {
+            config.valueTypes = true;
+        }
+        else if (strcmp(argv[i], "--typed-arrays") == 0) {
+            config.typedArrays = true;
+        }
+        else if (strcmp(argv[i], "--borrow") == 0) {
+            config.borrowStrings = true;
+        }
+        else if (strcmp(argv[i], "--wide-numbers") == 0) {
+            config.wideNumbers = true;
+        }
+        else if (strcmp(argv[i], "--plain-strings") == 0) {
+            config.plainStrings = true;
+        }
+        else if (strcmp(argv[i], "--plain-unions") == 0) {
+            config.plainUnions = true;
+        }
+        else if (strcmp(argv[i], "--profile") == 0) {
+            config.profile = true;
+        }
+        else if (strcmp(argv[i], "--enum-threshold") == 0) {
+            if (i + 1 < argc) config.enumThreshold = std::stoul(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--validate") == 0) {
+            if (i + 1 < argc) config.validateFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 < argc) config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+    }
+    // Lazy models decode from the raw JSON text, so there is no object for a binary codec to fill
+    if (config.lazyDecoding && config.generateBinaryCodecs) {
+        throw std::invalid_argument("--lazy cannot be combined with --binary-codecs");
+    }
+    return config;
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]\n"
+        << "Options:\n"
+        << "  -h, --help                 Show this help message\n"
+        << "  -i, --input <file>         Input JSON file\n"
+        << "  --input-format <format>    Input encoding (auto, json, cbor, msgpack, bson, ubjson; default: auto)\n"
+        << "  -s, --schema <file>        JSON Schema file (optional)\n"
+        << "  -l, --language <lang>      Output language (cpp, csharp, java, python, go, typescript, rust, swift, dart, kotlin, elixir, scala,\n"
+        << "                             flatbuffers, capnp, proto, arrow)\n"
+        << "  -o, --output <file>        Output file name\n"
+        << "  --docs                     Generate documentation comments\n"
+        << "  --validation               Generate validation methods\n"
+        << "  --builder                  Use builder pattern (for supported languages)\n"
+        << "  --immutable                Generate immutable objects\n"
+        << "  --indent <size>            Indentation size (default: 4)\n"
+        << "  --brace-style <style>      Brace style (same-line, new-line)\n"
+        << "  --custom-types <file>      JSON file with custom type mappings\n"
+        << "  --verbose                  Enable verbose output\n"
+        << "  --dry-run                  Show what would be generated without creating files\n"
+        << "  --soa                      Generate Structure-of-Arrays column containers for arrays of objects (cpp)\n"
+        << "  --lazy                     Decode fields on first access instead of up front (cpp)\n"
+        << "  --binary-codecs            Generate MessagePack and CBOR encode/decode methods (cpp)\n"
+        << "  --static-codecs            Generate reflection-free JSON encode/decode code (go, java, csharp, scala, elixir)\n"
+        << "  --value-types              Generate small all-scalar types as value types (csharp, kotlin, scala)\n"
+        << "  --typed-arrays             Generate packed typed arrays for all-number arrays (typescript, python, dart, java)\n"
+        << "  --borrow                   Generate zero-copy string fields borrowed from the input (rust)\n"
+        << "  --python-style <style>     Python model style (pydantic, dataclass, msgspec, msgspec-array; default: pydantic)\n"
+        << "  --wide-numbers             Generate 64-bit integers and doubles instead of the narrowest inferred types\n"
+        << "  --plain-strings            Keep UUID, date-time and base64 fields as strings instead of compact types\n"
+        << "  --plain-unions             Model arrays of differently shaped tagged objects by their first item\n"
+        << "  --profile                  Print time, allocations and peak RSS per phase and class to stderr and\n"
+        << "                             write a Chrome trace (Perfetto, chrome://tracing) to <output>.trace.json\n"
+        << "  --enum-threshold <n>       Infer string fields with at most n distinct values in the sample as enums (default: 0, off)\n"
+        << "  --validate <file>          Check each record of an NDJSON file against the schema (-s, or inferred from -i)\n"
+        << "                             instead of generating code; failures go to -o or stdout\n"
+        << "  --threads <n>              Worker threads for --validate (default: all hardware threads)\n";
+}
+
+json readJsonFromFile(const std::string& filename, InputFormat format) {
+    if (format == InputFormat::AUTO) {
+        format = detectInputFormat(filename);
+    }
+    std::ifstream file(filename, format == InputFormat::JSON ? std::ios::in : std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    // Binary encodings are decoded straight from the stream, without a text round trip
+    switch (format) {
+    case InputFormat::CBOR: return json::from_cbor(file);
+    case InputFormat::MSGPACK: return json::from_msgpack(file);
+    case InputFormat::BSON: return json::from_bson(file);
+    case InputFormat::UBJSON: return json::from_ubjson(file);
+    default: {
+        json j;
+        file >> j;
+        return j;
+    }
+    }
+}
+
+json readSchemaFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open schema file: " + filename);
+    }
+    json schema_json;
+    file >> schema_json;
+    return schema_json;
+}
+
+// Enums synthesized during inference for string properties with few distinct values; they go to the
+// root schema's "definitions", named after the property
+struct InferredEnums {
+    size_t threshold = 0;
+    json definitions = json::object();
+
+    // Distinct values of the string samples, or nothing when there are more than the threshold, or too
+    // few samples to tell a category from a free-form string: every value must repeat on average
+    std::optional<std::set<std::string>> categories(const std::vector<const json*>& samples) const {
+        if (threshold == 0) return std::nullopt;
+        std::set<std::string> distinct;
+        for (const json* sample : samples) {
+            if (!sample->is_string()) continue;
+            distinct.insert(sample->get<std::string>());
+            if (distinct.size() > threshold) return std::nullopt;
+        }
+        if (samples.size() < 2 * distinct.size()) return std::nullopt;
+        return distinct;
+    }
+
+    std::string add(const std::string& key, const std::set<std::string>& values) {
+        static const std::set<std::string> builtinTypes = {
+            "Any", "Array", "Boolean", "Byte", "Char", "Class", "Data", "Date", "Double", "Duration", "Enum", "Error",
+            "Float", "Function", "Instant", "Int", "Json", "List", "Long", "Map", "Number", "Object", "Option", "Promise",
+            "Record", "Result", "Self", "Set", "Short", "String", "Symbol", "Type", "Value"
+        };
+        std::string base;
+        bool upper = true;
+        for (unsigned char c : key) {
+            if (!std::isalnum(c)) {
+                upper = true;
+                continue;
+            }
+            base += upper ? static_cast<char>(std::toupper(c)) : static_cast<char>(c);
+            upper = false;
+        }
+        if (base.empty() || std::isdigit(static_cast<unsigned char>(base[0]))) base = "Enum" + base;
+        if (builtinTypes.count(base)) base += "Enum";
+
+        json enumValues(values);
+        std::string name = base;
+        for (int n = 2; definitions.contains(name) && definitions[name]["enum"] != enumValues; ++n) {
+            name = base + std::to_string(n);
+        }
+        definitions[name] = { {"type", "string"}, {"enum", enumValues} };
+        return name;
+    }
+};
+
+static json inferSchemaFromSamples(const std::vector<const json*>& samples, InferredEnums& enums, const std::string& property = "");
+
+// Items split by the discriminator into one object schema per tag, in order of first appearance; the
+// discriminator itself becomes a const so every variant carries its tag
+static json inferUnionFromSamples(const std::vector<const json*>& items, const std::string& discriminator, InferredEnums& enums) {
+    std::vector<std::string> tags;
+    std::map<std::string, std::vector<const json*>> groups;
+    for (const json* item : items) {
+        std::string tag = (*item)[discriminator].get<std::string>();
+        if (!groups.count(tag)) tags.push_back(tag);
+        groups[tag].push_back(item);
+    }
+    json variants = json::array();
+    for (const auto& tag : tags) {
+        json knownEnums = enums.definitions;
+        json variant = inferSchemaFromSamples(groups[tag], enums);
+        // A repeated tag looks like a one-value enum; the const replaces it
+        const json& inferredTag = variant["properties"][discriminator];
+        if (inferredTag.contains("$ref")) {
+            std::string name = inferredTag["$ref"].get<std::string>().substr(std::string("#/definitions/").size());
+            if (!knownEnums.contains(name)) enums.definitions.erase(name);
+        }
+        variant["properties"][discriminator] = { {"type", "string"}, {"const", tag} };
+        variants.push_back(variant);
+    }
+    return { {"oneOf", variants}, {"discriminator", { {"propertyName", discriminator} }} };
+}
+
+// Schema for every value seen at one position: a property across all objects of an array, or the
+// items of all arrays there. Types and properties come from the first sample; numeric formats are
+// the narrowest that hold every sample, string properties get the format every sample matches, and
+// other low-cardinality string properties refer to an enum. Objects of several shapes with a tag
+// property become a discriminated oneOf
+static json inferSchemaFromSamples(const std::vector<const json*>& samples, InferredEnums& enums, const std::string& property) {
+    const json& first = *samples.front();
+    json schema;
+    if (first.is_null()) {
+        schema["type"] = "null";
+    }
+    else if (first.is_boolean()) {
+        schema["type"] = "boolean";
+    }
+    else if (first.is_number()) {
+        bool integral = true;
+        bool exactFloat = true;
+        double minimum = 0;
+        double maximum = 0;
+        bool seen = false;
+        for (const json* sample : samples) {
+            if (!sample->is_number()) continue;
+            double value = sample->get<double>();
+            integral = integral && !sample->is_number_float();
+            exactFloat = exactFloat && std::fabs(value) <= std::numeric_limits<float>::max() && static_cast<double>(static_cast<float>(value)) == value;
+            minimum = seen ? std::min(minimum, value) : value;
+            maximum = seen ? std::max(maximum, value) : value;
+            seen = true;
+        }
+        schema["type"] = integral ? "integer" : "number";
+        if (!integral) {
+            schema["format"] = exactFloat ? "float" : "double";
+        }
+        else {
+            schema["format"] = NumberFormat::forRange(minimum, maximum).name();
+        }
+    }
+    else if (first.is_string()) {
+        schema["type"] = "string";
+        std::optional<std::set<std::string>> categories;
+        StringFormat format = property.empty() ? StringFormat() : StringFormat::detect(samples);
+        if (format.kind != StringFormat::Kind::NONE) {
+            schema["format"] = format.name();
+        }
+        else if (!property.empty() && (categories = enums.categories(samples))) {
+            schema = { {"$ref", "#/definitions/" + enums.add(property, *categories)} };
+        }
+    }
+    else if (first.is_array()) {
+        schema["type"] = "array";
+        std::vector<const json*> items;
+        for (const json* sample : samples) {
+            if (!sample->is_array()) continue;
+            for (const auto& item : *sample) {
+                items.push_back(&item);
+            }
+        }
+        if (!items.empty()) {
+            std::string discriminator = TaggedUnion::detect(items);
+            schema["items"] = discriminator.empty() ? inferSchemaFromSamples(items, enums) : inferUnionFromSamples(items, discriminator, enums);
+        }
+    }
+    else if (first.is_object()) {
+        schema["type"] = "object";
+        schema["properties"] = json::object();
+        for (auto& [key, value] : first.items()) {
+            std::vector<const json*> values;
+            for (const json* sample : samples) {
+                if (sample->is_object() && sample->contains(key)) {
+                    values.push_back(&(*sample)[key]);
+                }
+            }
+            schema["properties"][key] = inferSchemaFromSamples(values, enums, key);
+        }
+    }
+    return schema;
+}
+
+json inferSchemaFromJson(const json& data, size_t enumThreshold) {
+    InferredEnums enums;
+    enums.threshold = enumThreshold;
+    json schema = inferSchemaFromSamples({ &data }, enums);
+    if (!enums.definitions.empty()) {
+        schema["definitions"] = enums.definitions;
+    }
+    return schema;
+}
+
+// Generators recurse through the virtual generateClass, so overriding it also times every nested class
+template <class Generator>
+class ProfiledGenerator : public Generator {
+public:
+    explicit ProfiledGenerator(Profiler& profiler) : profiler(profiler) {}
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        Profiler::Scope scope(&profiler, className, "class");
+        Generator::generateClass(className, data, schema, outFile, config, circHandler);
+    }
+
+private:
+    Profiler& profiler;
+};
+
+template <class Generator>
+static LanguageGenerator* makeGenerator(Profiler* profiler) {
+    if (profiler) return new ProfiledGenerator<Generator>(*profiler);
+    return new Generator();
+}
+
+LanguageGenerator* createLanguageGenerator(Language lang, Profiler* profiler) {
+    switch (lang) {
+    case Language::CPP: return makeGenerator<CppGenerator>(profiler);
+    case Language::CSHARP: return makeGenerator<CSharpGenerator>(profiler);
+    case Language::JAVA: return makeGenerator<JavaGenerator>(profiler);
+    case Language::PYTHON: return makeGenerator<PythonGenerator>(profiler);
+    case Language::GO: return makeGenerator<GoGenerator>(profiler);
+    case Language::TYPESCRIPT: return makeGenerator<TypeScriptGenerator>(profiler);
+    case Language::RUST: return makeGenerator<RustGenerator>(profiler);
+    case Language::SWIFT: return makeGenerator<SwiftGenerator>(profiler);
+    case Language::DART: return makeGenerator<DartGenerator>(profiler);
+    case Language::KOTLIN: return makeGenerator<KotlinGenerator>(profiler);
+    case Language::ELIXIR: return makeGenerator<ElixirGenerator>(profiler);
+    case Language::SCALA: return makeGenerator<ScalaGenerator>(profiler);
+    case Language::FLATBUFFERS: return makeGenerator<FlatBuffersGenerator>(profiler);
+    case Language::CAPNPROTO: return makeGenerator<CapnProtoGenerator>(profiler);
+    case Language::PROTOBUF: return makeGenerator<ProtobufGenerator>(profiler);
+    case Language::ARROW: return makeGenerator<ArrowGenerator>(profiler);
+    default: throw std::runtime_error("Unsupported language");
+    }
+}
+
+std::string languageToString(Language lang) {
+    switch (lang) {
+    case Language::CPP: return "C++";
+    case Language::CSHARP: return "C#";
+    case Language::JAVA: return "Java";
+    case Language::PYTHON: return "Python";
+    case Language::GO: return "Go";
+    case Language::TYPESCRIPT: return "TypeScript";
+    case Language::RUST: return "Rust";
+    case Language::SWIFT: return "Swift";
+    case Language::DART: return "Dart";
+    case Language::KOTLIN: return "Kotlin";
+    case Language::ELIXIR: return "Elixir";
+    case Language::SCALA: return "Scala";
+    case Language::FLATBUFFERS: return "FlatBuffers";
+    case Language::CAPNPROTO: return "Cap'n Proto";
+    case Language::PROTOBUF: return "Protocol Buffers";
+    case Language::ARROW: return "Apache Arrow";
+    default: return "Unknown";
+    }
+}
+
+Language stringToLanguage(const std::string& lang) {
+    std::string lowerLang = lang;
+    std::transform(lowerLang.begin(), lowerLang.end(), lowerLang.begin(), ::tolower);
+    if (lowerLang == "cpp") return Language::CPP;
+    if (lowerLang == "csharp") return Language::CSHARP;
+    if (lowerLang == "java") return Language::JAVA;
+    if (lowerLang == "python") return Language::PYTHON;
+    if (lowerLang == "go") return Language::GO;
+    if (lowerLang == "typescript") return Language::TYPESCRIPT;
+    if (lowerLang == "rust") return Language::RUST;
+    if (lowerLang == "swift") return Language::SWIFT;
+    if (lowerLang == "dart") return Language::DART;
+    if (lowerLang == "kotlin") return Language::KOTLIN;
+    if (lowerLang == "elixir") return Language::ELIXIR;
+    if (lowerLang == "scala") return Language::SCALA;
+    if (lowerLang == "flatbuffers") return Language::FLATBUFFERS;
+    if (lowerLang == "capnp") return Language::CAPNPROTO;
+    if (lowerLang == "proto") return Language::PROTOBUF;
+    if (lowerLang == "arrow") return Language::ARROW;
+    throw std::runtime_error("Unsupported language: " + lang);
+}
+
+InputFormat stringToInputFormat(const std::string& format) {
+    std::string lowerFormat = format;
+    std::transform(lowerFormat.begin(), lowerFormat.end(), lowerFormat.begin(), ::tolower);
+    if (lowerFormat == "auto") return InputFormat::AUTO;
+    if (lowerFormat == "json") return InputFormat::JSON;
+    if (lowerFormat == "cbor") return InputFormat::CBOR;
+    if (lowerFormat == "msgpack") return InputFormat::MSGPACK;
+    if (lowerFormat == "bson") return InputFormat::BSON;
+    if (lowerFormat == "ubjson") return InputFormat::UBJSON;
+    throw std::runtime_error("Unsupported input format: " + format);
+}
+
+// Binary encodings cannot be told apart reliably from their first bytes, so detection goes by extension
+InputFormat detectInputFormat(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) return InputFormat::JSON;
+    std::string extension = filename.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == "cbor") return InputFormat::CBOR;
+    if (extension == "msgpack" || extension == "mpk") return InputFormat::MSGPACK;
+    if (extension == "bson") return InputFormat::BSON;
+    if (extension == "ubj" || extension == "ubjson") return InputFormat::UBJSON;
+    return InputFormat::JSON;
+}
+
+std::string inputFormatToString(InputFormat format) {
+    switch (format) {
+    case InputFormat::AUTO: return "auto";
+    case InputFormat::JSON: return "JSON";
+    case InputFormat::CBOR: return "CBOR";
+    case InputFormat::MSGPACK: return "MessagePack";
+    case InputFormat::BSON: return "BSON";
+    case InputFormat::UBJSON: return "UBJSON";
+    default: return "Unknown";
+    }
+}
+
+std::string getFileExtension(Language lang) {
+    switch (lang) {
+    case Language::CPP: return "hpp";
+    case Language::CSHARP: return "cs";
+    case Language::JAVA: return "java";
+    case Language::PYTHON: return "py";
+    case Language::GO: return "go";
+    case Language::TYPESCRIPT: return "ts";
+    case Language::RUST: return "rs";
+    case Language::SWIFT: return "swift";
+    case Language::DART: return "dart";
+    case Language::KOTLIN: return "kt";
+    case Language::ELIXIR: return "ex";
+    case Language::SCALA: return "scala";
+    case Language::FLATBUFFERS: return "fbs";
+    case Language::CAPNPROTO: return "capnp";
+    case Language::PROTOBUF: return "proto";
+    case Language::ARROW: return "hpp";
+    default: return "txt";
+    }
 }
\ No newline at end of file
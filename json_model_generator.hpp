@@ -1,63 +1,300 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <map>
-#include <set>
-#include <fstream>
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
-
-enum class Language { CPP, CSHARP, JAVA, PYTHON, GO, TYPESCRIPT, RUST, SWIFT, DART, KOTLIN, ELIXIR, SCALA };
-
-struct Config {
-    std::string inputFile;
-    std::string schemaFile; // This will be optional now
-    std::string outputFile;
-    Language lang = Language::CPP;
-    bool generateDocs = false;
-    bool generateValidation = false;
-    bool useBuilderPattern = false;
-    bool generateImmutable = false;
-    int indentSize = 4;
-    std::string braceStyle = "same-line";
-    std::string customTypeMappingsFile;
-    bool showHelp = false;
-    bool verbose = false;
-    bool dryRun = false;
-    bool useSchema = false; // New flag to indicate whether to use schema
-};
-
-class CircularReferenceHandler {
-public:
-    void addDependency(const std::string& className, const std::string& dependsOn);
-    bool hasCyclicDependency(const std::string& className, std::set<std::string>& visited);
-    void resolveCircularReferences(std::ofstream& outFile, const Config& config, class LanguageGenerator* generator);
-
-private:
-    std::set<std::string> generatedClasses;
-    std::map<std::string, std::set<std::string>> dependencies;
-};
-
-class LanguageGenerator {
-public:
-    virtual ~LanguageGenerator() = default;
-    virtual void generateFileHeader(std::ofstream& outFile, const Config& config) = 0;
-    virtual void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) = 0;
-    virtual void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) = 0;
-    virtual void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) = 0;
-    virtual std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") = 0;
-};
-
-Config parseConfig(int argc, char* argv[]);
-void printUsage(const char* programName);
-json readJsonFromFile(const std::string& filename);
-json readSchemaFromFile(const std::string& filename);
-json inferSchemaFromJson(const json& data);
-LanguageGenerator* createLanguageGenerator(Language lang);
-Language stringToLanguage(const std::string& lang);
-std::string getFileExtension(Language lang);
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <optional>
+#include <initializer_list>
+#include <string_view>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+enum class Language { CPP, CSHARP, JAVA, PYTHON, GO, TYPESCRIPT, RUST, SWIFT, DART, KOTLIN, ELIXIR, SCALA, FLATBUFFERS, CAPNPROTO, PROTOBUF, ARROW };
+
+enum class InputFormat { AUTO, JSON, CBOR, MSGPACK, BSON, UBJSON };
+
+struct Config {
+    std::string inputFile;
+    InputFormat inputFormat = InputFormat::AUTO;
+    std::string schemaFile; // This will be optional now
+    std::string outputFile;
+    Language lang = Language::CPP;
+    bool generateDocs = false;
+    bool generateValidation = false;
+    bool useBuilderPattern = false;
+    bool generateImmutable = false;
+    int indentSize = 4;
+    std::string braceStyle = "same-line";
+    std::string customTypeMappingsFile;
+    bool showHelp = false;
+    bool verbose = false;
+    bool dryRun = false;
+    bool useSchema = false; // New flag to indicate whether to use schema
+    bool generateColumns = false; // Emit Structure-of-Arrays containers for arrays of objects
+    bool lazyDecoding = false; // Decode fields on first access from the retained input buffer
+    bool generateBinaryCodecs = false; // Emit direct MessagePack/CBOR encoders and decoders
+    bool staticCodecs = false; // Emit reflection-free serialization code instead of relying on runtime reflection
+    std::string pythonStyle = "pydantic"; // pydantic, dataclass, msgspec or msgspec-array
+    bool valueTypes = false; // Emit small value-like types as structs/value classes instead of heap objects
+    bool typedArrays = false; // Emit packed primitive arrays for arrays whose items are all numbers
+    bool borrowStrings = false; // Emit string fields that borrow from the input buffer instead of owning a copy
+    std::string validateFile; // NDJSON file to check against the schema instead of generating code
+    unsigned threads = 0; // Worker threads for --validate; 0 uses every hardware thread
+    bool wideNumbers = false; // Ignore inferred numeric formats and emit 64-bit integers and doubles
+    size_t enumThreshold = 0; // Inferred string fields with at most this many distinct values become enums; 0 disables
+    bool plainStrings = false; // Ignore string formats and keep UUID, timestamp and base64 fields as strings
+    bool stringFormats = false; // Set from the schema before generation: some field has a string format
+    bool plainUnions = false; // Model arrays of tagged objects by their first item instead of as tagged unions
+    bool taggedUnions = false; // Set from the schema before generation: some array holds a tagged union
+    bool stringPatterns = false; // Set from the document before generation: validation checks some string pattern
+    bool stringLengths = false; // Set from the document before generation: validation checks some string length
+    bool profile = false; // Time each phase and class; summary to stderr, trace to <output>.trace.json
+};
+
+class CircularReferenceHandler {
+public:
+    void addDependency(const std::string& className, const std::string& dependsOn);
+    bool hasCyclicDependency(const std::string& className, std::set<std::string>& visited);
+    void resolveCircularReferences(std::ofstream& outFile, const Config& config, class LanguageGenerator* generator);
+
+private:
+    std::set<std::string> generatedClasses;
+    std::map<std::string, std::set<std::string>> dependencies;
+};
+
+// Wall and CPU time, allocations and peak RSS of the phases of one run and of every generateClass call,
+// for --profile. Spans nest like the calls they measure and are written as a summary table and as a
+// Chrome trace-event file that Perfetto and chrome://tracing load. Allocations are counted only in builds
+// with JSON_MODEL_GENERATOR_COUNT_ALLOCATIONS, which replaces the global operator new.
+class Profiler {
+public:
+    // Measures its own lifetime; does nothing without a profiler, so call sites need no checks
+    class Scope {
+    public:
+        Scope(Profiler* profiler, const std::string& name, const char* category = "phase");
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Profiler* profiler;
+        size_t index = 0;
+    };
+
+    Profiler();
+    void writeSummary(std::ostream& out) const;
+    void writeTrace(const std::string& filename) const;
+    static bool countsAllocations();
+
+private:
+    struct Span {
+        std::string name;
+        const char* category;
+        int depth;
+        double startUs;
+        double wallUs = 0;
+        double cpuUs = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t peakRssKb = 0;
+        // Totals of the spans directly inside this one, for self times
+        double childWallUs = 0;
+        double childCpuUs = 0;
+        uint64_t childAllocations = 0;
+        uint64_t childAllocatedBytes = 0;
+    };
+
+    std::vector<Span> spans;
+    std::vector<size_t> open;
+    double originUs;
+    double originCpuUs;
+};
+
+// Persists the field numbers assigned by schema generators (FlatBuffers, Cap'n Proto, Protobuf) in a sidecar
+// file, so a field keeps its number across runs and removed fields keep their slot.
+class FieldIdRegistry {
+public:
+    struct Field {
+        int id;
+        std::string name;
+        std::string type;
+        bool retired = false; // Replaced by a field of the same name with a different type
+    };
+
+    void load(const std::string& filename);
+    void save() const;
+    int assign(const std::string& typeName, const std::string& fieldName, const std::string& fieldType, int firstId = 0);
+    std::vector<Field> fields(const std::string& typeName) const;
+
+private:
+    std::string filename;
+    json ids = json::object();
+};
+
+// Validation keywords of one schema property, which generators compile into straight-line isValid checks
+struct FieldConstraints {
+    bool required = false;
+    std::optional<double> minimum;
+    std::optional<double> maximum;
+    std::optional<size_t> minLength;
+    std::optional<size_t> maxLength;
+    std::optional<std::string> pattern;
+    std::vector<json> enumValues;
+    std::optional<size_t> minItems;
+    std::optional<size_t> maxItems;
+
+    static FieldConstraints read(const json& schema, const std::string& key);
+    // Enum values with the JSON type of the sample value; others can never equal the generated field
+    std::vector<json> enumValuesLike(const json& value) const;
+    // Literal for a numeric bound; integral fields get the nearest integer inside the bound
+    static std::string boundLiteral(double bound, bool integral, bool lower);
+    // Whether a string field of the document, at any depth, has one of the keywords and no string format;
+    // walks the classes the generators emit, so languages that reject unused imports can import exactly
+    static bool usedBy(const json& schema, const json& data, std::initializer_list<const char*> keywords, const Config& config);
+};
+
+// Width of a numeric field, or of the elements of an array of numbers: the schema's "format" (int8 ... int64,
+// uint8 ... uint64, float, double), or for integers the narrowest type holding minimum..maximum. A field the
+// schema says nothing about is 64 bits, and a float when the schema type is "number" or the sample has a
+// fraction; --wide-numbers reads every field as 64 bits
+struct NumberFormat {
+    int bits = 0;
+    bool isUnsigned = false;
+    bool isFloat = false;
+
+    // A number, or a non-empty array whose first item is a number
+    static bool isNumeric(const json& value);
+    static NumberFormat read(const json& schema, const std::string& key, const json& value, const Config& config);
+    // Formats of the numeric fields of one class, by key
+    static std::map<std::string, NumberFormat> readAll(const json& schema, const json& data, const Config& config);
+    // Turns integer samples into floats wherever the schema types them "number", so generators that look at
+    // the sample agree with the schema about [1, 2.5]
+    static void conform(json& data, const json& schema);
+    static NumberFormat parse(const std::string& format);
+    // Narrowest integer format holding [minimum, maximum]; unsigned when minimum is not negative
+    static NumberFormat forRange(double minimum, double maximum);
+    // The format itself, or for unsigned formats the next wider signed one that the JVM languages declare
+    NumberFormat asSigned() const;
+    // Whether every value of the integer type lies at or above (lower) or at or below the bound, so that a
+    // validation check against it could never fail
+    bool implies(double bound, bool lower) const;
+    std::string name() const;
+};
+
+// Compact representation of a string field: the schema's "format" (uuid, date-time, byte) or a base64
+// "contentEncoding". kind is NONE when the schema says nothing, and generators keep their string type;
+// --plain-strings reads every field as NONE. The wire form stays a JSON string either way
+struct StringFormat {
+    enum class Kind { NONE, UUID, DATE_TIME, BYTES };
+
+    Kind kind = Kind::NONE;
+
+    static StringFormat read(const json& schema, const std::string& key, const json& value, const Config& config);
+    // Formats of the string fields of one class that have one, by key
+    static std::map<std::string, StringFormat> readAll(const json& schema, const json& data, const Config& config);
+    // Whether any string property of the schema, at any depth, has a format; generators that need a
+    // runtime or imports for the compact types emit them only then
+    static bool usedBy(const json& schema, const Config& config);
+    // Format that every string sample matches, for inference; base64 needs enough evidence to tell it
+    // from words and hex digests
+    static StringFormat detect(const std::vector<const json*>& samples);
+    // RFC 9562 textual UUID, in either case
+    static bool isUuid(std::string_view text);
+    // RFC 3339 date-time with an upper-case T and Z or a numeric offset, as every generated parser accepts it
+    static bool isDateTime(std::string_view text);
+    // Padded standard base64 whose unused trailing bits are zero, so re-encoding yields the same text
+    static bool isBase64(std::string_view text);
+    std::string name() const;
+};
+
+// Items of an array field that are objects of several shapes told apart by one string property: a "oneOf"
+// with an OpenAPI "discriminator", as inference writes it for mixed arrays. Each variant's tag is the "const"
+// (or single "enum" value) of that property; inlineVariants turns "$ref" variants and the discriminator's
+// "mapping" into that form. Generators declare one type per variant that occurs in the sample, built from
+// the first item carrying its tag, and decode an item by reading the tag before anything else
+struct TaggedUnion {
+    struct Variant {
+        std::string tag;
+        // Identifier for the tag, unique within the union: "page_view" -> "PageView"
+        std::string name;
+        const json* schema = nullptr;
+        const json* sample = nullptr;
+    };
+
+    std::string property;
+    std::vector<Variant> variants;
+
+    // Union of the items of an array field with the variants present in the sampled array; nothing when
+    // the items are not a discriminated oneOf or with --plain-unions
+    static std::optional<TaggedUnion> read(const json& schema, const std::string& key, const json& value, const Config& config);
+    // Schema for one item of a union, for code that models a single item shape: the variant the item's
+    // tag selects, or the items schema itself when it is not a union
+    static const json& variantSchema(const json& itemSchema, const json& item);
+    // Whether any array of the schema, at any depth, has union items; generators that need imports or
+    // a runtime for unions emit them only then
+    static bool usedBy(const json& schema, const Config& config);
+    // Replaces "$ref" variants of every discriminated oneOf in a schema file by the definitions they
+    // name, tagged from the discriminator's "mapping" or else by the definition name
+    static void inlineVariants(json& schema);
+    // Property named by the discriminator of a oneOf, or null when the schema is not a discriminated oneOf
+    static const std::string* discriminatorOf(const json& schema);
+    // Tag a variant fixes for the property with a "const" or a one-value "enum"
+    static std::optional<std::string> tagOf(const json& variant, const std::string& property);
+    // Discriminator property for inference: a string property of every item whose values split the
+    // items into differently shaped groups; empty when there is none
+    static std::string detect(const std::vector<const json*>& items);
+};
+
+// String enum in "definitions", which properties refer to through a local "$ref". Generators declare it in
+// generateEnums and use it as the type of every string field that refers to it
+struct EnumDefinition {
+    enum class Style { PASCAL, CAMEL, UPPER_SNAKE };
+
+    std::string name;
+    std::vector<std::string> values;
+
+    // Definitions whose values are all strings, by name
+    static std::map<std::string, EnumDefinition> readAll(const json& schema);
+    // Names of the enums among `enums` that the string fields of one class refer to, by key
+    static std::map<std::string, std::string> references(const json& schema, const json& data, const std::map<std::string, EnumDefinition>& enums);
+    // Identifiers for the values in the given style; unique within the enum, starting with a letter and
+    // clear of the keywords and enum members of the target languages
+    std::vector<std::string> caseNames(Style style) const;
+};
+
+class LanguageGenerator {
+public:
+    virtual ~LanguageGenerator() = default;
+    virtual void generateFileHeader(std::ofstream& outFile, const Config& config) = 0;
+    virtual void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) = 0;
+    virtual void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) = 0;
+    virtual void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) = 0;
+    virtual std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") = 0;
+};
+
+Config parseConfig(int argc, char* argv[]);
+void printUsage(const char* programName);
+json readJsonFromFile(const std::string& filename, InputFormat format = InputFormat::AUTO);
+json readSchemaFromFile(const std::string& filename);
+json inferSchemaFromJson(const json& data, size_t enumThreshold = 0);
+// Schema of a property, or an empty object when the schema has none. Both return references into the
+// schema, so generators recursing into nested properties never copy a subtree
+const json& propertySchema(const json& schema, const std::string& key);
+// Schema of the class generated for an object field or for the objects of a (nested) array field: for
+// union items the variant the sample object selects
+const json& nestedSchema(const json& schema, const std::string& key, const json& sample);
+// Checks every record of config.validateFile against the schema; returns 0 when all records are valid
+int runValidation(const Config& config);
+// With a profiler, every generateClass call of the generator, nested ones included, is a span
+LanguageGenerator* createLanguageGenerator(Language lang, Profiler* profiler = nullptr);
+Language stringToLanguage(const std::string& lang);
+InputFormat stringToInputFormat(const std::string& format);
+InputFormat detectInputFormat(const std::string& filename);
+std::string inputFormatToString(InputFormat format);
+std::string getFileExtension(Language lang);
 std::string languageToString(Language lang);
\ No newline at end of file
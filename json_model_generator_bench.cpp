@@ -0,0 +1,272 @@
+#include "json_model_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+
+// Benchmarks for parsing, schema inference and every generator's generateClass over synthetic inputs of
+// varying width, depth and array length. A run saved as JSON can be checked against a baseline:
+//
+//   json_model_generator_bench --benchmark_out=current.json --benchmark_out_format=json
+//   json_model_generator_bench --compare bench_baseline.json current.json --threshold 10
+//
+// --compare prints every benchmark's change in CPU time and exits with 2 when any is slower than the
+// baseline by more than the threshold (in percent, default 10).
+
+namespace {
+
+const char* const languageNames[] = {
+    "cpp", "csharp", "java", "python", "go", "typescript", "rust", "swift", "dart", "kotlin", "elixir", "scala",
+    "flatbuffers", "capnp", "proto", "arrow"
+};
+
+struct Input {
+    std::string name;
+    json data;
+    std::string text;
+    json schema;
+};
+
+// Discards the generated code but counts it, so generator timings include no file I/O
+class CountingBuffer : public std::streambuf {
+public:
+    size_t count = 0;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            ++count;
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        count += static_cast<size_t>(n);
+        return n;
+    }
+};
+
+// Scalars of every inferred kind, chosen by position so the inputs are the same on every run
+json scalar(size_t i) {
+    switch (i % 4) {
+    case 0: return static_cast<int64_t>(i * 7919 % 100000);
+    case 1: return static_cast<double>(i) * 0.25 + 0.5;
+    case 2: return "value " + std::to_string(i);
+    default: return i % 8 == 3;
+    }
+}
+
+// One object with width keys; every eighth key holds a small object and every eighth an array of numbers
+json wideObject(size_t width) {
+    json data = json::object();
+    for (size_t i = 0; i < width; ++i) {
+        std::string key = "field" + std::to_string(i);
+        if (i % 8 == 5) {
+            data[key] = { {"id", i}, {"name", "nested " + std::to_string(i)} };
+        }
+        else if (i % 8 == 6) {
+            data[key] = { i, i + 1, i + 2 };
+        }
+        else {
+            data[key] = scalar(i);
+        }
+    }
+    return data;
+}
+
+// Objects nested depth levels deep through a "child" property
+json deepObject(size_t depth) {
+    json data = { {"id", depth}, {"name", "leaf"} };
+    for (size_t level = depth; level-- > 1;) {
+        data = { {"id", level}, {"name", "level " + std::to_string(level)}, {"score", level * 0.5}, {"child", std::move(data)} };
+    }
+    return data;
+}
+
+// An array of length records, the shape of a typical event or row export
+json arrayObject(size_t length) {
+    json items = json::array();
+    for (size_t i = 0; i < length; ++i) {
+        items.push_back({
+            {"id", i},
+            {"name", "item " + std::to_string(i)},
+            {"score", i * 0.5},
+            {"active", i % 2 == 0},
+            {"tags", {"a", "b"}},
+            {"position", { {"x", i % 640}, {"y", i % 480} }},
+        });
+    }
+    return { {"count", length}, {"items", std::move(items)} };
+}
+
+// Inputs live for the whole run; benchmarks refer to them by address
+const std::deque<Input>& inputs() {
+    static const std::deque<Input> all = [] {
+        std::deque<Input> result;
+        auto add = [&](const std::string& name, json data) {
+            json schema = inferSchemaFromJson(data);
+            NumberFormat::conform(data, schema);
+            std::string text = data.dump();
+            result.push_back({ name, std::move(data), std::move(text), std::move(schema) });
+        };
+        for (size_t width : { 16, 256, 4096 }) add("wide/" + std::to_string(width), wideObject(width));
+        for (size_t depth : { 4, 32, 128 }) add("deep/" + std::to_string(depth), deepObject(depth));
+        for (size_t length : { 16, 1024, 16384 }) add("array/" + std::to_string(length), arrayObject(length));
+        return result;
+    }();
+    return all;
+}
+
+void parse(benchmark::State& state, const Input* input) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::parse(input->text));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input->text.size()));
+}
+
+void inferSchema(benchmark::State& state, const Input* input) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(inferSchemaFromJson(input->data));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input->text.size()));
+}
+
+// Generators keep per-class state, so each iteration gets a fresh one with its header and enums written
+// outside the timed region. The schema outputs save their field-id sidecar file from generateClass; it is
+// removed first so every iteration assigns the same ids from scratch
+void generateClass(benchmark::State& state, Language lang, const Input* input, const std::string& outputFile) {
+    Config config;
+    config.lang = lang;
+    config.outputFile = outputFile;
+    config.stringFormats = StringFormat::usedBy(input->schema, config);
+    config.taggedUnions = TaggedUnion::usedBy(input->schema, config);
+    CountingBuffer buffer;
+    size_t classBytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::remove(outputFile + ".ids.json");
+        std::unique_ptr<LanguageGenerator> generator(createLanguageGenerator(lang));
+        CircularReferenceHandler circHandler;
+        std::ofstream outFile;
+        outFile.std::ios::rdbuf(&buffer);
+        generator->generateFileHeader(outFile, config);
+        generator->generateEnums(input->schema, outFile, config);
+        size_t start = buffer.count;
+        state.ResumeTiming();
+
+        generator->generateClass("RootModel", input->data, input->schema, outFile, config, circHandler);
+        classBytes = buffer.count - start;
+    }
+    state.counters["output_bytes"] = static_cast<double>(classBytes);
+}
+
+void registerBenchmarks() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "json_model_generator_bench";
+    std::filesystem::create_directories(directory);
+    for (const Input& input : inputs()) {
+        benchmark::RegisterBenchmark(("parse/" + input.name).c_str(), parse, &input);
+        benchmark::RegisterBenchmark(("infer/" + input.name).c_str(), inferSchema, &input);
+    }
+    for (const char* name : languageNames) {
+        Language lang = stringToLanguage(name);
+        for (const Input& input : inputs()) {
+            std::string benchmarkName = "generate/" + std::string(name) + "/" + input.name;
+            std::string outputFile = (directory / benchmarkName.substr(9)).string();
+            std::filesystem::create_directories(std::filesystem::path(outputFile).parent_path());
+            benchmark::RegisterBenchmark(benchmarkName.c_str(), generateClass, lang, &input, outputFile);
+        }
+    }
+}
+
+// CPU time in nanoseconds per benchmark name, taking the median when the run has repetitions
+std::map<std::string, double> readRun(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    json run = json::parse(file);
+    if (!run.contains("benchmarks")) {
+        throw std::runtime_error(filename + " is not a google-benchmark JSON report");
+    }
+    static const std::map<std::string, double> unitScale = { {"ns", 1.0}, {"us", 1e3}, {"ms", 1e6}, {"s", 1e9} };
+    std::map<std::string, double> times;
+    std::set<std::string> medians;
+    for (const auto& entry : run["benchmarks"]) {
+        if (entry.value("error_occurred", false)) continue;
+        bool median = entry.value("run_type", "") == "aggregate";
+        if (median && entry.value("aggregate_name", "") != "median") continue;
+        std::string name = entry.value("run_name", entry.value("name", ""));
+        if (!median && medians.count(name)) continue;
+        auto scale = unitScale.find(entry.value("time_unit", "ns"));
+        times[name] = entry["cpu_time"].get<double>() * (scale != unitScale.end() ? scale->second : 1.0);
+        if (median) medians.insert(name);
+    }
+    return times;
+}
+
+int compareRuns(const std::string& baselineFile, const std::string& currentFile, double threshold) {
+    std::map<std::string, double> baseline = readRun(baselineFile);
+    std::map<std::string, double> current = readRun(currentFile);
+    size_t width = 9;
+    for (const auto& [name, time] : current) {
+        width = std::max(width, name.size());
+    }
+
+    std::cout << std::left << std::setw(static_cast<int>(width)) << "benchmark" << std::right
+        << std::setw(16) << "baseline ns" << std::setw(16) << "current ns" << std::setw(10) << "change" << "\n";
+    size_t regressions = 0;
+    for (const auto& [name, time] : current) {
+        auto base = baseline.find(name);
+        std::cout << std::left << std::setw(static_cast<int>(width)) << name << std::right << std::fixed << std::setprecision(0);
+        if (base == baseline.end() || base->second <= 0) {
+            std::cout << std::setw(16) << "-" << std::setw(16) << time << std::setw(10) << "new" << "\n";
+            continue;
+        }
+        double change = (time - base->second) / base->second * 100.0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        std::cout << std::setw(16) << base->second << std::setw(16) << time << std::setw(9) << std::showpos << std::setprecision(1) << change << "%"
+            << std::noshowpos << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    for (const auto& [name, time] : baseline) {
+        if (!current.count(name)) {
+            std::cout << std::left << std::setw(static_cast<int>(width)) << name << std::right << "  missing from " << currentFile << "\n";
+        }
+    }
+    std::cerr << regressions << " of " << current.size() << " benchmarks slower than the baseline by more than " << threshold << "%" << std::endl;
+    return regressions == 0 ? 0 : 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--compare") == 0) {
+        try {
+            if (argc < 4) {
+                throw std::runtime_error("usage: " + std::string(argv[0]) + " --compare <baseline.json> <current.json> [--threshold <percent>]");
+            }
+            double threshold = 10.0;
+            if (argc > 5 && std::strcmp(argv[4], "--threshold") == 0) {
+                threshold = std::stod(argv[5]);
+            }
+            return compareRuns(argv[2], argv[3], threshold);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    registerBenchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,611 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes synthetic inputs for benchmarking and stress-testing the generator. The same shape, size, record
+// count and seed always give the same bytes: values come from a splitmix64 sequence rather than <random>,
+// whose distributions differ between standard libraries. Output is streamed through a fixed buffer and
+// only the open containers are tracked, so files far larger than memory can be produced.
+
+namespace {
+
+enum class Shape { WIDE, DEEP, ARRAY, MIXED, DUPLICATE };
+enum class Format { JSON, NDJSON, CBOR };
+
+struct Options {
+    Shape shape = Shape::ARRAY;
+    Format format = Format::JSON;
+    uint64_t size = 1000;
+    uint64_t records = 1;
+    uint64_t seed = 1;
+    std::string outputFile;
+    bool showHelp = false;
+};
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // The small modulo bias does not matter for test data
+    uint64_t below(uint64_t bound) {
+        return next() % bound;
+    }
+
+private:
+    uint64_t state;
+};
+
+// Event sinks for one encoding. Containers are declared with their size, which every shape knows up
+// front, so CBOR can use definite lengths and be read back by nlohmann::json::from_cbor
+class Writer {
+public:
+    explicit Writer(std::ostream& out) : out(out) {
+        buffer.reserve(bufferSize);
+    }
+    virtual ~Writer() = default;
+
+    virtual void beginObject(uint64_t size) = 0;
+    virtual void endObject() = 0;
+    virtual void beginArray(uint64_t size) = 0;
+    virtual void endArray() = 0;
+    virtual void key(std::string_view name) = 0;
+    virtual void integer(int64_t value) = 0;
+    // Fixed-point values with two decimals, so JSON text and CBOR doubles decode to the same number
+    virtual void decimal(int64_t hundredths) = 0;
+    virtual void string(std::string_view value) = 0;
+    virtual void boolean(bool value) = 0;
+    virtual void null() = 0;
+    virtual void endRecord() {}
+
+    void flush() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        if (!out) {
+            throw std::runtime_error("Unable to write output");
+        }
+    }
+
+protected:
+    static constexpr size_t bufferSize = 1 << 20;
+    std::string buffer;
+
+    void put(std::string_view bytes) {
+        buffer.append(bytes.data(), bytes.size());
+        if (buffer.size() >= bufferSize) {
+            flush();
+        }
+    }
+
+    void put(char c) {
+        buffer.push_back(c);
+        if (buffer.size() >= bufferSize) {
+            flush();
+        }
+    }
+
+private:
+    std::ostream& out;
+};
+
+class JsonWriter : public Writer {
+public:
+    JsonWriter(std::ostream& out, bool lines) : Writer(out), lines(lines) {}
+
+    void beginObject(uint64_t) override {
+        beginValue();
+        put('{');
+        first.push_back(true);
+    }
+
+    void endObject() override {
+        first.pop_back();
+        put('}');
+    }
+
+    void beginArray(uint64_t) override {
+        beginValue();
+        put('[');
+        first.push_back(true);
+    }
+
+    void endArray() override {
+        first.pop_back();
+        put(']');
+    }
+
+    void key(std::string_view name) override {
+        beginValue();
+        quoted(name);
+        put(':');
+        afterKey = true;
+    }
+
+    void integer(int64_t value) override {
+        beginValue();
+        put(std::to_string(value));
+    }
+
+    void decimal(int64_t hundredths) override {
+        beginValue();
+        if (hundredths < 0) {
+            put('-');
+            hundredths = -hundredths;
+        }
+        std::string fraction = std::to_string(hundredths % 100);
+        put(std::to_string(hundredths / 100) + (fraction.size() == 1 ? ".0" : ".") + fraction);
+    }
+
+    void string(std::string_view value) override {
+        beginValue();
+        quoted(value);
+    }
+
+    void boolean(bool value) override {
+        beginValue();
+        put(value ? "true" : "false");
+    }
+
+    void null() override {
+        beginValue();
+        put("null");
+    }
+
+    void endRecord() override {
+        if (lines) {
+            put('\n');
+        }
+    }
+
+private:
+    bool lines;
+    bool afterKey = false;
+    // Whether each open container is still empty; NDJSON records are written at the top level
+    std::vector<bool> first;
+
+    void beginValue() {
+        if (afterKey) {
+            afterKey = false;
+            return;
+        }
+        if (!first.empty()) {
+            if (!first.back()) put(',');
+            first.back() = false;
+        }
+    }
+
+    // Generated strings are ASCII, so only quotes, backslashes and control characters need escaping
+    void quoted(std::string_view value) {
+        put('"');
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                static const char digits[] = "0123456789abcdef";
+                put("\\u00");
+                put(digits[(c >> 4) & 0xf]);
+                put(digits[c & 0xf]);
+            }
+            else {
+                put(c);
+            }
+        }
+        put('"');
+    }
+};
+
+class CborWriter : public Writer {
+public:
+    using Writer::Writer;
+
+    void beginObject(uint64_t size) override { head(5, size); }
+    void endObject() override {}
+    void beginArray(uint64_t size) override { head(4, size); }
+    void endArray() override {}
+    void key(std::string_view name) override { string(name); }
+
+    void integer(int64_t value) override {
+        if (value < 0) {
+            head(1, static_cast<uint64_t>(-(value + 1)));
+        }
+        else {
+            head(0, static_cast<uint64_t>(value));
+        }
+    }
+
+    void decimal(int64_t hundredths) override {
+        double value = static_cast<double>(hundredths) / 100.0;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        put(static_cast<char>(0xfb));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            put(static_cast<char>((bits >> shift) & 0xff));
+        }
+    }
+
+    void string(std::string_view value) override {
+        head(3, value.size());
+        put(value);
+    }
+
+    void boolean(bool value) override { put(static_cast<char>(value ? 0xf5 : 0xf4)); }
+    void null() override { put(static_cast<char>(0xf6)); }
+
+private:
+    // Initial byte and big-endian argument in the shortest form
+    void head(unsigned major, uint64_t argument) {
+        uint64_t type = major << 5;
+        if (argument < 24) {
+            put(static_cast<char>(type | argument));
+            return;
+        }
+        int bytes = argument <= 0xff ? 1 : argument <= 0xffff ? 2 : argument <= 0xffffffffull ? 4 : 8;
+        put(static_cast<char>(type | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27)));
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            put(static_cast<char>((argument >> shift) & 0xff));
+        }
+    }
+};
+
+const char* const words[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel", "india", "juliet", "kilo", "lima",
+    "mike", "november", "oscar", "papa", "quebec", "romeo", "sierra", "tango", "uniform", "victor", "whiskey", "xray"
+};
+
+std::string word(Random& random) {
+    return words[random.below(sizeof(words) / sizeof(words[0]))];
+}
+
+// RFC 3339 UTC timestamp for seconds since 2020-01-01, using the days-from-civil inverse so no time zone
+// database is involved
+std::string timestamp(uint64_t seconds) {
+    int64_t days = static_cast<int64_t>(seconds / 86400) + 18262;
+    uint64_t secondOfDay = seconds % 86400;
+    days += 719468;
+    int64_t era = days / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    int64_t day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    int64_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int64_t year = yearOfEra + era * 400 + (month <= 2);
+    char text[64];
+    std::snprintf(text, sizeof text, "%04lld-%02lld-%02lldT%02llu:%02llu:%02lluZ", static_cast<long long>(year), static_cast<long long>(month),
+        static_cast<long long>(day), static_cast<unsigned long long>(secondOfDay / 3600), static_cast<unsigned long long>(secondOfDay / 60 % 60),
+        static_cast<unsigned long long>(secondOfDay % 60));
+    return text;
+}
+
+std::string uuid(Random& random) {
+    static const char digits[] = "0123456789abcdef";
+    uint64_t high = random.next();
+    uint64_t low = random.next();
+    std::string text;
+    for (int i = 0; i < 32; ++i) {
+        if (i == 8 || i == 12 || i == 16 || i == 20) text += '-';
+        uint64_t half = i < 16 ? high : low;
+        text += digits[(half >> ((15 - i % 16) * 4)) & 0xf];
+    }
+    // Version 4, variant 10
+    text[14] = '4';
+    text[19] = digits[8 + (text[19] % 4)];
+    return text;
+}
+
+void randomScalar(Writer& writer, Random& random) {
+    switch (random.below(5)) {
+    case 0: writer.integer(static_cast<int64_t>(random.below(2000000)) - 1000000); break;
+    case 1: writer.decimal(static_cast<int64_t>(random.below(10000000))); break;
+    case 2: writer.string(word(random) + " " + std::to_string(random.below(1000))); break;
+    case 3: writer.boolean(random.below(2) == 1); break;
+    default: writer.integer(static_cast<int64_t>(random.below(100))); break;
+    }
+}
+
+// size keys with random scalars
+void writeWide(Writer& writer, Random& random, uint64_t size) {
+    writer.beginObject(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        writer.key("field" + std::to_string(i));
+        randomScalar(writer, random);
+    }
+    writer.endObject();
+}
+
+// size objects nested through "child"; written on the way down and closed on the way back, without recursion
+void writeDeep(Writer& writer, Random& random, uint64_t size) {
+    if (size == 0) {
+        writer.beginObject(0);
+        writer.endObject();
+        return;
+    }
+    for (uint64_t level = 0; level < size; ++level) {
+        bool leaf = level + 1 == size;
+        writer.beginObject(leaf ? 2 : 3);
+        writer.key("level");
+        writer.integer(static_cast<int64_t>(level));
+        writer.key("name");
+        writer.string(word(random));
+        if (!leaf) {
+            writer.key("child");
+        }
+    }
+    for (uint64_t level = 0; level < size; ++level) {
+        writer.endObject();
+    }
+}
+
+// An array of size records of one shape
+void writeArray(Writer& writer, Random& random, uint64_t size) {
+    writer.beginObject(2);
+    writer.key("count");
+    writer.integer(static_cast<int64_t>(size));
+    writer.key("items");
+    writer.beginArray(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        writer.beginObject(5);
+        writer.key("id");
+        writer.integer(static_cast<int64_t>(i));
+        writer.key("name");
+        writer.string(word(random) + " " + std::to_string(i));
+        writer.key("score");
+        writer.decimal(static_cast<int64_t>(random.below(100000)));
+        writer.key("active");
+        writer.boolean(random.below(2) == 1);
+        writer.key("tags");
+        uint64_t tags = random.below(4);
+        writer.beginArray(tags);
+        for (uint64_t t = 0; t < tags; ++t) {
+            writer.string(word(random));
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+// An array of size events tagged by "type" with a different shape per tag, timestamps, UUIDs, nulls and
+// optional fields, the kind of input that exercises union, format and enum inference
+void writeMixed(Writer& writer, Random& random, uint64_t size) {
+    writer.beginObject(2);
+    writer.key("stream");
+    writer.string(uuid(random));
+    writer.key("events");
+    writer.beginArray(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        uint64_t kind = random.below(4);
+        std::string ts = timestamp(i * 7 + random.below(7));
+        switch (kind) {
+        case 0:
+            writer.beginObject(5);
+            writer.key("type");
+            writer.string("click");
+            writer.key("ts");
+            writer.string(ts);
+            writer.key("x");
+            writer.integer(static_cast<int64_t>(random.below(1920)));
+            writer.key("y");
+            writer.integer(static_cast<int64_t>(random.below(1080)));
+            writer.key("button");
+            writer.string(random.below(4) == 0 ? "right" : "left");
+            break;
+        case 1: {
+            bool referred = random.below(3) != 0;
+            writer.beginObject(4);
+            writer.key("type");
+            writer.string("page_view");
+            writer.key("ts");
+            writer.string(ts);
+            writer.key("url");
+            writer.string("https://example.test/" + word(random));
+            writer.key("referrer");
+            if (referred) {
+                writer.string("https://example.test/" + word(random));
+            }
+            else {
+                writer.null();
+            }
+            break;
+        }
+        case 2:
+            writer.beginObject(3);
+            writer.key("type");
+            writer.string("scroll");
+            writer.key("ts");
+            writer.string(ts);
+            writer.key("depth");
+            writer.decimal(static_cast<int64_t>(random.below(101)));
+            break;
+        default: {
+            uint64_t lines = 1 + random.below(3);
+            writer.beginObject(5);
+            writer.key("type");
+            writer.string("purchase");
+            writer.key("ts");
+            writer.string(ts);
+            writer.key("order");
+            writer.string(uuid(random));
+            writer.key("total");
+            writer.decimal(static_cast<int64_t>(random.below(1000000)));
+            writer.key("lines");
+            writer.beginArray(lines);
+            for (uint64_t line = 0; line < lines; ++line) {
+                writer.beginObject(2);
+                writer.key("sku");
+                writer.string(word(random) + "-" + std::to_string(random.below(100)));
+                writer.key("quantity");
+                writer.integer(static_cast<int64_t>(1 + random.below(5)));
+                writer.endObject();
+            }
+            writer.endArray();
+            break;
+        }
+        }
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+// size keys that all hold objects of the same shape, so a generator meets one nested shape many times
+void writeDuplicate(Writer& writer, Random& random, uint64_t size) {
+    writer.beginObject(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        writer.key("user" + std::to_string(i));
+        writer.beginObject(4);
+        writer.key("id");
+        writer.integer(static_cast<int64_t>(i));
+        writer.key("name");
+        writer.string(word(random));
+        writer.key("email");
+        writer.string(word(random) + std::to_string(i) + "@example.test");
+        writer.key("active");
+        writer.boolean(random.below(2) == 1);
+        writer.endObject();
+    }
+    writer.endObject();
+}
+
+void writeRecord(Writer& writer, Random& random, const Options& options) {
+    switch (options.shape) {
+    case Shape::WIDE: writeWide(writer, random, options.size); break;
+    case Shape::DEEP: writeDeep(writer, random, options.size); break;
+    case Shape::ARRAY: writeArray(writer, random, options.size); break;
+    case Shape::MIXED: writeMixed(writer, random, options.size); break;
+    case Shape::DUPLICATE: writeDuplicate(writer, random, options.size); break;
+    }
+}
+
+Shape stringToShape(const std::string& shape) {
+    if (shape == "wide") return Shape::WIDE;
+    if (shape == "deep") return Shape::DEEP;
+    if (shape == "array") return Shape::ARRAY;
+    if (shape == "mixed") return Shape::MIXED;
+    if (shape == "duplicate") return Shape::DUPLICATE;
+    throw std::runtime_error("Unsupported shape: " + shape);
+}
+
+Format stringToFormat(const std::string& format) {
+    if (format == "json") return Format::JSON;
+    if (format == "ndjson") return Format::NDJSON;
+    if (format == "cbor") return Format::CBOR;
+    throw std::runtime_error("Unsupported format: " + format);
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            options.showHelp = true;
+        }
+        else if (strcmp(argv[i], "--shape") == 0) {
+            if (i + 1 < argc) options.shape = stringToShape(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--format") == 0) {
+            if (i + 1 < argc) options.format = stringToFormat(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--size") == 0) {
+            if (i + 1 < argc) options.size = std::stoull(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--records") == 0) {
+            if (i + 1 < argc) options.records = std::stoull(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            if (i + 1 < argc) options.seed = std::stoull(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
+            if (i + 1 < argc) options.outputFile = argv[++i];
+        }
+        else {
+            throw std::runtime_error(std::string("Unknown option: ") + argv[i]);
+        }
+    }
+    return options;
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]\n"
+        << "Options:\n"
+        << "  --shape <shape>     Record shape (default: array):\n"
+        << "                        wide       one object with <size> keys\n"
+        << "                        deep       <size> objects nested through \"child\"\n"
+        << "                        array      an object with an array of <size> records of one shape\n"
+        << "                        mixed      an object with an array of <size> events of several tagged shapes\n"
+        << "                        duplicate  one object with <size> keys holding objects of the same shape\n"
+        << "  --size <n>          Size of each record (default: 1000)\n"
+        << "  --records <n>       Number of records (default: 1); more than one is written as an array,\n"
+        << "                      or one record per line with --format ndjson\n"
+        << "  --format <format>   json, ndjson or cbor (default: json)\n"
+        << "  --seed <n>          Seed for the generated values (default: 1)\n"
+        << "  -o, --output <file> Output file (default: stdout)\n"
+        << "  -h, --help          Show this help message\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+        if (options.showHelp) {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        std::ofstream outFile;
+        if (!options.outputFile.empty()) {
+            outFile.open(options.outputFile, std::ios::out | std::ios::binary);
+            if (!outFile.is_open()) {
+                throw std::runtime_error("Unable to create output file: " + options.outputFile);
+            }
+        }
+        std::ostream& out = options.outputFile.empty() ? std::cout : outFile;
+
+        std::unique_ptr<Writer> writer;
+        if (options.format == Format::CBOR) {
+            writer = std::make_unique<CborWriter>(out);
+        }
+        else {
+            writer = std::make_unique<JsonWriter>(out, options.format == Format::NDJSON);
+        }
+
+        Random random(options.seed);
+        bool wrapped = options.records != 1 && options.format != Format::NDJSON;
+        if (wrapped) {
+            writer->beginArray(options.records);
+        }
+        for (uint64_t record = 0; record < options.records; ++record) {
+            writeRecord(*writer, random, options);
+            writer->endRecord();
+        }
+        if (wrapped) {
+            writer->endArray();
+        }
+        writer->flush();
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Unable to write output");
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,96 +1,341 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class KotlinGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "import kotlinx.serialization.*\n"
-            << "import kotlinx.serialization.json.*\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "@Serializable\n"
-                        << "enum class " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << "@SerialName(\"" << value << "\")\n"
-                            << std::string(config.indentSize, ' ') << value << ",\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "@Serializable\n"
-            << "data class " << className << "(\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/** " << schema["properties"][key]["description"] << " */\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << "@SerialName(\"" << key << "\")\n"
-                << std::string(config.indentSize, ' ') << "val " << key << ": " << type << ",\n\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << ")\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import org.junit.jupiter.api.Test\n"
-            << "import kotlinx.serialization.json.Json\n"
-            << "import kotlin.test.assertEquals\n\n"
-            << "class " << className << "Test {\n\n"
-            << std::string(config.indentSize, ' ') << "@Test\n"
-            << std::string(config.indentSize, ' ') << "fun testSerializationDeserialization() {\n"
-            << std::string(config.indentSize * 2, ' ') << "val sampleJson = \"\"\"" << sampleData.dump() << "\"\"\"\n"
-            << std::string(config.indentSize * 2, ' ') << "val obj = Json.decodeFromString<" << className << ">(sampleJson)\n"
-            << std::string(config.indentSize * 2, ' ') << "val serialized = Json.encodeToString(obj)\n"
-            << std::string(config.indentSize * 2, ' ') << "val deserialized = Json.decodeFromString<" << className << ">(serialized)\n"
-            << std::string(config.indentSize * 2, ' ') << "assertEquals(obj, deserialized)\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Any?";
-        if (value.is_boolean()) return "Boolean";
-        if (value.is_number_integer()) return "Int";
-        if (value.is_number_float()) return "Double";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List<" + toLanguageType(value[0], config) + ">";
-            }
-            return "List<Any?>";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "Any";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "fun " << className << ".isValid(): Boolean {\n"
-            << std::string(config.indentSize, ' ') << "// TODO: Implement validation logic\n"
-            << std::string(config.indentSize, ' ') << "return true\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+
+class KotlinGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "import kotlinx.serialization.*\n"
+            << "import kotlinx.serialization.json.*\n";
+        if (config.valueTypes || config.stringFormats) {
+            outFile << "import kotlinx.serialization.descriptors.*\n"
+                << "import kotlinx.serialization.encoding.*\n";
+        }
+        if (config.stringFormats) {
+            outFile << "import java.time.Instant\n"
+                << "import java.time.OffsetDateTime\n"
+                << "import java.util.Base64\n"
+                << "import java.util.UUID\n";
+        }
+        outFile << "\n";
+        if (config.stringFormats) {
+            generateFormatSerializers(outFile, config);
+        }
+    }
+
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::UPPER_SNAKE);
+            outFile << "@Serializable\n"
+                << "enum class " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << std::string(config.indentSize, ' ') << "@SerialName(" << kotlinString(definition.values[i]) << ")\n"
+                    << std::string(config.indentSize, ' ') << cases[i] << ",\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        // A variant extends its sealed union, which a value class cannot
+        if (depth > 0 && config.valueTypes && !variantOf.count(className) && isValueClass(className, data)) {
+            generateValueClass(className, data, outFile, config);
+        }
+        else {
+            outFile << "@Serializable\n";
+            if (variantOf.count(className)) {
+                outFile << "@SerialName(" << kotlinString(variantOf[className].second) << ")\n";
+            }
+            outFile << "data class " << className << "(\n";
+
+            for (auto& [key, value] : data.items()) {
+                std::string type = fieldType(className, key, value, config);
+                if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                    outFile << std::string(config.indentSize, ' ') << "/** " << schema["properties"][key]["description"] << " */\n";
+                }
+                outFile << std::string(config.indentSize, ' ') << "@SerialName(\"" << key << "\")\n";
+                if (value.is_string() && stringFormats[className].count(key)) {
+                    outFile << std::string(config.indentSize, ' ') << "@Serializable(with = " << formatSerializer(stringFormats[className][key]) << "::class)\n";
+                }
+                outFile << std::string(config.indentSize, ' ') << "val " << key << ": " << type << ",\n\n";
+            }
+
+            outFile << ")" << (variantOf.count(className) ? " : " + variantOf[className].first + "()" : "") << "\n\n";
+        }
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        // Nested classes are top-level declarations following their parent
+        ++depth;
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    // The discriminator is written from @SerialName, so the variant has no tag property
+                    json fields = *variant.sample;
+                    fields.erase(tagged->property);
+                    variantOf[newClassName + "_" + variant.name] = { newClassName, variant.tag };
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, fields, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+        --depth;
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "import org.junit.jupiter.api.Test\n"
+            << "import kotlinx.serialization.json.Json\n"
+            << "import kotlin.test.assertEquals\n\n"
+            << "class " << className << "Test {\n\n"
+            << std::string(config.indentSize, ' ') << "@Test\n"
+            << std::string(config.indentSize, ' ') << "fun testSerializationDeserialization() {\n"
+            << std::string(config.indentSize * 2, ' ') << "val sampleJson = \"\"\"" << sampleData.dump() << "\"\"\"\n"
+            << std::string(config.indentSize * 2, ' ') << "val obj = Json.decodeFromString<" << className << ">(sampleJson)\n"
+            << std::string(config.indentSize * 2, ' ') << "val serialized = Json.encodeToString(obj)\n"
+            << std::string(config.indentSize * 2, ' ') << "val deserialized = Json.decodeFromString<" << className << ">(serialized)\n"
+            // ByteArray properties compare by reference in data class equality, so formats compare the encodings
+            << std::string(config.indentSize * 2, ' ') << (config.stringFormats ? "assertEquals(serialized, Json.encodeToString(deserialized))\n" : "assertEquals(obj, deserialized)\n")
+            << std::string(config.indentSize, ' ') << "}\n"
+            << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Any?";
+        if (value.is_boolean()) return "Boolean";
+        if (value.is_number_integer()) return "Long";
+        if (value.is_number_float()) return "Double";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List<" + toLanguageType(value[0], config) + ">";
+            }
+            return "List<Any?>";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "Any";
+    }
+
+private:
+    int depth = 0;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    // Sealed union and tag of each variant class
+    std::map<std::string, std::pair<std::string, std::string>> variantOf;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // The JSON decoder reads the discriminator directly when it is the first key and only buffers
+    // the object into a JsonElement when it comes later
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        outFile << "@OptIn(ExperimentalSerializationApi::class)\n"
+            << "@Serializable\n"
+            << "@JsonClassDiscriminator(" << kotlinString(tagged.property) << ")\n"
+            << "sealed class " << className << "\n\n";
+        if (config.generateValidation) {
+            outFile << "fun " << className << ".isValid(): Boolean = when (val variant = this) {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent1 << "is " << className << "_" << variant.name << " -> variant.isValid()\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    // Untyped values stay JsonElement, which kotlinx.serialization handles without a contextual serializer
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "UUID";
+            case StringFormat::Kind::DATE_TIME: return "Instant";
+            default: return "ByteArray";
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (value.is_null()) return "JsonElement";
+        if (value.is_array()) return "List<" + (value.empty() ? std::string("JsonElement") : fieldType(className, key, value[0], config)) + ">";
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            // Unsigned formats take the next wider signed type, which compares with plain literals
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return format.bits == 32 ? "Float" : "Double";
+            int bits = format.asSigned().bits;
+            return bits == 8 ? "Byte" : bits == 16 ? "Short" : bits == 32 ? "Int" : "Long";
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    std::string formatSerializer(const StringFormat& format) {
+        switch (format.kind) {
+        case StringFormat::Kind::UUID: return "UuidSerializer";
+        case StringFormat::Kind::DATE_TIME: return "InstantSerializer";
+        default: return "Base64Serializer";
+        }
+    }
+
+    // kotlinx.serialization has no built-in serializers for these JVM types. Offsets are accepted on
+    // input and Instant.toString writes UTC with a Z
+    void generateFormatSerializers(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        const std::tuple<const char*, const char*, const char*, const char*> serializers[] = {
+            { "UuidSerializer", "UUID", "value.toString()", "UUID.fromString(decoder.decodeString())" },
+            { "InstantSerializer", "Instant", "value.toString()", "OffsetDateTime.parse(decoder.decodeString()).toInstant()" },
+            { "Base64Serializer", "ByteArray", "Base64.getEncoder().encodeToString(value)", "Base64.getDecoder().decode(decoder.decodeString())" },
+        };
+        for (const auto& [name, type, encode, decode] : serializers) {
+            outFile << "object " << name << " : KSerializer<" << type << "> {\n"
+                << indent1 << "override val descriptor: SerialDescriptor = PrimitiveSerialDescriptor(\"" << name << "\", PrimitiveKind.STRING)\n\n"
+                << indent1 << "override fun serialize(encoder: Encoder, value: " << type << ") = encoder.encodeString(" << encode << ")\n\n"
+                << indent1 << "override fun deserialize(decoder: Decoder): " << type << " = " << decode << "\n"
+                << "}\n\n";
+        }
+    }
+
+    // The hand-written serializer encodes primitives only, so a single enum or formatted field keeps the data class
+    bool isValueClass(const std::string& className, const json& data) {
+        if (data.size() != 1 || !enumFields[className].empty() || !stringFormats[className].empty()) return false;
+        const json& value = data.begin().value();
+        return value.is_boolean() || value.is_number() || value.is_string();
+    }
+
+    // A plain value class would encode as its bare value, so a hand-written serializer keeps the object shape
+    void generateValueClass(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        const std::string& key = data.begin().key();
+        const json& value = data.begin().value();
+        std::string type = fieldType(className, key, value, config);
+        std::string zero = value.is_boolean() ? "false" : value.is_number_integer() ? "0" : type == "Float" ? "0.0f" : value.is_number_float() ? "0.0" : "\"\"";
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+
+        outFile << "@Serializable(with = " << className << ".Serializer::class)\n"
+            << "@JvmInline\n"
+            << "value class " << className << "(val " << key << ": " << type << ") {\n"
+            << indent1 << "object Serializer : KSerializer<" << className << "> {\n"
+            << indent2 << "override val descriptor: SerialDescriptor = buildClassSerialDescriptor(\"" << className << "\") {\n"
+            << indent3 << "element<" << type << ">(\"" << key << "\")\n"
+            << indent2 << "}\n\n"
+            << indent2 << "override fun serialize(encoder: Encoder, value: " << className << ") {\n"
+            << indent3 << "encoder.encodeStructure(descriptor) {\n"
+            << indent4 << "encode" << type << "Element(descriptor, 0, value." << key << ")\n"
+            << indent3 << "}\n"
+            << indent2 << "}\n\n"
+            << indent2 << "override fun deserialize(decoder: Decoder): " << className << " = decoder.decodeStructure(descriptor) {\n"
+            << indent3 << "var " << key << ": " << type << " = " << zero << "\n"
+            << indent3 << "while (true) {\n"
+            << indent4 << "when (val index = decodeElementIndex(descriptor)) {\n"
+            << indent5 << "0 -> " << key << " = decode" << type << "Element(descriptor, 0)\n"
+            << indent5 << "CompositeDecoder.DECODE_DONE -> break\n"
+            << indent5 << "else -> throw SerializationException(\"Unexpected index $index\")\n"
+            << indent4 << "}\n"
+            << indent3 << "}\n"
+            << indent3 << className << "(" << key << ")\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    // Patterns are compiled once into top-level vals; every other keyword is a plain comparison.
+    // Fields are non-null, so `required` is enforced by deserialization; lengths count code points
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << "private val " << className << "_" << key << "Pattern = Regex(" << kotlinString(*constraints.pattern) << ")\n\n";
+            }
+        }
+
+        outFile << "fun " << className << ".isValid(): Boolean {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent1 << "if (" << violation << ") return false\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            // A formatted field was checked by its serializer when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check(key + ".codePointCount(0, " + key + ".length) < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(key + ".codePointCount(0, " + key + ".length) > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check("!" + className + "_" + key + "Pattern.containsMatchIn(" + key + ")");
+            }
+            if (value.is_number()) {
+                // Unsigned formats are declared with the wider signed type, whose limits decide which bounds are redundant
+                NumberFormat format = numberFormats[className][key].asSigned();
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(key + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(key + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                // Kotlin's == does not widen, so literals take the field's type and Byte/Short compare as Int
+                std::string type = fieldType(className, key, value, config);
+                std::string operand = type == "Byte" || type == "Short" ? key + ".toInt()" : key;
+                std::string suffix = type == "Long" ? "L" : type == "Float" ? "f" : "";
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    std::string literal = candidate.is_string() ? kotlinString(candidate.get<std::string>())
+                        : value.is_number_float() ? FieldConstraints::boundLiteral(candidate.get<double>(), false, true) : candidate.dump();
+                    violation += (violation.empty() ? "" : " && ") + operand + " != " + literal + suffix;
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(key + ".size < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(key + ".size > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent1 << "for (i in " << key << ".indices) {\n"
+                        << indent2 << "if (!" << key << "[i].isValid()) return false\n"
+                        << indent1 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check("!" + key + ".isValid()");
+            }
+        }
+        outFile << indent1 << "return true\n"
+            << "}\n\n";
+    }
+
+    std::string kotlinString(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\' || c == '$') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+};
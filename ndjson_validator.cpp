@@ -0,0 +1,696 @@
+#include "json_model_generator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <regex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+enum TypeMask : unsigned {
+    NULL_TYPE = 1, BOOLEAN_TYPE = 2, INTEGER_TYPE = 4, NUMBER_TYPE = 8, STRING_TYPE = 16, ARRAY_TYPE = 32, OBJECT_TYPE = 64,
+    ANY_TYPE = 127, NO_TYPE = 0,
+    // Past the types, the boolean literals an enum allows; null is allowed by NULL_TYPE
+    TRUE_LITERAL = 256, FALSE_LITERAL = 512
+};
+
+std::string numberText(double value) {
+    return std::floor(value) == value && std::fabs(value) < 1e15 ? std::to_string(static_cast<long long>(value)) : json(value).dump();
+}
+
+const char* const typeNames[] = { "null", "boolean", "integer", "number", "string", "array", "object" };
+
+std::string describeTypes(unsigned types) {
+    std::string result;
+    for (unsigned bit = 0; bit < 7; ++bit) {
+        if (types & (1u << bit)) {
+            result += (result.empty() ? "" : " or ") + std::string(typeNames[bit]);
+        }
+    }
+    return result.empty() ? "nothing" : result;
+}
+
+struct Property {
+    size_t node;
+    int requiredSlot;
+};
+
+// One schema in the compiled table. Children are node indices, and $ref targets are resolved to
+// indices at compile time, so checking a value never looks anything up in the schema document
+struct SchemaNode {
+    unsigned types = ANY_TYPE;
+    std::optional<double> minimum;
+    std::optional<double> maximum;
+    std::optional<double> exclusiveMinimum;
+    std::optional<double> exclusiveMaximum;
+    std::optional<size_t> minLength;
+    std::optional<size_t> maxLength;
+    std::optional<size_t> minItems;
+    std::optional<size_t> maxItems;
+    std::optional<std::regex> pattern;
+    std::string patternSource;
+    bool hasEnum = false;
+    unsigned enumLiterals = 0;
+    std::unordered_set<std::string> enumStrings;
+    std::vector<double> enumNumbers;
+    std::unordered_map<std::string, Property> properties;
+    std::vector<std::string> required;
+    size_t additionalProperties = 0;
+    size_t items = 0;
+    // A discriminated oneOf: the tag property and the variant node for each tag
+    std::string discriminator;
+    std::unordered_map<std::string, size_t> variants;
+};
+
+class CompiledSchema {
+public:
+    static constexpr size_t ANY_NODE = 0;
+    static constexpr size_t NO_NODE = 1;
+
+    explicit CompiledSchema(const json& schema) : document(schema) {
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[NO_NODE].types = 0;
+        root = compile(schema);
+    }
+
+    const SchemaNode& node(size_t index) const { return nodes[index]; }
+    size_t rootNode() const { return root; }
+    size_t size() const { return nodes.size(); }
+
+private:
+    const json& document;
+    std::vector<SchemaNode> nodes;
+    std::map<std::string, size_t> refs;
+    size_t root = ANY_NODE;
+    bool warnedCombinators = false;
+
+    size_t compile(const json& schema) {
+        if (schema.is_boolean()) {
+            return schema.get<bool>() ? ANY_NODE : NO_NODE;
+        }
+        if (!schema.is_object()) {
+            return ANY_NODE;
+        }
+        if (schema.contains("$ref") && schema["$ref"].is_string()) {
+            // Registered before compiling the target, so recursive schemas refer back to the same node
+            std::string ref = schema["$ref"].get<std::string>();
+            auto known = refs.find(ref);
+            if (known != refs.end()) {
+                return known->second;
+            }
+            if (ref.empty() || ref[0] != '#') {
+                throw std::runtime_error("Only local $ref values are supported: " + ref);
+            }
+            size_t index = nodes.size();
+            nodes.emplace_back();
+            refs[ref] = index;
+            fill(index, document.at(json::json_pointer(ref.substr(1))));
+            return index;
+        }
+        size_t index = nodes.size();
+        nodes.emplace_back();
+        fill(index, schema);
+        return index;
+    }
+
+    // Children are compiled into locals first, since compiling appends to the table and moves its nodes
+    void fill(size_t index, const json& schema) {
+        if (!schema.is_object()) {
+            nodes[index].types = schema.is_boolean() && !schema.get<bool>() ? NO_TYPE : ANY_TYPE;
+            return;
+        }
+        if (schema.contains("type")) {
+            unsigned types = 0;
+            for (const auto& type : schema["type"].is_array() ? schema["type"] : json::array({ schema["type"] })) {
+                for (unsigned bit = 0; bit < 7; ++bit) {
+                    if (type == typeNames[bit]) types |= 1u << bit;
+                }
+                if (type == "number") types |= INTEGER_TYPE;
+            }
+            nodes[index].types = types;
+        }
+
+        std::vector<std::pair<std::string, size_t>> properties;
+        if (schema.contains("properties") && schema["properties"].is_object()) {
+            for (auto& [name, property] : schema["properties"].items()) {
+                properties.emplace_back(name, compile(property));
+            }
+        }
+        size_t additionalProperties = schema.contains("additionalProperties") ? compile(schema["additionalProperties"]) : ANY_NODE;
+        size_t items = schema.contains("items") && !schema["items"].is_array() ? compile(schema["items"]) : ANY_NODE;
+        std::unordered_map<std::string, size_t> variants;
+        const std::string* discriminator = TaggedUnion::discriminatorOf(schema);
+        if (discriminator) {
+            for (const auto& variant : schema["oneOf"]) {
+                const json& resolved = variant.contains("$ref") && variant["$ref"].is_string() && variant["$ref"].get<std::string>().rfind("#", 0) == 0
+                    ? document.at(json::json_pointer(variant["$ref"].get<std::string>().substr(1))) : variant;
+                std::optional<std::string> tag = TaggedUnion::tagOf(resolved, *discriminator);
+                if (!tag) {
+                    throw std::runtime_error("oneOf variant without a const " + *discriminator + " cannot be checked");
+                }
+                variants.emplace(*tag, compile(variant));
+            }
+        }
+        else if (!warnedCombinators && (schema.contains("oneOf") || schema.contains("anyOf") || schema.contains("allOf"))) {
+            std::cerr << "Warning: allOf, anyOf and oneOf without a discriminator are not checked" << std::endl;
+            warnedCombinators = true;
+        }
+
+        SchemaNode& node = nodes[index];
+        for (const auto& [name, child] : properties) {
+            node.properties[name] = { child, -1 };
+        }
+        node.additionalProperties = additionalProperties;
+        node.items = items;
+        if (discriminator) {
+            // Every variant is an object, so nothing else can match one
+            node.types &= OBJECT_TYPE;
+            node.discriminator = *discriminator;
+            node.variants = std::move(variants);
+        }
+        if (schema.contains("required") && schema["required"].is_array()) {
+            for (const auto& name : schema["required"]) {
+                auto& property = node.properties.emplace(name.get<std::string>(), Property{ ANY_NODE, -1 }).first->second;
+                if (property.requiredSlot < 0) {
+                    property.requiredSlot = static_cast<int>(node.required.size());
+                    node.required.push_back(name.get<std::string>());
+                }
+            }
+        }
+
+        auto number = [&](const char* keyword) -> std::optional<double> {
+            if (schema.contains(keyword) && schema[keyword].is_number()) return schema[keyword].get<double>();
+            return std::nullopt;
+        };
+        auto count = [&](const char* keyword) -> std::optional<size_t> {
+            if (schema.contains(keyword) && schema[keyword].is_number() && schema[keyword].get<double>() >= 0) return schema[keyword].get<size_t>();
+            return std::nullopt;
+        };
+        node.minimum = number("minimum");
+        node.maximum = number("maximum");
+        node.exclusiveMinimum = number("exclusiveMinimum");
+        node.exclusiveMaximum = number("exclusiveMaximum");
+        // Draft 4 spelled exclusive bounds as booleans next to minimum/maximum
+        if (schema.value("exclusiveMinimum", json()).is_boolean() && schema["exclusiveMinimum"].get<bool>()) {
+            std::swap(node.minimum, node.exclusiveMinimum);
+        }
+        if (schema.value("exclusiveMaximum", json()).is_boolean() && schema["exclusiveMaximum"].get<bool>()) {
+            std::swap(node.maximum, node.exclusiveMaximum);
+        }
+        node.minLength = count("minLength");
+        node.maxLength = count("maxLength");
+        node.minItems = count("minItems");
+        node.maxItems = count("maxItems");
+        if (schema.contains("pattern") && schema["pattern"].is_string()) {
+            node.patternSource = schema["pattern"].get<std::string>();
+            node.pattern.emplace(node.patternSource, std::regex::ECMAScript | std::regex::optimize);
+        }
+
+        json allowed = json::array();
+        if (schema.contains("enum") && schema["enum"].is_array()) allowed = schema["enum"];
+        if (schema.contains("const")) allowed = json::array({ schema["const"] });
+        if (schema.contains("enum") || schema.contains("const")) {
+            node.hasEnum = true;
+            for (const auto& value : allowed) {
+                if (value.is_string()) node.enumStrings.insert(value.get<std::string>());
+                else if (value.is_number()) node.enumNumbers.push_back(value.get<double>());
+                else if (value.is_null()) node.enumLiterals |= NULL_TYPE;
+                else if (value.is_boolean()) node.enumLiterals |= value.get<bool>() ? TRUE_LITERAL : FALSE_LITERAL;
+            }
+        }
+    }
+};
+
+// Checks one record while nlohmann's SAX parser reads it, so no DOM is built. A checker owns its frame
+// stack and reuses it for every record; use one checker per thread
+class RecordChecker {
+public:
+    explicit RecordChecker(const CompiledSchema& schema) : schema(schema) {}
+
+    bool check(const char* begin, const char* end) {
+        depth = 0;
+        collecting.clear();
+        replayNode.reset();
+        failedPath.clear();
+        failedKeyword.clear();
+        failedMessage.clear();
+        return json::sax_parse(begin, end, this);
+    }
+
+    const std::string& path() const { return failedPath; }
+    const std::string& keyword() const { return failedKeyword; }
+    const std::string& message() const { return failedMessage; }
+
+    bool null() {
+        if (!collecting.empty()) return collect(nullptr);
+        const SchemaNode& node = enter();
+        return checkType(node, NULL_TYPE) && checkLiteral(node, NULL_TYPE, "null");
+    }
+
+    bool boolean(bool value) {
+        if (!collecting.empty()) return collect(value);
+        const SchemaNode& node = enter();
+        return checkType(node, BOOLEAN_TYPE) && checkLiteral(node, value ? TRUE_LITERAL : FALSE_LITERAL, value ? "true" : "false");
+    }
+
+    bool number_integer(json::number_integer_t value) {
+        if (!collecting.empty()) return collect(value);
+        const SchemaNode& node = enter();
+        return checkType(node, INTEGER_TYPE) && checkNumber(node, static_cast<double>(value));
+    }
+
+    bool number_unsigned(json::number_unsigned_t value) {
+        if (!collecting.empty()) return collect(value);
+        const SchemaNode& node = enter();
+        return checkType(node, INTEGER_TYPE) && checkNumber(node, static_cast<double>(value));
+    }
+
+    bool number_float(json::number_float_t value, const json::string_t&) {
+        if (!collecting.empty()) return collect(value);
+        // A float without a fractional part is still an integer to JSON Schema
+        const SchemaNode& node = enter();
+        return checkType(node, std::isfinite(value) && std::floor(value) == value ? INTEGER_TYPE : NUMBER_TYPE) && checkNumber(node, value);
+    }
+
+    bool string(json::string_t& value) {
+        if (!collecting.empty()) return collect(value);
+        const SchemaNode& node = enter();
+        if (!checkType(node, STRING_TYPE)) return false;
+        if (node.minLength || node.maxLength) {
+            size_t length = std::count_if(value.begin(), value.end(), [](unsigned char c) { return (c & 0xC0) != 0x80; });
+            if (node.minLength && length < *node.minLength) return fail(depth, "minLength", "shorter than " + std::to_string(*node.minLength) + " characters");
+            if (node.maxLength && length > *node.maxLength) return fail(depth, "maxLength", "longer than " + std::to_string(*node.maxLength) + " characters");
+        }
+        if (node.pattern && !std::regex_search(value, *node.pattern)) return fail(depth, "pattern", "does not match " + node.patternSource);
+        if (node.hasEnum && !node.enumStrings.count(value)) return fail(depth, "enum", "\"" + value + "\" is not an allowed value");
+        return true;
+    }
+
+    bool binary(json::binary_t&) {
+        return fail(depth, "type", "binary values are not JSON");
+    }
+
+    bool start_object(std::size_t) {
+        if (!collecting.empty()) return collect(nlohmann::ordered_json::object());
+        size_t index = enterIndex();
+        const SchemaNode& node = schema.node(index);
+        if (!checkType(node, OBJECT_TYPE)) return false;
+        if (!node.variants.empty()) {
+            // The tag may follow the fields it decides, so the object is collected and checked at its end
+            collected = nlohmann::ordered_json::object();
+            collecting.push_back(&collected);
+            unionNode = index;
+            return true;
+        }
+        Frame& frame = push(index, false);
+        frame.seen.assign(node.required.size(), false);
+        return true;
+    }
+
+    bool key(json::string_t& name) {
+        if (!collecting.empty()) {
+            collectedKey = name;
+            return true;
+        }
+        Frame& frame = frames[depth - 1];
+        const SchemaNode& node = schema.node(frame.node);
+        frame.key = name;
+        auto property = node.properties.find(name);
+        if (property == node.properties.end()) {
+            frame.pending = node.additionalProperties;
+            if (frame.pending == CompiledSchema::NO_NODE) return fail(depth, "additionalProperties", "property is not allowed");
+            return true;
+        }
+        frame.pending = property->second.node;
+        if (property->second.requiredSlot >= 0) {
+            frame.seen[property->second.requiredSlot] = true;
+        }
+        return true;
+    }
+
+    bool end_object() {
+        if (!collecting.empty()) {
+            collecting.pop_back();
+            return !collecting.empty() || checkVariant();
+        }
+        const Frame& frame = frames[depth - 1];
+        const SchemaNode& node = schema.node(frame.node);
+        for (size_t slot = 0; slot < frame.seen.size(); ++slot) {
+            if (!frame.seen[slot]) return fail(depth - 1, "required", "missing required property " + node.required[slot]);
+        }
+        --depth;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if (!collecting.empty()) return collect(nlohmann::ordered_json::array());
+        size_t index = enterIndex();
+        if (!checkType(schema.node(index), ARRAY_TYPE)) return false;
+        push(index, true);
+        return true;
+    }
+
+    bool end_array() {
+        if (!collecting.empty()) {
+            collecting.pop_back();
+            return true;
+        }
+        const Frame& frame = frames[depth - 1];
+        const SchemaNode& node = schema.node(frame.node);
+        if (node.minItems && frame.count < *node.minItems) return fail(depth - 1, "minItems", "fewer than " + std::to_string(*node.minItems) + " items");
+        if (node.maxItems && frame.count > *node.maxItems) return fail(depth - 1, "maxItems", "more than " + std::to_string(*node.maxItems) + " items");
+        --depth;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& error) {
+        // A failed check also stops the parser; only report syntax errors that come first
+        if (failedKeyword.empty()) {
+            failedKeyword = "json";
+            failedMessage = error.what();
+        }
+        return false;
+    }
+
+private:
+    struct Frame {
+        size_t node = 0;
+        bool array = false;
+        size_t count = 0;
+        size_t pending = 0;
+        std::string key;
+        std::vector<bool> seen;
+    };
+
+    const CompiledSchema& schema;
+    std::vector<Frame> frames;
+    size_t depth = 0;
+    std::string failedPath;
+    std::string failedKeyword;
+    std::string failedMessage;
+    // Object of a discriminated oneOf being collected, the open containers in it and the last key read
+    nlohmann::ordered_json collected;
+    std::vector<nlohmann::ordered_json*> collecting;
+    std::string collectedKey;
+    size_t unionNode = 0;
+    // Variant node the collected object is replayed against; its position was already counted
+    std::optional<size_t> replayNode;
+
+    // Schema of the value that starts now: the root, the pending property or the array items
+    size_t enterIndex() {
+        if (replayNode) {
+            size_t index = *replayNode;
+            replayNode.reset();
+            return index;
+        }
+        if (depth == 0) return schema.rootNode();
+        Frame& frame = frames[depth - 1];
+        if (frame.array) {
+            ++frame.count;
+            return schema.node(frame.node).items;
+        }
+        return frame.pending;
+    }
+
+    const SchemaNode& enter() {
+        return schema.node(enterIndex());
+    }
+
+    // Frames above the current depth keep their buffers for the next record
+    Frame& push(size_t node, bool array) {
+        if (depth == frames.size()) {
+            frames.emplace_back();
+        }
+        Frame& frame = frames[depth++];
+        frame.node = node;
+        frame.array = array;
+        frame.count = 0;
+        frame.pending = CompiledSchema::ANY_NODE;
+        return frame;
+    }
+
+    bool checkType(const SchemaNode& node, unsigned type) {
+        if (node.types & type) return true;
+        if (node.types == 0) return fail(depth, "false", "no value is allowed here");
+        return fail(depth, "type", "expected " + describeTypes(node.types) + ", got " + describeTypes(type));
+    }
+
+    bool checkLiteral(const SchemaNode& node, unsigned literal, const char* text) {
+        if (node.hasEnum && !(node.enumLiterals & literal)) return fail(depth, "enum", std::string(text) + " is not an allowed value");
+        return true;
+    }
+
+    bool checkNumber(const SchemaNode& node, double value) {
+        if (node.minimum && value < *node.minimum) return fail(depth, "minimum", "less than " + numberText(*node.minimum));
+        if (node.maximum && value > *node.maximum) return fail(depth, "maximum", "greater than " + numberText(*node.maximum));
+        if (node.exclusiveMinimum && value <= *node.exclusiveMinimum) return fail(depth, "exclusiveMinimum", "not greater than " + numberText(*node.exclusiveMinimum));
+        if (node.exclusiveMaximum && value >= *node.exclusiveMaximum) return fail(depth, "exclusiveMaximum", "not less than " + numberText(*node.exclusiveMaximum));
+        if (node.hasEnum && std::find(node.enumNumbers.begin(), node.enumNumbers.end(), value) == node.enumNumbers.end()) {
+            return fail(depth, "enum", numberText(value) + " is not an allowed value");
+        }
+        return true;
+    }
+
+    // Containers are added before their contents, and only the innermost open one receives values, so
+    // the pointers in the stack stay valid
+    bool collect(nlohmann::ordered_json value) {
+        nlohmann::ordered_json& parent = *collecting.back();
+        nlohmann::ordered_json* slot;
+        if (parent.is_array()) {
+            parent.push_back(std::move(value));
+            slot = &parent.back();
+        }
+        else {
+            slot = &(parent[collectedKey] = std::move(value));
+        }
+        if (slot->is_structured()) collecting.push_back(slot);
+        return true;
+    }
+
+    // Replays a collected union object against the variant its tag names. Nested unions collect into
+    // the member again, so the object is moved out first
+    bool checkVariant() {
+        const SchemaNode& node = schema.node(unionNode);
+        nlohmann::ordered_json object = std::move(collected);
+        auto tag = object.find(node.discriminator);
+        if (tag == object.end() || !tag->is_string()) return fail(depth, "oneOf", "missing " + node.discriminator + " tag");
+        auto variant = node.variants.find(tag->get<std::string>());
+        if (variant == node.variants.end()) return fail(depth, "oneOf", "\"" + tag->get<std::string>() + "\" is not a known " + node.discriminator);
+        replayNode = variant->second;
+        return replay(object);
+    }
+
+    bool replay(nlohmann::ordered_json& value) {
+        switch (value.type()) {
+        case json::value_t::object:
+            if (!start_object(value.size())) return false;
+            for (auto& [name, item] : value.items()) {
+                std::string keyName = name;
+                if (!key(keyName) || !replay(item)) return false;
+            }
+            return end_object();
+        case json::value_t::array:
+            if (!start_array(value.size())) return false;
+            for (auto& item : value) {
+                if (!replay(item)) return false;
+            }
+            return end_array();
+        case json::value_t::boolean: return boolean(value.get<bool>());
+        case json::value_t::number_integer: return number_integer(value.get<json::number_integer_t>());
+        case json::value_t::number_unsigned: return number_unsigned(value.get<json::number_unsigned_t>());
+        case json::value_t::number_float: return number_float(value.get<json::number_float_t>(), "");
+        case json::value_t::string: return string(value.get_ref<std::string&>());
+        default: return null();
+        }
+    }
+
+    // Records the first violation with the JSON pointer of the value at the given depth. The path is
+    // only built here, so valid records never pay for it
+    bool fail(size_t levels, const char* keyword, const std::string& message) {
+        failedPath.clear();
+        for (size_t i = 0; i < levels; ++i) {
+            failedPath += '/';
+            if (frames[i].array) {
+                failedPath += std::to_string(frames[i].count - 1);
+                continue;
+            }
+            for (char c : frames[i].key) {
+                failedPath += c == '~' ? "~0" : c == '/' ? "~1" : std::string(1, c);
+            }
+        }
+        failedKeyword = keyword;
+        failedMessage = message;
+        return false;
+    }
+};
+
+struct Chunk {
+    size_t sequence;
+    size_t firstLine;
+    std::string text;
+};
+
+struct ChunkResult {
+    size_t records = 0;
+    size_t invalid = 0;
+    std::string failures;
+    std::map<std::string, size_t> keywords;
+};
+
+ChunkResult checkChunk(const Chunk& chunk, RecordChecker& checker) {
+    ChunkResult result;
+    const char* position = chunk.text.data();
+    const char* end = position + chunk.text.size();
+    for (size_t line = chunk.firstLine; position < end; ++line) {
+        const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        const char* lineEnd = newline ? newline : end;
+        const char* first = position;
+        while (first < lineEnd && std::isspace(static_cast<unsigned char>(*first))) ++first;
+        if (first < lineEnd) {
+            ++result.records;
+            if (!checker.check(first, lineEnd)) {
+                ++result.invalid;
+                ++result.keywords[checker.keyword()];
+                result.failures += nlohmann::ordered_json({ {"line", line}, {"path", checker.path()}, {"keyword", checker.keyword()}, {"error", checker.message()} }).dump() + "\n";
+            }
+        }
+        position = lineEnd + 1;
+    }
+    return result;
+}
+
+} // namespace
+
+// --validate: the main thread reads the NDJSON file in blocks cut at line ends, workers check the
+// records of a block, and failures are written in input order as blocks complete
+int runValidation(const Config& config) {
+    json schema;
+    if (config.useSchema) {
+        schema = readSchemaFromFile(config.schemaFile);
+        TaggedUnion::inlineVariants(schema);
+    }
+    else if (!config.inputFile.empty()) {
+        schema = inferSchemaFromJson(readJsonFromFile(config.inputFile, config.inputFormat), config.enumThreshold);
+    }
+    else {
+        throw std::runtime_error("--validate needs a schema (-s) or a sample record (-i)");
+    }
+    CompiledSchema compiled(schema);
+
+    std::ifstream records(config.validateFile, std::ios::in | std::ios::binary);
+    if (!records.is_open()) {
+        throw std::runtime_error("Unable to open file: " + config.validateFile);
+    }
+    std::ofstream failureFile;
+    if (!config.outputFile.empty()) {
+        failureFile.open(config.outputFile, std::ios::out | std::ios::binary);
+        if (!failureFile.is_open()) {
+            throw std::runtime_error("Unable to create output file: " + config.outputFile);
+        }
+    }
+    std::ostream& failures = config.outputFile.empty() ? std::cout : failureFile;
+
+    unsigned threadCount = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t blockSize = 1 << 22;
+    const size_t queueLimit = threadCount * 2;
+
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<Chunk> queue;
+    bool finished = false;
+    std::map<size_t, ChunkResult> completed;
+    size_t nextSequence = 0;
+    ChunkResult totals;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back([&] {
+            RecordChecker checker(compiled);
+            while (true) {
+                Chunk chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    queueChanged.wait(lock, [&] { return !queue.empty() || finished; });
+                    if (queue.empty()) return;
+                    chunk = std::move(queue.front());
+                    queue.pop_front();
+                }
+                queueChanged.notify_all();
+                ChunkResult result = checkChunk(chunk, checker);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.emplace(chunk.sequence, std::move(result));
+                for (auto next = completed.begin(); next != completed.end() && next->first == nextSequence; next = completed.erase(next), ++nextSequence) {
+                    failures << next->second.failures;
+                    totals.records += next->second.records;
+                    totals.invalid += next->second.invalid;
+                    for (const auto& [keyword, count] : next->second.keywords) {
+                        totals.keywords[keyword] += count;
+                    }
+                }
+            }
+        });
+    }
+
+    std::string carry;
+    size_t sequence = 0;
+    size_t line = 1;
+    while (records || !carry.empty()) {
+        std::string text = std::move(carry);
+        carry.clear();
+        size_t used = text.size();
+        text.resize(used + blockSize);
+        records.read(&text[used], blockSize);
+        text.resize(used + static_cast<size_t>(records.gcount()));
+        if (records) {
+            // A record never spans two blocks; the unfinished line starts the next one
+            size_t cut = text.rfind('\n');
+            if (cut == std::string::npos) {
+                carry = std::move(text);
+                continue;
+            }
+            carry.assign(text, cut + 1, std::string::npos);
+            text.resize(cut + 1);
+        }
+        if (text.empty()) {
+            break;
+        }
+        size_t lines = std::count(text.begin(), text.end(), '\n');
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [&] { return queue.size() < queueLimit; });
+            queue.push_back({ sequence++, line, std::move(text) });
+        }
+        queueChanged.notify_all();
+        line += lines;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    queueChanged.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    failures.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Validated " << totals.records << " records in " << seconds << " s ("
+        << static_cast<size_t>(totals.records / std::max(seconds, 1e-9)) << " records/s, " << threadCount << " threads, "
+        << compiled.size() << " schema nodes): " << totals.records - totals.invalid << " valid, " << totals.invalid << " invalid" << std::endl;
+    for (const auto& [keyword, count] : totals.keywords) {
+        std::cerr << "  " << keyword << ": " << count << std::endl;
+    }
+    return totals.invalid == 0 ? 0 : 2;
+}
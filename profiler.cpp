@@ -0,0 +1,224 @@
+#include "json_model_generator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <unordered_map>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{ 0 };
+std::atomic<uint64_t> allocatedBytes{ 0 };
+
+double wallMicroseconds() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// User plus system time of the whole process; generation is single-threaded, so this is its own time
+double cpuMicroseconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto ticks = [](const FILETIME& time) { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+    return (ticks(kernel) + ticks(user)) / 10.0;
+#else
+    timespec time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return time.tv_sec * 1e6 + time.tv_nsec / 1e3;
+#endif
+}
+
+uint64_t peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters) ? counters.PeakWorkingSetSize / 1024 : 0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    // macOS reports bytes, Linux kilobytes
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::string fixed(double value, int precision) {
+    char text[32];
+    std::snprintf(text, sizeof text, "%.*f", precision, value);
+    return text;
+}
+
+} // namespace
+
+#ifdef JSON_MODEL_GENERATOR_COUNT_ALLOCATIONS
+// The array, nothrow and sized forms default to these two, so every unaligned allocation is counted
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+bool Profiler::countsAllocations() {
+#ifdef JSON_MODEL_GENERATOR_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Profiler::Profiler() : originUs(wallMicroseconds()), originCpuUs(cpuMicroseconds()) {}
+
+// The span holds its start values until the scope ends and replaces them with differences
+Profiler::Scope::Scope(Profiler* profiler, const std::string& name, const char* category) : profiler(profiler) {
+    if (!profiler) return;
+    index = profiler->spans.size();
+    Span span{ name, category, static_cast<int>(profiler->open.size()), wallMicroseconds() - profiler->originUs };
+    span.cpuUs = cpuMicroseconds();
+    span.allocations = allocationCount.load(std::memory_order_relaxed);
+    span.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+    profiler->spans.push_back(std::move(span));
+    profiler->open.push_back(index);
+}
+
+Profiler::Scope::~Scope() {
+    if (!profiler) return;
+    Span& span = profiler->spans[index];
+    span.wallUs = wallMicroseconds() - profiler->originUs - span.startUs;
+    span.cpuUs = cpuMicroseconds() - span.cpuUs;
+    span.allocations = allocationCount.load(std::memory_order_relaxed) - span.allocations;
+    span.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed) - span.allocatedBytes;
+    span.peakRssKb = peakRssKb();
+    profiler->open.pop_back();
+    if (!profiler->open.empty()) {
+        Span& parent = profiler->spans[profiler->open.back()];
+        parent.childWallUs += span.wallUs;
+        parent.childCpuUs += span.cpuUs;
+        parent.childAllocations += span.allocations;
+        parent.childAllocatedBytes += span.allocatedBytes;
+    }
+}
+
+// Phases are summed by name in order of first appearance; classes are ranked by self time, which leaves
+// out the nested classes they generate
+void Profiler::writeSummary(std::ostream& out) const {
+    struct Total {
+        std::string name;
+        double wallUs = 0;
+        double cpuUs = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t peakRssKb = 0;
+        size_t calls = 0;
+    };
+    std::vector<Total> phases;
+    std::vector<Total> classes;
+    // Position of each name in its totals, so a deep run with thousands of classes sums in linear time
+    std::unordered_map<std::string, size_t> phaseIndex;
+    std::unordered_map<std::string, size_t> classIndex;
+    for (const auto& span : spans) {
+        bool isClass = std::string(span.category) == "class";
+        std::vector<Total>& totals = isClass ? classes : phases;
+        auto [position, added] = (isClass ? classIndex : phaseIndex).try_emplace(span.name, totals.size());
+        if (added) {
+            totals.push_back({ span.name });
+        }
+        Total& total = totals[position->second];
+        total.wallUs += isClass ? span.wallUs - span.childWallUs : span.wallUs;
+        total.cpuUs += isClass ? span.cpuUs - span.childCpuUs : span.cpuUs;
+        total.allocations += isClass ? span.allocations - span.childAllocations : span.allocations;
+        total.allocatedBytes += isClass ? span.allocatedBytes - span.childAllocatedBytes : span.allocatedBytes;
+        total.peakRssKb = std::max(total.peakRssKb, span.peakRssKb);
+        ++total.calls;
+    }
+    std::stable_sort(classes.begin(), classes.end(), [](const Total& a, const Total& b) { return a.wallUs > b.wallUs; });
+    const size_t shownClasses = 10;
+    if (classes.size() > shownClasses) {
+        classes.resize(shownClasses);
+    }
+
+    size_t width = 20;
+    for (const auto& total : classes) {
+        width = std::max(width, total.name.size() + 2);
+    }
+    bool allocations = countsAllocations();
+    auto header = [&](const std::string& title) {
+        out << std::left << std::setw(static_cast<int>(width)) << title << std::right
+            << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms";
+        if (allocations) {
+            out << std::setw(14) << "allocations" << std::setw(12) << "alloc MB";
+        }
+        out << std::setw(14) << "peak RSS MB" << "\n";
+    };
+    auto row = [&](const std::string& name, double wallUs, double cpuUs, uint64_t count, uint64_t bytes, uint64_t rssKb) {
+        out << std::left << std::setw(static_cast<int>(width)) << name << std::right
+            << std::setw(12) << fixed(wallUs / 1e3, 3) << std::setw(12) << fixed(cpuUs / 1e3, 3);
+        if (allocations) {
+            out << std::setw(14) << count << std::setw(12) << fixed(bytes / 1048576.0, 2);
+        }
+        out << std::setw(14) << fixed(rssKb / 1024.0, 1) << "\n";
+    };
+
+    header("phase");
+    for (const auto& total : phases) {
+        row(total.name, total.wallUs, total.cpuUs, total.allocations, total.allocatedBytes, total.peakRssKb);
+    }
+    row("total", wallMicroseconds() - originUs, cpuMicroseconds() - originCpuUs, allocationCount.load(), allocatedBytes.load(), peakRssKb());
+    if (!classes.empty()) {
+        out << "\n";
+        header("class (self time)");
+        for (const auto& total : classes) {
+            row(total.name + (total.calls > 1 ? " x" + std::to_string(total.calls) : ""), total.wallUs, total.cpuUs,
+                total.allocations, total.allocatedBytes, total.peakRssKb);
+        }
+    }
+    if (!allocations) {
+        out << "\nAllocations are not counted; build with -DJSON_MODEL_GENERATOR_COUNT_ALLOCATIONS=ON to count them.\n";
+    }
+}
+
+// Complete ("X") events for the spans and counter ("C") events for peak RSS, with times in microseconds
+void Profiler::writeTrace(const std::string& filename) const {
+    json events = json::array();
+    events.push_back({ {"name", "process_name"}, {"ph", "M"}, {"pid", 1}, {"args", { {"name", "json_model_generator"} }} });
+    for (const auto& span : spans) {
+        json args = { {"cpu_us", span.cpuUs} };
+        if (countsAllocations()) {
+            args["allocations"] = span.allocations;
+            args["allocated_bytes"] = span.allocatedBytes;
+        }
+        events.push_back({ {"name", span.name}, {"cat", span.category}, {"ph", "X"}, {"ts", span.startUs}, {"dur", span.wallUs},
+            {"pid", 1}, {"tid", 1}, {"args", args} });
+        events.push_back({ {"name", "peak RSS"}, {"ph", "C"}, {"ts", span.startUs + span.wallUs}, {"pid", 1},
+            {"args", { {"MB", span.peakRssKb / 1024.0} }} });
+    }
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to write trace file: " + filename);
+    }
+    file << json{ {"traceEvents", events}, {"displayTimeUnit", "ms"} }.dump() << std::endl;
+}
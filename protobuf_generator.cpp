@@ -0,0 +1,244 @@
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+
+class ProtobufGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        fieldIds.load(config.outputFile + ".ids.json");
+        outFile << "// Field numbers are persisted in " << config.outputFile << ".ids.json; keep it under version control.\n"
+            << "syntax = \"proto3\";\n\n"
+            << "package jsonmodel;\n\n";
+    }
+
+    // Enums are held back until the first message, so the imports that follow the package line can be
+    // limited to the well-known types the messages use
+    void generateEnums(const json& schema, std::ofstream&, const Config& config) override {
+        std::ostringstream& outFile = enumDeclarations;
+        if (schema.contains("definitions")) {
+            for (auto& [name, def] : schema["definitions"].items()) {
+                if (def.contains("enum")) {
+                    enumNames.insert(name);
+                    // Enum values share the package scope, so they are prefixed with the enum name,
+                    // and proto3 requires the first value to be zero
+                    std::string prefix = constantName(name) + "_";
+                    outFile << "enum " << name << " {\n"
+                        << std::string(config.indentSize, ' ') << prefix << "UNSPECIFIED = 0;\n";
+                    for (size_t i = 0; i < def["enum"].size(); ++i) {
+                        const json& value = def["enum"][i];
+                        outFile << std::string(config.indentSize, ' ') << prefix << constantName(value.is_string() ? value.get<std::string>() : value.dump()) << " = " << i + 1 << ";\n";
+                    }
+                    outFile << "}\n\n";
+                }
+            }
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        if (++depth == 1) {
+            std::set<std::string> imports;
+            collectImports(className, data, schema, config, imports);
+            for (const auto& file : imports) {
+                outFile << "import \"" << file << "\";\n";
+            }
+            outFile << (imports.empty() ? "" : "\n") << enumDeclarations.str();
+        }
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                const json& sample = value.is_array() ? value[0] : value;
+                generateClass(newClassName, sample, nestedSchema(schema, key, sample), outFile, config, circHandler);
+            }
+        }
+
+        for (auto& [key, value] : data.items()) {
+            fieldIds.assign(className, key, fieldType(className, key, value, schema), 1);
+        }
+
+        outFile << "message " << className << " {\n";
+        std::vector<FieldIdRegistry::Field> retired;
+        for (const auto& field : fieldIds.fields(className)) {
+            if (field.retired || !data.contains(field.name)) {
+                retired.push_back(field);
+                continue;
+            }
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(field.name) && schema["properties"][field.name].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "// " << schema["properties"][field.name]["description"].get<std::string>() << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << field.type << " " << fieldName(field.name) << " = " << field.id << fieldOptions(field) << ";\n";
+        }
+        // Numbers and names of fields that left the sample must never be reused
+        for (const auto& field : retired) {
+            outFile << std::string(config.indentSize, ' ') << "reserved " << field.id << ";\n"
+                << std::string(config.indentSize, ' ') << "reserved \"" << fieldName(field.name) << "\";\n";
+        }
+        outFile << "}\n\n";
+
+        if (--depth == 0) {
+            fieldIds.save();
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "// Round-trip check for " << className << " against the generated schema (Python):\n"
+            << "//   protoc --python_out=. " << config.outputFile << "\n"
+            << "//   from google.protobuf import json_format\n"
+            << "//   message = json_format.Parse(sample, " << className << "())\n"
+            << "//   output = json_format.MessageToJson(message, preserving_proto_field_name=True)\n";
+        if (config.stringFormats) {
+            // Timestamps are written back in UTC, so the output is compared with its own round trip
+            testFile << "//   assert json_format.MessageToJson(json_format.Parse(output, " << className << "()), preserving_proto_field_name=True) == output\n";
+        }
+        else {
+            testFile << "//   assert json.loads(output) == json.loads(sample)\n";
+        }
+        testFile << "//\n"
+            << "// sample:\n"
+            << "// " << sampleData.dump() << "\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "google.protobuf.Value";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "int64";
+        if (value.is_number_float()) return "double";
+        if (value.is_string()) return "string";
+        if (value.is_array()) {
+            if (!value.empty() && !value[0].is_null() && !value[0].is_array()) {
+                return "repeated " + toLanguageType(value[0], config, key);
+            }
+            // Repeated fields cannot nest, so untyped and nested arrays use the well-known ListValue
+            return "google.protobuf.ListValue";
+        }
+        if (value.is_object()) return key;
+        return "google.protobuf.Value";
+    }
+
+private:
+    FieldIdRegistry fieldIds;
+    std::set<std::string> enumNames;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    std::ostringstream enumDeclarations;
+    int depth = 0;
+
+    // Files declaring the well-known types used by the fields of className and its nested messages
+    void collectImports(const std::string& className, const json& data, const json& schema, const Config& config, std::set<std::string>& imports) {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        for (auto& [key, value] : data.items()) {
+            if (value.is_object() || isArrayOfObjects(value)) {
+                const json& sample = value.is_array() ? value[0] : value;
+                collectImports(className + "_" + key, sample, nestedSchema(schema, key, sample), config, imports);
+            }
+            std::string type = fieldType(className, key, value, schema);
+            if (type.find("google.protobuf.Timestamp") != std::string::npos) {
+                imports.insert("google/protobuf/timestamp.proto");
+            }
+            else if (type.find("google.protobuf.") != std::string::npos) {
+                imports.insert("google/protobuf/struct.proto");
+            }
+        }
+    }
+
+    bool isArrayOfObjects(const json& value) {
+        return value.is_array() && !value.empty() && value[0].is_object();
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const json& schema) {
+        const json& property = propertySchema(schema, key);
+        if (property.contains("$ref")) {
+            std::string ref = property["$ref"].get<std::string>();
+            std::string name = ref.substr(ref.find_last_of('/') + 1);
+            if (enumNames.count(name)) return name;
+        }
+        if (value.is_string() && stringFormats[className].count(key)) {
+            // The proto3 JSON mapping writes Timestamp as RFC 3339 and bytes as base64, so both keep
+            // their text form; a UUID stays a string because bytes would change it to base64
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::DATE_TIME: return "google.protobuf.Timestamp";
+            case StringFormat::Kind::BYTES: return "bytes";
+            default: break;
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (isArrayOfObjects(value)) return "repeated " + className + "_" + key;
+        if (NumberFormat::isNumeric(value) && numberFormats[className][key].bits != 0) {
+            // Varints already encode small values compactly, so only the 32/64-bit split matters
+            const NumberFormat& format = numberFormats[className][key];
+            std::string type = format.isFloat ? (format.bits == 32 ? "float" : "double")
+                : std::string(format.isUnsigned ? "uint" : "int") + (format.bits == 64 ? "64" : "32");
+            return value.is_array() ? "repeated " + type : type;
+        }
+        return toLanguageType(value, Config(), key);
+    }
+
+    std::string constantName(const std::string& name) {
+        std::string result;
+        for (size_t i = 0; i < name.size(); ++i) {
+            unsigned char c = name[i];
+            if (!std::isalnum(c)) {
+                if (!result.empty() && result.back() != '_') result += '_';
+                continue;
+            }
+            if (std::isupper(c) && i > 0 && std::islower(static_cast<unsigned char>(name[i - 1]))) {
+                result += '_';
+            }
+            result += static_cast<char>(std::toupper(c));
+        }
+        return result;
+    }
+
+    std::string fieldName(const std::string& key) {
+        std::string result;
+        for (unsigned char c : key) {
+            result += std::isalnum(c) ? static_cast<char>(c) : '_';
+        }
+        if (result.empty() || std::isdigit(static_cast<unsigned char>(result[0]))) {
+            result = "f_" + result;
+        }
+        return result;
+    }
+
+    // protoc derives the JSON name by camel-casing the field name
+    std::string defaultJsonName(const std::string& name) {
+        std::string result;
+        bool upper = false;
+        for (char c : name) {
+            if (c == '_') {
+                upper = true;
+                continue;
+            }
+            result += upper ? static_cast<char>(std::toupper(c)) : c;
+            upper = false;
+        }
+        return result;
+    }
+
+    std::string fieldOptions(const FieldIdRegistry::Field& field) {
+        std::vector<std::string> options;
+        static const std::set<std::string> packable = { "repeated bool", "repeated int64", "repeated double" };
+        if (packable.count(field.type) || (field.type.rfind("repeated ", 0) == 0 && enumNames.count(field.type.substr(9)))) {
+            options.push_back("packed = true");
+        }
+        if (defaultJsonName(fieldName(field.name)) != field.name) {
+            options.push_back("json_name = \"" + field.name + "\"");
+        }
+        if (options.empty()) {
+            return "";
+        }
+        std::string result = " [";
+        for (size_t i = 0; i < options.size(); ++i) {
+            result += (i > 0 ? ", " : "") + options[i];
+        }
+        return result + "]";
+    }
+};
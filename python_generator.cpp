@@ -1,78 +1,511 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-
-class PythonGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "from typing import List, Optional, Any\n"
-            << "from pydantic import BaseModel, Field\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "from enum import Enum\n\n"
-                        << "class " << name << "(Enum):\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << value << " = \"" << value << "\"\n";
-                    }
-                    outFile << "\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "class " << className << "(BaseModel):\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "# " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << key << ": " << type << " = Field(...)\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << "\n";
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import unittest\n"
-            << "import json\n"
-            << "from " << className.substr(0, 1) + className.substr(1) << " import " << className << "\n\n"
-            << "class Test" << className << "(unittest.TestCase):\n"
-            << std::string(config.indentSize, ' ') << "def test_serialization_deserialization(self):\n"
-            << std::string(config.indentSize * 2, ' ') << "sample_json = " << sampleData.dump() << "\n"
-            << std::string(config.indentSize * 2, ' ') << "obj = " << className << "(**sample_json)\n"
-            << std::string(config.indentSize * 2, ' ') << "serialized = json.loads(obj.json())\n"
-            << std::string(config.indentSize * 2, ' ') << "self.assertEqual(sample_json, serialized)\n\n"
-            << "if __name__ == '__main__':\n"
-            << std::string(config.indentSize, ' ') << "unittest.main()\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Optional[Any]";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "int";
-        if (value.is_number_float()) return "float";
-        if (value.is_string()) return "str";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List[" + toLanguageType(value[0], config) + "]";
-            }
-            return "List[Any]";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "Any";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+class PythonGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        if (config.generateValidation) {
+            outFile << "import re\n";
+        }
+        if (config.stringFormats) {
+            // from_dict parses date-times with datetime.fromisoformat, which accepts a Z from Python 3.11
+            if (config.pythonStyle == "dataclass") {
+                outFile << "import base64\n";
+            }
+            outFile << "import uuid\n"
+                << "from datetime import datetime\n";
+        }
+        if (config.pythonStyle == "dataclass") {
+            // dataclass(slots=True) needs Python 3.10+
+            outFile << "from dataclasses import dataclass\n";
+            if (config.typedArrays) {
+                outFile << "from array import array\n";
+            }
+            outFile << "from typing import List, Optional, Any, Dict" << (config.taggedUnions ? ", Literal, Union" : "") << "\n\n";
+        }
+        else if (isMsgspec(config)) {
+            outFile << "from typing import List, Optional, Any" << (config.taggedUnions ? ", Union" : "") << "\n"
+                << "import msgspec\n\n";
+        }
+        else {
+            outFile << "from typing import List, Optional, Any" << (config.taggedUnions ? ", Annotated, Literal, Union" : "") << "\n"
+                << (config.stringFormats ? "from pydantic import BaseModel, ConfigDict, Field\n\n" : "from pydantic import BaseModel, Field\n\n");
+        }
+    }
+
+    // Mixing in str makes members compare equal to their values; every model style decodes a member
+    // through the value-to-member dict that Enum keeps
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        enums = EnumDefinition::readAll(schema);
+        if (!enums.empty()) {
+            outFile << "from enum import Enum\n\n";
+        }
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::UPPER_SNAKE);
+            outFile << "class " << name << "(str, Enum):\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << std::string(config.indentSize, ' ') << cases[i] << " = " << json(definition.values[i]).dump() << "\n";
+            }
+            outFile << "\n";
+        }
+        if (!enums.empty()) {
+            outFile << "\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        // Nested classes come first so annotations name classes that already exist at module level
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                unions[newClassName] = *tagged;
+                for (const auto& variant : tagged->variants) {
+                    std::string variantClass = newClassName + "_" + variant.name;
+                    variantTags[variantClass] = { tagged->property, variant.tag };
+                    // msgspec writes the tag from the class options and rejects a field of the same name
+                    json fields = *variant.sample;
+                    if (isMsgspec(config)) {
+                        fields.erase(tagged->property);
+                    }
+                    circHandler.addDependency(newClassName, variantClass);
+                    generateClass(variantClass, fields, *variant.schema, outFile, config, circHandler);
+                }
+                generateUnion(newClassName, *tagged, outFile, config);
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+
+        if (config.generateValidation) {
+            generatePatterns(className, data, schema, outFile);
+        }
+
+        if (config.pythonStyle == "dataclass") {
+            outFile << "@dataclass(slots=True)\n"
+                << "class " << className << ":\n";
+        }
+        else if (isMsgspec(config)) {
+            // Decoded JSON never forms reference cycles, so instances can skip GC tracking
+            outFile << "class " << className << "(msgspec.Struct, " << (config.pythonStyle == "msgspec-array" ? "array_like=True, " : "") << "gc=False";
+            if (variantTags.count(className)) {
+                outFile << ", tag_field=" << json(variantTags[className].first).dump() << ", tag=" << json(variantTags[className].second).dump();
+            }
+            outFile << "):\n";
+        }
+        else {
+            outFile << "class " << className << "(BaseModel):\n";
+            // pydantic writes bytes as UTF-8 text unless told otherwise
+            bool bytes = std::any_of(stringFormats[className].begin(), stringFormats[className].end(),
+                [](const auto& field) { return field.second.kind == StringFormat::Kind::BYTES; });
+            if (bytes) {
+                outFile << std::string(config.indentSize, ' ') << "model_config = ConfigDict(ser_json_bytes=\"base64\", val_json_bytes=\"base64\")\n";
+            }
+        }
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "# " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << key << ": " << type << (config.pythonStyle == "pydantic" ? " = Field(...)\n" : "\n");
+        }
+        if (data.empty()) {
+            outFile << std::string(config.indentSize, ' ') << "pass\n";
+        }
+
+        if (config.pythonStyle == "dataclass") {
+            generateDictConversions(className, data, outFile, config);
+        }
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        outFile << "\n";
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        bool arrayLike = config.pythonStyle == "msgspec-array";
+
+        testFile << "import unittest\n"
+            << "import json\n"
+            << "import sys\n"
+            << "import timeit\n";
+        if (isMsgspec(config)) {
+            testFile << "import msgspec\n";
+        }
+        testFile << "from " << className.substr(0, 1) + className.substr(1) << " import " << className << "\n\n";
+        if (arrayLike) {
+            testFile << "# array_like structs encode as positional arrays in field order\n";
+        }
+        testFile << "SAMPLE_JSON = " << json((arrayLike ? arrayForm(sampleData, className) : sampleData).dump()).dump() << "\n";
+        if (arrayLike) {
+            testFile << "OBJECT_JSON = " << json(sampleData.dump()).dump() << "\n";
+        }
+
+        // Decoding of the JSON text `source`
+        std::function<std::string(const std::string&)> decodeFrom;
+        std::string encode;
+        if (config.pythonStyle == "dataclass") {
+            decodeFrom = [&](const std::string& source) { return className + ".from_dict(json.loads(" + source + "))"; };
+            encode = "obj.to_dict()";
+        }
+        else if (isMsgspec(config)) {
+            decodeFrom = [&](const std::string& source) { return "decoder.decode(" + source + ")"; };
+            encode = "json.loads(msgspec.json.encode(obj))";
+        }
+        else if (config.stringFormats) {
+            // Base64 bytes are only decoded when pydantic validates JSON text
+            decodeFrom = [&](const std::string& source) { return className + ".model_validate_json(" + source + ")"; };
+            encode = "json.loads(obj.model_dump_json())";
+        }
+        else {
+            decodeFrom = [&](const std::string& source) { return className + "(**json.loads(" + source + "))"; };
+            encode = "json.loads(obj.json())";
+        }
+        std::string decode = decodeFrom("SAMPLE_JSON");
+
+        testFile << "\nclass Test" << className << "(unittest.TestCase):\n"
+            << indent1 << "def test_serialization_deserialization(self):\n";
+        if (isMsgspec(config)) {
+            testFile << indent2 << "decoder = msgspec.json.Decoder(" << className << ")\n";
+        }
+        testFile << indent2 << "obj = " << decode << "\n";
+        if (config.stringFormats) {
+            // Date-times may come back with a different offset or fraction, so the output is compared with its own round trip
+            testFile << indent2 << "encoded = " << encode << "\n"
+                << indent2 << "obj = " << decodeFrom("json.dumps(encoded)") << "\n"
+                << indent2 << "self.assertEqual(encoded, " << encode << ")\n\n";
+        }
+        else {
+            testFile << indent2 << "self.assertEqual(json.loads(SAMPLE_JSON), " << encode << ")\n\n";
+        }
+        testFile
+            << indent1 << "def test_decode_time_and_size(self):\n"
+            << indent2 << "runs = 10000\n";
+        if (isMsgspec(config)) {
+            testFile << indent2 << "decoder = msgspec.json.Decoder(" << className << ")\n";
+        }
+        testFile << indent2 << "obj = " << decode << "\n"
+            << indent2 << "seconds = timeit.timeit(lambda: " << decode << ", number=runs)\n"
+            << indent2 << "baseline = timeit.timeit(lambda: json.loads(" << (arrayLike ? "OBJECT_JSON" : "SAMPLE_JSON") << "), number=runs)\n"
+            << indent2 << "print(f\"\\n" << className << " (" << config.pythonStyle << "): {seconds / runs * 1e6:.2f} us per decode, \"\n"
+            << indent2 << "      f\"sys.getsizeof {sys.getsizeof(obj)} bytes\")\n"
+            << indent2 << "print(f\"" << className << " (dict): {baseline / runs * 1e6:.2f} us per decode, \"\n"
+            << indent2 << "      f\"sys.getsizeof {sys.getsizeof(json.loads(" << (arrayLike ? "OBJECT_JSON" : "SAMPLE_JSON") << "))} bytes\")\n\n"
+            << "if __name__ == '__main__':\n"
+            << indent1 << "unittest.main()\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Optional[Any]";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "int";
+        if (value.is_number_float()) return "float";
+        if (value.is_string()) return "str";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List[" + toLanguageType(value[0], config) + "]";
+            }
+            return "List[Any]";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "Any";
+    }
+
+private:
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    std::map<std::string, TaggedUnion> unions;
+    // Tag property and value of each union variant
+    std::map<std::string, std::pair<std::string, std::string>> variantTags;
+
+    bool isMsgspec(const Config& config) {
+        return config.pythonStyle == "msgspec" || config.pythonStyle == "msgspec-array";
+    }
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // pydantic and msgspec both look the tag up in a table built from the variants' Literal types or
+    // tag options and validate only the selected class; from_dict does the same with a dict
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string members;
+        for (const auto& variant : tagged.variants) {
+            members += (members.empty() ? "" : ", ") + className + "_" + variant.name;
+        }
+        std::string property = json(tagged.property).dump();
+        if (config.pythonStyle == "pydantic") {
+            outFile << className << " = Annotated[Union[" << members << "], Field(discriminator=" << property << ")]\n\n";
+            return;
+        }
+        outFile << className << " = Union[" << members << "]\n\n";
+        if (config.pythonStyle != "dataclass") {
+            return;
+        }
+        outFile << "_" << className << "_VARIANTS = {\n";
+        for (const auto& variant : tagged.variants) {
+            outFile << indent1 << json(variant.tag).dump() << ": " << className << "_" << variant.name << ",\n";
+        }
+        outFile << "}\n\n"
+            << "def " << className << "_from_dict(data: Optional[Dict[str, Any]]) -> Optional[" << className << "]:\n"
+            << indent1 << "if data is None:\n"
+            << indent2 << "return None\n"
+            << indent1 << "tag = data[" << property << "]\n"
+            << indent1 << "variant = _" << className << "_VARIANTS.get(tag)\n"
+            << indent1 << "if variant is None:\n"
+            << indent2 << "raise ValueError(f\"Unknown " << className << " " << tagged.property << ": {tag!r}\")\n"
+            << indent1 << "return variant.from_dict(data)\n\n";
+    }
+
+    // Element kind of a non-empty array whose items are all numbers: "int32", "int64" or "float64";
+    // empty for anything else
+    std::string numericArrayKind(const json& value) {
+        if (!value.is_array() || value.empty()) return "";
+        bool fitsInt32 = true;
+        for (const auto& item : value) {
+            if (!item.is_number()) return "";
+            if (item.is_number_float()) return "float64";
+            if (item.is_number_unsigned() ? item.get<uint64_t>() > INT32_MAX : item.get<int64_t>() < INT32_MIN || item.get<int64_t>() > INT32_MAX) {
+                fitsInt32 = false;
+            }
+        }
+        return fitsInt32 ? "int32" : "int64";
+    }
+
+    // Packed arrays are only generated where from_dict/to_dict can convert them
+    bool isTypedArray(const json& value, const Config& config) {
+        return config.typedArrays && config.pythonStyle == "dataclass" && !numericArrayKind(value).empty();
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (variantTags.count(className) && variantTags[className].first == key) return "Literal[" + json(variantTags[className].second).dump() + "]";
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "uuid.UUID";
+            case StringFormat::Kind::DATE_TIME: return "datetime";
+            default: return "bytes";
+            }
+        }
+        if (value.is_object()) return config.pythonStyle == "pydantic" ? className + "_" + key : "Optional[" + className + "_" + key + "]";
+        if (isTypedArray(value, config)) return "array";
+        if (value.is_array() && !value.empty()) return "List[" + fieldType(className, key, value[0], config) + "]";
+        return toLanguageType(value, config, key);
+    }
+
+    // The sample re-encoded the way array_like structs expect it: objects become arrays in field order,
+    // and union variants put their tag ahead of the fields
+    json arrayForm(const json& value, const std::string& className) {
+        json result = json::array();
+        if (unions.count(className)) {
+            const TaggedUnion& tagged = unions[className];
+            std::string tag = value[tagged.property].get<std::string>();
+            auto variant = std::find_if(tagged.variants.begin(), tagged.variants.end(), [&](const TaggedUnion::Variant& v) { return v.tag == tag; });
+            result.push_back(tag);
+            for (auto& [key, item] : value.items()) {
+                if (key != tagged.property) {
+                    result.push_back(arrayField(item, className + "_" + variant->name, key));
+                }
+            }
+            return result;
+        }
+        for (auto& [key, item] : value.items()) {
+            result.push_back(arrayField(item, className, key));
+        }
+        return result;
+    }
+
+    json arrayField(const json& value, const std::string& className, const std::string& key) {
+        if (value.is_object()) {
+            return arrayForm(value, className + "_" + key);
+        }
+        if (value.is_array()) {
+            json result = json::array();
+            for (const auto& item : value) {
+                result.push_back(arrayField(item, className, key));
+            }
+            return result;
+        }
+        return value;
+    }
+
+    bool needsConversion(const json& value, const Config& config) {
+        if (value.is_object() || isTypedArray(value, config)) return true;
+        return value.is_array() && !value.empty() && needsConversion(value[0], config);
+    }
+
+    // Expression converting a decoded JSON value into model objects; scalars and scalar lists are used as-is.
+    // Number lists are copied into packed arrays: 8-byte 'q' (the int model has no 32-bit type) or 'd'
+    std::string fromDictExpr(const std::string& source, const std::string& className, const std::string& key, const json& value, int level, const Config& config) {
+        if (value.is_object()) {
+            return className + "_" + key + (unions.count(className + "_" + key) ? "_from_dict(" : ".from_dict(") + source + ")";
+        }
+        if (isTypedArray(value, config)) {
+            return std::string("array('") + (numericArrayKind(value) == "float64" ? "d" : "q") + "', " + source + ")";
+        }
+        if (needsConversion(value, config)) {
+            std::string item = "v" + std::to_string(level);
+            return "[" + fromDictExpr(item, className, key, value[0], level + 1, config) + " for " + item + " in " + source + "]";
+        }
+        return source;
+    }
+
+    std::string toDictExpr(const std::string& source, const json& value, int level, const Config& config) {
+        if (value.is_object()) {
+            return source + ".to_dict()";
+        }
+        if (isTypedArray(value, config)) {
+            return source + ".tolist()";
+        }
+        if (needsConversion(value, config)) {
+            std::string item = "v" + std::to_string(level);
+            return "[" + toDictExpr(item, value[0], level + 1, config) + " for " + item + " in " + source + "]";
+        }
+        return source;
+    }
+
+    // Positional construction and plain subscripting keep from_dict far cheaper than reflective
+    // construction; nested objects return None for a JSON null
+    void generateDictConversions(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "\n"
+            << indent1 << "@classmethod\n"
+            << indent1 << "def from_dict(cls, data: Optional[Dict[str, Any]]) -> Optional[\"" << className << "\"]:\n"
+            << indent2 << "if data is None:\n"
+            << indent3 << "return None\n"
+            << indent2 << "return cls(\n";
+        for (auto& [key, value] : data.items()) {
+            std::string source = "data[\"" + key + "\"]";
+            std::string expr = fromDictExpr(source, className, key, value, 0, config);
+            if (enumFields[className].count(key)) {
+                expr = enumFields[className][key] + "(" + source + ")";
+            }
+            else if (value.is_string() && stringFormats[className].count(key)) {
+                StringFormat::Kind kind = stringFormats[className][key].kind;
+                expr = kind == StringFormat::Kind::UUID ? "uuid.UUID(" + source + ")"
+                    : kind == StringFormat::Kind::DATE_TIME ? "datetime.fromisoformat(" + source + ")"
+                    : "base64.b64decode(" + source + ", validate=True)";
+            }
+            else if (value.is_array() && expr != source) {
+                expr = "None if (_" + key + " := " + source + ") is None else " + fromDictExpr("_" + key, className, key, value, 0, config);
+            }
+            outFile << indent3 << expr << ",\n";
+        }
+        outFile << indent2 << ")\n\n"
+            << indent1 << "def to_dict(self) -> Dict[str, Any]:\n"
+            << indent2 << "return {\n";
+        for (auto& [key, value] : data.items()) {
+            std::string source = "self." + key;
+            std::string expr = enumFields[className].count(key) ? source + ".value" : toDictExpr(source, value, 0, config);
+            if (value.is_string() && stringFormats[className].count(key)) {
+                StringFormat::Kind kind = stringFormats[className][key].kind;
+                expr = kind == StringFormat::Kind::UUID ? "str(" + source + ")"
+                    : kind == StringFormat::Kind::DATE_TIME ? source + ".isoformat()"
+                    : "base64.b64encode(" + source + ").decode(\"ascii\")";
+            }
+            if (expr != source) {
+                expr += " if " + source + " is not None else None";
+            }
+            outFile << indent3 << "\"" << key << "\": " << expr << ",\n";
+        }
+        outFile << indent2 << "}\n";
+    }
+
+    std::string patternName(const std::string& className, const std::string& key) {
+        return "_" + className + "_" + key + "_pattern";
+    }
+
+    // Patterns are compiled once at import time, ahead of the class that uses them
+    void generatePatterns(const std::string& className, const json& data, const json& schema, std::ofstream& outFile) {
+        bool any = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << patternName(className, key) << " = re.compile(" << json(*constraints.pattern).dump() << ")\n";
+                any = true;
+            }
+        }
+        if (any) {
+            outFile << "\n";
+        }
+    }
+
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if " << violation << ":\n"
+                << indent3 << "return False\n";
+        };
+
+        outFile << "\n"
+            << indent1 << "def is_valid(self) -> bool:\n";
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "self." + key;
+            // A formatted field was checked by its parser when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check("len(" + field + ") < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check("len(" + field + ") > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check(patternName(className, key) + ".search(" + field + ") is None");
+            }
+            if (value.is_number()) {
+                if (constraints.minimum) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string candidates;
+                for (const auto& candidate : allowed) {
+                    candidates += (candidates.empty() ? "" : ", ") + candidate.dump();
+                }
+                check(field + " not in (" + candidates + (allowed.size() == 1 ? ",)" : ")"));
+            }
+            if (value.is_array()) {
+                if (constraints.required) check(field + " is None");
+                if (constraints.minItems) check("len(" + field + ") < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check("len(" + field + ") > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent2 << "for item in " << field << " or ():\n"
+                        << indent3 << "if item is not None and not item.is_valid():\n"
+                        << indent4 << "return False\n";
+                }
+            }
+            if (value.is_object()) {
+                if (constraints.required) check(field + " is None");
+                check(field + " is not None and not " + field + ".is_valid()");
+            }
+        }
+        outFile << indent2 << "return True\n";
+    }
+};
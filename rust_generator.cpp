@@ -1,97 +1,649 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class RustGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "use serde::{Serialize, Deserialize};\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "#[derive(Debug, Serialize, Deserialize)]\n"
-                        << "pub enum " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << value << ",\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "#[derive(Debug, Serialize, Deserialize)]\n"
-            << "pub struct " << className << " {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << "#[serde(rename = \"" << key << "\")]\n"
-                << std::string(config.indentSize, ' ') << "pub " << key << ": " << type << ",\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "#[cfg(test)]\n"
-            << "mod tests {\n"
-            << std::string(config.indentSize, ' ') << "use super::*;\n"
-            << std::string(config.indentSize, ' ') << "use serde_json;\n\n"
-            << std::string(config.indentSize, ' ') << "#[test]\n"
-            << std::string(config.indentSize, ' ') << "fn test_" << className << "_serialization_deserialization() {\n"
-            << std::string(config.indentSize * 2, ' ') << "let sample_json = r#\"" << sampleData.dump() << "\"#;\n"
-            << std::string(config.indentSize * 2, ' ') << "let obj: " << className << " = serde_json::from_str(sample_json).unwrap();\n"
-            << std::string(config.indentSize * 2, ' ') << "let serialized = serde_json::to_string(&obj).unwrap();\n"
-            << std::string(config.indentSize * 2, ' ') << "let deserialized: serde_json::Value = serde_json::from_str(&serialized).unwrap();\n"
-            << std::string(config.indentSize * 2, ' ') << "let original: serde_json::Value = serde_json::from_str(sample_json).unwrap();\n"
-            << std::string(config.indentSize * 2, ' ') << "assert_eq!(original, deserialized);\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Option<serde_json::Value>";
-        if (value.is_boolean()) return "bool";
-        if (value.is_number_integer()) return "i64";
-        if (value.is_number_float()) return "f64";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "Vec<" + toLanguageType(value[0], config) + ">";
-            }
-            return "Vec<serde_json::Value>";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "serde_json::Value";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "impl " << className << " {\n"
-            << std::string(config.indentSize, ' ') << "pub fn is_valid(&self) -> bool {\n"
-            << std::string(config.indentSize * 2, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize * 2, ' ') << "true\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+class RustGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        if (!config.borrowStrings) {
+            outFile << "use serde::{Serialize, Deserialize};\n\n";
+            if (config.stringFormats) {
+                generateFormatsRuntime(outFile, config);
+            }
+            return;
+        }
+
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        outFile << "use std::borrow::Cow;\n"
+            << "use serde::{Serialize, Deserialize};\n\n"
+            << "/// String that borrows from the input unless it contains escapes. serde only borrows a\n"
+            << "/// `Cow<'a, str>` held directly by a field, so strings inside collections use this wrapper.\n"
+            << "#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]\n"
+            << "#[serde(transparent)]\n"
+            << "pub struct CowStr<'a>(#[serde(borrow)] pub Cow<'a, str>);\n\n"
+            << "impl std::ops::Deref for CowStr<'_> {\n"
+            << indent1 << "type Target = str;\n\n"
+            << indent1 << "fn deref(&self) -> &str {\n"
+            << indent2 << "&self.0\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+        if (config.stringFormats) {
+            generateFormatsRuntime(outFile, config);
+        }
+    }
+
+    // Unit variants renamed to their JSON values; serde matches them against the input without allocating
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << "#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Serialize, Deserialize)]\n"
+                << "pub enum " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << std::string(config.indentSize, ' ') << "#[serde(rename = " << json(definition.values[i]).dump() << ")]\n"
+                    << std::string(config.indentSize, ' ') << cases[i] << ",\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        // The outermost struct collects the field kinds of all structs nested in it
+        if (!enumFields.count(className)) {
+            collectFieldKinds(className, data, schema, config);
+        }
+        generateStruct(className, data, schema, outFile, config, config.borrowStrings);
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        // Rust has no nested type declarations, so nested structs follow at module level
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                if (unions[className].count(key)) {
+                    generateUnion(newClassName, unions[className][key], outFile, config, config.borrowStrings);
+                    for (const auto& variant : unions[className][key].variants) {
+                        circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                        generateClass(newClassName + "_" + variant.name, variantData[newClassName + "_" + variant.name], *variant.schema, outFile, config, circHandler);
+                    }
+                    continue;
+                }
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "#[cfg(test)]\n"
+            << "mod tests {\n"
+            << std::string(config.indentSize, ' ') << "use super::*;\n"
+            << std::string(config.indentSize, ' ') << "use serde_json;\n\n"
+            << std::string(config.indentSize, ' ') << "#[test]\n"
+            << std::string(config.indentSize, ' ') << "fn test_" << className << "_serialization_deserialization() {\n"
+            << std::string(config.indentSize * 2, ' ') << "let sample_json = r#\"" << sampleData.dump() << "\"#;\n"
+            << std::string(config.indentSize * 2, ' ') << "let obj: " << className << " = serde_json::from_str(sample_json).unwrap();\n"
+            << std::string(config.indentSize * 2, ' ') << "let serialized = serde_json::to_string(&obj).unwrap();\n";
+        if (config.stringFormats) {
+            // Date-times are written back in UTC, so the output is compared with its own round trip
+            testFile << std::string(config.indentSize * 2, ' ') << "let reparsed: " << className << " = serde_json::from_str(&serialized).unwrap();\n"
+                << std::string(config.indentSize * 2, ' ') << "assert_eq!(serialized, serde_json::to_string(&reparsed).unwrap());\n";
+        }
+        else {
+            testFile << std::string(config.indentSize * 2, ' ') << "let deserialized: serde_json::Value = serde_json::from_str(&serialized).unwrap();\n"
+                << std::string(config.indentSize * 2, ' ') << "let original: serde_json::Value = serde_json::from_str(sample_json).unwrap();\n"
+                << std::string(config.indentSize * 2, ' ') << "assert_eq!(original, deserialized);\n";
+        }
+        testFile << std::string(config.indentSize, ' ') << "}\n"
+            << "}\n";
+
+        if (config.borrowStrings) {
+            generateBenchmark(className, sampleData, config);
+        }
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Option<serde_json::Value>";
+        if (value.is_boolean()) return "bool";
+        if (value.is_number_integer()) return "i64";
+        if (value.is_number_float()) return "f64";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "Vec<" + toLanguageType(value[0], config) + ">";
+            }
+            return "Vec<serde_json::Value>";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "serde_json::Value";
+    }
+
+private:
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    std::map<std::string, std::map<std::string, TaggedUnion>> unions;
+    // Fields of each variant struct: the variant's sample without the tag, which the enum reads and writes
+    std::map<std::string, json> variantData;
+    // Whether each struct holds strings, which hasStrings would otherwise find again for every enclosing struct
+    std::map<std::string, bool> stringHolders;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // Enum and string format fields, and unions, of a struct and all structs nested in it; a struct
+    // needs them before its nested structs are generated to know whether it borrows
+    void collectFieldKinds(const std::string& className, const json& data, const json& schema, const Config& config) {
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        for (auto& [key, value] : data.items()) {
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                unions[className][key] = *tagged;
+                for (const auto& variant : tagged->variants) {
+                    std::string variantClass = className + "_" + key + "_" + variant.name;
+                    variantData[variantClass] = *variant.sample;
+                    variantData[variantClass].erase(tagged->property);
+                    collectFieldKinds(variantClass, variantData[variantClass], *variant.schema, config);
+                }
+                continue;
+            }
+            const json* nested = objectSample(value);
+            if (nested) {
+                collectFieldKinds(className + "_" + key, *nested, nestedSchema(schema, key, *nested), config);
+            }
+        }
+    }
+
+    // Whether a field holds strings, directly or through nested objects and arrays, and so needs
+    // the input lifetime when strings are borrowed. Enums and formatted strings never borrow
+    bool hasStrings(const std::string& className, const std::string& key, const json& value) {
+        if (enumFields[className].count(key) || stringFormats[className].count(key)) return false;
+        if (unions[className].count(key)) {
+            const auto& variants = unions[className][key].variants;
+            return std::any_of(variants.begin(), variants.end(), [&](const TaggedUnion::Variant& variant) {
+                std::string variantClass = className + "_" + key + "_" + variant.name;
+                return hasStrings(variantClass, variantData[variantClass]);
+            });
+        }
+        if (value.is_string()) return true;
+        if (value.is_object()) return hasStrings(className + "_" + key, value);
+        return value.is_array() && !value.empty() && hasStrings(className, key, value[0]);
+    }
+
+    bool hasStrings(const std::string& className, const json& data) {
+        auto known = stringHolders.find(className);
+        if (known != stringHolders.end()) return known->second;
+        bool result = false;
+        for (auto& [key, value] : data.items()) {
+            if (hasStrings(className, key, value)) {
+                result = true;
+                break;
+            }
+        }
+        return stringHolders[className] = result;
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config, bool borrowed, bool inCollection = false) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "[u8; 16]";
+            case StringFormat::Kind::DATE_TIME: return "i64";
+            default: return "Vec<u8>";
+            }
+        }
+        if (value.is_object()) return className + "_" + key + (borrowed && hasStrings(className, key, value) ? "<'a>" : "");
+        if (value.is_string() && borrowed) return inCollection ? "CowStr<'a>" : "Cow<'a, str>";
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            return (format.isFloat ? "f" : format.isUnsigned ? "u" : "i") + std::to_string(format.bits);
+        }
+        if (value.is_array() && !value.empty()) return "Vec<" + fieldType(className, key, value[0], config, borrowed, true) + ">";
+        return toLanguageType(value, config, key);
+    }
+
+    // Keys that are Rust keywords become raw identifiers such as r#type; crate, self, Self and super cannot
+    // be raw and take a trailing underscore. The serde rename keeps the JSON key either way
+    std::string fieldName(const std::string& key) {
+        static const std::set<std::string> keywords = {
+            "abstract", "as", "async", "await", "become", "box", "break", "const", "continue", "do", "dyn", "else",
+            "enum", "extern", "false", "final", "fn", "for", "gen", "if", "impl", "in", "let", "loop", "macro",
+            "match", "mod", "move", "mut", "override", "priv", "pub", "ref", "return", "static", "struct", "trait",
+            "true", "try", "type", "typeof", "unsafe", "unsized", "use", "virtual", "where", "while", "yield"
+        };
+        static const std::set<std::string> notRaw = { "crate", "self", "Self", "super" };
+        if (notRaw.count(key)) return key + "_";
+        return keywords.count(key) ? "r#" + key : key;
+    }
+
+    void generateStruct(const std::string& className, const json& data, const json& schema, std::ostream& outFile, const Config& config, bool borrowed) {
+        bool lifetime = borrowed && hasStrings(className, data);
+        if (className.find('_') != std::string::npos) {
+            outFile << "#[allow(non_camel_case_types)]\n";
+        }
+        outFile << "#[derive(Debug, Serialize, Deserialize)]\n"
+            << "pub struct " << className << (lifetime ? "<'a>" : "") << " {\n";
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config, borrowed);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"] << "\n";
+            }
+            // Without borrow, serde deserializes a Cow as owned and does not tie nested lifetimes to the input
+            outFile << std::string(config.indentSize, ' ') << "#[serde(rename = \"" << key << "\"" << (borrowed && hasStrings(className, key, value) ? ", borrow" : "") << formatAdapter(className, key, value) << ")]\n"
+                << std::string(config.indentSize, ' ') << "pub " << fieldName(key) << ": " << type << ",\n";
+        }
+
+        outFile << "}\n\n";
+    }
+
+    // serde reads the tag of an internally tagged enum before the variant's fields, wherever it is in the
+    // object, and writes it first. Each variant wraps a struct that has every field but the tag
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ostream& outFile, const Config& config, bool borrowed) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        bool lifetime = false;
+        for (const auto& variant : tagged.variants) {
+            lifetime = lifetime || (borrowed && hasStrings(className + "_" + variant.name, variantData[className + "_" + variant.name]));
+        }
+        outFile << "#[allow(non_camel_case_types)]\n"
+            << "#[derive(Debug, Serialize, Deserialize)]\n"
+            << "#[serde(tag = " << json(tagged.property).dump() << ")]\n"
+            << "pub enum " << className << (lifetime ? "<'a>" : "") << " {\n";
+        for (const auto& variant : tagged.variants) {
+            std::string variantClass = className + "_" + variant.name;
+            bool borrows = borrowed && hasStrings(variantClass, variantData[variantClass]);
+            outFile << indent1 << "#[serde(rename = " << json(variant.tag).dump() << (borrows ? ", borrow" : "") << ")]\n"
+                << indent1 << variant.name << "(" << variantClass << (borrows ? "<'a>" : "") << "),\n";
+        }
+        outFile << "}\n\n";
+
+        if (config.generateValidation && borrowed == config.borrowStrings) {
+            outFile << "impl " << className << (lifetime ? "<'_>" : "") << " {\n"
+                << indent1 << "pub fn is_valid(&self) -> bool {\n"
+                << indent2 << "match self {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent3 << "Self::" << variant.name << "(variant) => variant.is_valid(),\n";
+            }
+            outFile << indent2 << "}\n"
+                << indent1 << "}\n"
+                << "}\n\n";
+        }
+    }
+
+    std::string formatAdapter(const std::string& className, const std::string& key, const json& value) {
+        if (!value.is_string() || !stringFormats[className].count(key)) return "";
+        switch (stringFormats[className][key].kind) {
+        case StringFormat::Kind::UUID: return ", with = \"json_model_formats::uuid\"";
+        case StringFormat::Kind::DATE_TIME: return ", with = \"json_model_formats::timestamp\"";
+        default: return ", with = \"json_model_formats::base64\"";
+        }
+    }
+
+    // serde_json has no hook for string formats, so each compact type gets a `with` module. The
+    // parsers work on the borrowed input text and never build an intermediate String
+    void generateFormatsRuntime(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+        std::string indent6(config.indentSize * 6, ' ');
+        outFile << "/// Serde adapters for string formats, used through `#[serde(with = ...)]`. A UUID is kept as its 16 bytes,\n"
+            << "/// an RFC 3339 date-time as microseconds since the Unix epoch in UTC and base64 as the decoded bytes.\n"
+            << "/// JSON still carries text, written back as lower-case hex, UTC with a Z (milliseconds when exact) and\n"
+            << "/// padded base64.\n"
+            << "pub mod json_model_formats {\n"
+            << indent1 << "use serde::de::{self, Deserializer, Visitor};\n"
+            << indent1 << "use serde::Serializer;\n"
+            << indent1 << "use std::fmt;\n\n"
+            << indent1 << "/// Hands the string to a parser; serde_json only copies it when the input has escapes\n"
+            << indent1 << "struct Parse<F>(F, &'static str);\n\n"
+            << indent1 << "impl<'de, T, F: FnOnce(&[u8]) -> Option<T>> Visitor<'de> for Parse<F> {\n"
+            << indent2 << "type Value = T;\n\n"
+            << indent2 << "fn expecting(&self, formatter: &mut fmt::Formatter) -> fmt::Result {\n"
+            << indent3 << "formatter.write_str(self.1)\n"
+            << indent2 << "}\n\n"
+            << indent2 << "fn visit_str<E: de::Error>(self, text: &str) -> Result<T, E> {\n"
+            << indent3 << "let expected = self.1;\n"
+            << indent3 << "(self.0)(text.as_bytes()).ok_or_else(|| E::invalid_value(de::Unexpected::Str(text), &expected))\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "fn digits(text: &[u8], pos: usize, count: usize) -> Option<i64> {\n"
+            << indent2 << "text[pos..pos + count].iter().try_fold(0, |n, &c| c.is_ascii_digit().then(|| n * 10 + i64::from(c - b'0')))\n"
+            << indent1 << "}\n\n"
+            << indent1 << "fn put_digits(text: &mut [u8], pos: usize, mut value: i64, width: usize) -> usize {\n"
+            << indent2 << "for i in (pos..pos + width).rev() {\n"
+            << indent3 << "text[i] = b'0' + (value % 10) as u8;\n"
+            << indent3 << "value /= 10;\n"
+            << indent2 << "}\n"
+            << indent2 << "pos + width\n"
+            << indent1 << "}\n\n"
+            << indent1 << "pub mod uuid {\n"
+            << indent2 << "use super::*;\n\n"
+            << indent2 << "fn hex_value(c: u8) -> u8 {\n"
+            << indent3 << "match c {\n"
+            << indent4 << "b'0'..=b'9' => c - b'0',\n"
+            << indent4 << "b'a'..=b'f' => c - b'a' + 10,\n"
+            << indent4 << "b'A'..=b'F' => c - b'A' + 10,\n"
+            << indent4 << "_ => 0xFF,\n"
+            << indent3 << "}\n"
+            << indent2 << "}\n\n"
+            << indent2 << "fn parse(text: &[u8]) -> Option<[u8; 16]> {\n"
+            << indent3 << "if text.len() != 36 || text[8] != b'-' || text[13] != b'-' || text[18] != b'-' || text[23] != b'-' {\n"
+            << indent4 << "return None;\n"
+            << indent3 << "}\n"
+            << indent3 << "let mut value = [0u8; 16];\n"
+            << indent3 << "let mut bad = 0;\n"
+            << indent3 << "let mut pos = 0;\n"
+            << indent3 << "for byte in value.iter_mut() {\n"
+            << indent4 << "if matches!(pos, 8 | 13 | 18 | 23) {\n"
+            << indent5 << "pos += 1;\n"
+            << indent4 << "}\n"
+            << indent4 << "let (high, low) = (hex_value(text[pos]), hex_value(text[pos + 1]));\n"
+            << indent4 << "bad |= high | low;\n"
+            << indent4 << "*byte = (high & 0xF) << 4 | (low & 0xF);\n"
+            << indent4 << "pos += 2;\n"
+            << indent3 << "}\n"
+            << indent3 << "(bad & 0xF0 == 0).then_some(value)\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn serialize<S: Serializer>(value: &[u8; 16], serializer: S) -> Result<S::Ok, S::Error> {\n"
+            << indent3 << "const HEX: &[u8; 16] = b\"0123456789abcdef\";\n"
+            << indent3 << "let mut text = [b'-'; 36];\n"
+            << indent3 << "let mut pos = 0;\n"
+            << indent3 << "for (i, byte) in value.iter().enumerate() {\n"
+            << indent4 << "if matches!(i, 4 | 6 | 8 | 10) {\n"
+            << indent5 << "pos += 1;\n"
+            << indent4 << "}\n"
+            << indent4 << "text[pos] = HEX[usize::from(byte >> 4)];\n"
+            << indent4 << "text[pos + 1] = HEX[usize::from(byte & 0xF)];\n"
+            << indent4 << "pos += 2;\n"
+            << indent3 << "}\n"
+            << indent3 << "serializer.serialize_str(std::str::from_utf8(&text).unwrap())\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn deserialize<'de, D: Deserializer<'de>>(deserializer: D) -> Result<[u8; 16], D::Error> {\n"
+            << indent3 << "deserializer.deserialize_str(Parse(parse, \"a UUID\"))\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "pub mod timestamp {\n"
+            << indent2 << "use super::*;\n\n"
+            << indent2 << "const MONTH_LENGTHS: [i64; 12] = [31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31];\n\n"
+            << indent2 << "/// YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM); digits past microseconds are truncated\n"
+            << indent2 << "fn parse(text: &[u8]) -> Option<i64> {\n"
+            << indent3 << "if text.len() < 20 || text[4] != b'-' || text[7] != b'-' || !matches!(text[10], b'T' | b't') || text[13] != b':' || text[16] != b':' {\n"
+            << indent4 << "return None;\n"
+            << indent3 << "}\n"
+            << indent3 << "let (year, month, day) = (digits(text, 0, 4)?, digits(text, 5, 2)?, digits(text, 8, 2)?);\n"
+            << indent3 << "let (hour, minute, second) = (digits(text, 11, 2)?, digits(text, 14, 2)?, digits(text, 17, 2)?);\n"
+            << indent3 << "let leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);\n"
+            << indent3 << "if !(1..=12).contains(&month) || day < 1 || day > MONTH_LENGTHS[month as usize - 1] || (month == 2 && day == 29 && !leap)\n"
+            << indent4 << "|| hour > 23 || minute > 59 || second > 59 {\n"
+            << indent4 << "return None;\n"
+            << indent3 << "}\n"
+            << indent3 << "let mut pos = 19;\n"
+            << indent3 << "let mut micros = 0;\n"
+            << indent3 << "if text[pos] == b'.' {\n"
+            << indent4 << "pos += 1;\n"
+            << indent4 << "let first = pos;\n"
+            << indent4 << "let mut scale = 100_000;\n"
+            << indent4 << "while pos < text.len() && text[pos].is_ascii_digit() {\n"
+            << indent5 << "micros += i64::from(text[pos] - b'0') * scale;\n"
+            << indent5 << "scale /= 10;\n"
+            << indent5 << "pos += 1;\n"
+            << indent4 << "}\n"
+            << indent4 << "if pos == first {\n"
+            << indent5 << "return None;\n"
+            << indent4 << "}\n"
+            << indent3 << "}\n"
+            << indent3 << "let offset = match &text[pos..] {\n"
+            << indent4 << "[b'Z' | b'z'] => 0,\n"
+            << indent4 << "[sign @ (b'+' | b'-'), _, _, b':', _, _] => {\n"
+            << indent5 << "let (hours, minutes) = (digits(text, pos + 1, 2)?, digits(text, pos + 4, 2)?);\n"
+            << indent5 << "if hours > 23 || minutes > 59 {\n"
+            << indent6 << "return None;\n"
+            << indent5 << "}\n"
+            << indent5 << "(hours * 60 + minutes) * if *sign == b'-' { -1 } else { 1 }\n"
+            << indent4 << "}\n"
+            << indent4 << "_ => return None,\n"
+            << indent3 << "};\n"
+            << indent3 << "// Days between 1970-01-01 and the proleptic Gregorian date\n"
+            << indent3 << "let shifted_year = if month <= 2 { year - 1 } else { year };\n"
+            << indent3 << "let (era, year_of_era) = (shifted_year.div_euclid(400), shifted_year.rem_euclid(400));\n"
+            << indent3 << "let day_of_year = (153 * if month > 2 { month - 3 } else { month + 9 } + 2) / 5 + day - 1;\n"
+            << indent3 << "let days = era * 146_097 + year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year - 719_468;\n"
+            << indent3 << "Some((days * 86_400 + hour * 3600 + minute * 60 + second - offset * 60) * 1_000_000 + micros)\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn serialize<S: Serializer>(value: &i64, serializer: S) -> Result<S::Ok, S::Error> {\n"
+            << indent3 << "let (seconds, micros) = (value.div_euclid(1_000_000), value.rem_euclid(1_000_000));\n"
+            << indent3 << "let (days, time) = (seconds.div_euclid(86_400) + 719_468, seconds.rem_euclid(86_400));\n"
+            << indent3 << "let (era, day_of_era) = (days.div_euclid(146_097), days.rem_euclid(146_097));\n"
+            << indent3 << "let year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36_524 - day_of_era / 146_096) / 365;\n"
+            << indent3 << "let day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);\n"
+            << indent3 << "let shifted_month = (5 * day_of_year + 2) / 153;\n"
+            << indent3 << "let day = day_of_year - (153 * shifted_month + 2) / 5 + 1;\n"
+            << indent3 << "let month = if shifted_month < 10 { shifted_month + 3 } else { shifted_month - 9 };\n"
+            << indent3 << "let year = year_of_era + era * 400 + i64::from(month <= 2);\n\n"
+            << indent3 << "let mut text = *b\"0000-00-00T00:00:00.000000Z\";\n"
+            << indent3 << "put_digits(&mut text, 0, year, 4);\n"
+            << indent3 << "put_digits(&mut text, 5, month, 2);\n"
+            << indent3 << "put_digits(&mut text, 8, day, 2);\n"
+            << indent3 << "put_digits(&mut text, 11, time / 3600, 2);\n"
+            << indent3 << "put_digits(&mut text, 14, time / 60 % 60, 2);\n"
+            << indent3 << "let mut end = put_digits(&mut text, 17, time % 60, 2);\n"
+            << indent3 << "if micros != 0 {\n"
+            << indent4 << "end = if micros % 1000 == 0 { put_digits(&mut text, 20, micros / 1000, 3) } else { put_digits(&mut text, 20, micros, 6) };\n"
+            << indent3 << "}\n"
+            << indent3 << "text[end] = b'Z';\n"
+            << indent3 << "serializer.serialize_str(std::str::from_utf8(&text[..=end]).unwrap())\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn deserialize<'de, D: Deserializer<'de>>(deserializer: D) -> Result<i64, D::Error> {\n"
+            << indent3 << "deserializer.deserialize_str(Parse(parse, \"an RFC 3339 date-time\"))\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "pub mod base64 {\n"
+            << indent2 << "use super::*;\n\n"
+            << indent2 << "const SYMBOLS: &[u8; 64] = b\"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/\";\n\n"
+            << indent2 << "/// Six-bit value of each base64 symbol, 0xFF for anything else\n"
+            << indent2 << "const VALUES: [u8; 256] = {\n"
+            << indent3 << "let mut table = [0xFF; 256];\n"
+            << indent3 << "let mut i = 0;\n"
+            << indent3 << "while i < 64 {\n"
+            << indent4 << "table[SYMBOLS[i] as usize] = i as u8;\n"
+            << indent4 << "i += 1;\n"
+            << indent3 << "}\n"
+            << indent3 << "table\n"
+            << indent2 << "};\n\n"
+            << indent2 << "/// Invalid symbols are OR-ed into one flag and checked once, which keeps the loop free of branches\n"
+            << indent2 << "fn parse(text: &[u8]) -> Option<Vec<u8>> {\n"
+            << indent3 << "if text.len() % 4 != 0 {\n"
+            << indent4 << "return None;\n"
+            << indent3 << "}\n"
+            << indent3 << "let padding = text.iter().rev().take(2).take_while(|&&c| c == b'=').count();\n"
+            << indent3 << "let mut bytes = Vec::with_capacity(text.len() / 4 * 3);\n"
+            << indent3 << "let mut bad = 0;\n"
+            << indent3 << "for (index, chunk) in text.chunks(4).enumerate() {\n"
+            << indent4 << "let kept = if (index + 1) * 4 == text.len() { 4 - padding } else { 4 };\n"
+            << indent4 << "let mut n = 0u32;\n"
+            << indent4 << "for (i, &c) in chunk[..kept].iter().enumerate() {\n"
+            << indent5 << "let value = VALUES[usize::from(c)];\n"
+            << indent5 << "bad |= value;\n"
+            << indent5 << "n |= u32::from(value & 0x3F) << (18 - 6 * i);\n"
+            << indent4 << "}\n"
+            << indent4 << "bytes.extend_from_slice(&n.to_be_bytes()[1..kept]);\n"
+            << indent3 << "}\n"
+            << indent3 << "(bad & 0x80 == 0).then_some(bytes)\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn serialize<S: Serializer>(value: &[u8], serializer: S) -> Result<S::Ok, S::Error> {\n"
+            << indent3 << "let mut text = Vec::with_capacity((value.len() + 2) / 3 * 4);\n"
+            << indent3 << "for chunk in value.chunks(3) {\n"
+            << indent4 << "let n = chunk.iter().enumerate().fold(0u32, |n, (i, &b)| n | u32::from(b) << (16 - 8 * i));\n"
+            << indent4 << "for i in 0..4 {\n"
+            << indent5 << "text.push(if i <= chunk.len() { SYMBOLS[(n >> (18 - 6 * i) & 0x3F) as usize] } else { b'=' });\n"
+            << indent4 << "}\n"
+            << indent3 << "}\n"
+            << indent3 << "serializer.serialize_str(std::str::from_utf8(&text).unwrap())\n"
+            << indent2 << "}\n\n"
+            << indent2 << "pub fn deserialize<'de, D: Deserializer<'de>>(deserializer: D) -> Result<Vec<u8>, D::Error> {\n"
+            << indent3 << "deserializer.deserialize_str(Parse(parse, \"base64 text\"))\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n"
+            << "}\n";
+    }
+
+    // The owned counterpart of every struct, for benchmarking against the borrowed model
+    void generateOwnedStructs(const std::string& className, const json& data, std::ostream& outFile, const Config& config) {
+        generateStruct(className, data, json::object(), outFile, config, false);
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            if (nested && unions[className].count(key)) {
+                std::string unionClass = className + "_" + key;
+                generateUnion(unionClass, unions[className][key], outFile, config, false);
+                for (const auto& variant : unions[className][key].variants) {
+                    generateOwnedStructs(unionClass + "_" + variant.name, variantData[unionClass + "_" + variant.name], outFile, config);
+                }
+            }
+            else if (nested) {
+                generateOwnedStructs(className + "_" + key, *nested, outFile, config);
+            }
+        }
+    }
+
+    // Criterion sources are written next to the model as <Class>_bench.rs; they include the model by path
+    void generateBenchmark(const std::string& className, const json& sampleData, const Config& config) {
+        size_t slash = config.outputFile.find_last_of("/\\");
+        std::string directory = config.outputFile.substr(0, slash + 1);
+        std::string modelFile = config.outputFile.substr(slash + 1);
+        std::ofstream benchFile(directory + className + "_bench.rs");
+        if (!benchFile.is_open()) {
+            return;
+        }
+
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::ostringstream owned;
+        generateOwnedStructs(className, sampleData, owned, config);
+
+        benchFile << "// Owned versus borrowed decoding of the " << className << " sample. Register it in Cargo.toml:\n"
+            << "//   [dev-dependencies]\n"
+            << "//   criterion = \"0.5\"\n"
+            << "//   [[bench]]\n"
+            << "//   name = \"" << className << "_bench\"\n"
+            << "//   path = \"" << directory << className << "_bench.rs\"\n"
+            << "//   harness = false\n"
+            << "#![allow(dead_code)]\n\n"
+            << "use criterion::{black_box, criterion_group, criterion_main, Criterion};\n\n"
+            << "#[path = \"" << modelFile << "\"]\n"
+            << "mod borrowed;\n\n"
+            << "mod owned {\n"
+            << indent1 << "use serde::{Serialize, Deserialize};\n";
+        if (!enums.empty() || config.stringFormats) {
+            // Enums and format adapters are shared; the owned structs below shadow the borrowed ones of the glob import
+            benchFile << indent1 << "#[allow(unused_imports)]\n"
+                << indent1 << "use super::borrowed::*;\n";
+        }
+        benchFile << "\n";
+        std::string ownedStructs = owned.str();
+        ownedStructs.erase(ownedStructs.find_last_not_of('\n') + 1);
+        std::istringstream lines(ownedStructs);
+        std::string line;
+        while (std::getline(lines, line)) {
+            benchFile << (line.empty() ? "" : indent1 + line) << "\n";
+        }
+        benchFile << "}\n\n"
+            << "const SAMPLE_JSON: &str = r#\"" << sampleData.dump() << "\"#;\n\n"
+            << "fn decode(c: &mut Criterion) {\n"
+            << indent1 << "let mut group = c.benchmark_group(\"" << className << " decode\");\n"
+            << indent1 << "group.bench_function(\"owned\", |b| {\n"
+            << indent2 << "b.iter(|| serde_json::from_str::<owned::" << className << ">(black_box(SAMPLE_JSON)).unwrap())\n"
+            << indent1 << "});\n"
+            << indent1 << "group.bench_function(\"borrowed\", |b| {\n"
+            << indent2 << "b.iter(|| serde_json::from_str::<borrowed::" << className << ">(black_box(SAMPLE_JSON)).unwrap())\n"
+            << indent1 << "});\n"
+            << indent1 << "group.finish();\n"
+            << "}\n\n"
+            << "criterion_group!(benches, decode);\n"
+            << "criterion_main!(benches);\n";
+    }
+
+    // Serde already rejects missing fields and nulls, so `required` needs no check here. Patterns are
+    // compiled on first use into statics of the method (this needs the regex crate); lengths count chars
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if " << violation << " {\n"
+                << indent3 << "return false;\n"
+                << indent2 << "}\n";
+        };
+
+        outFile << "impl " << className << (config.borrowStrings && hasStrings(className, data) ? "<'_>" : "") << " {\n"
+            << indent1 << "pub fn is_valid(&self) -> bool {\n";
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "self." + fieldName(key);
+            // A formatted field was checked by its parser when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check(field + ".chars().count() < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(field + ".chars().count() > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) {
+                    std::string name = key;
+                    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_'; });
+                    name += "_PATTERN";
+                    std::string fence = "#";
+                    while (constraints.pattern->find("\"" + fence) != std::string::npos) {
+                        fence += "#";
+                    }
+                    outFile << indent2 << "static " << name << ": std::sync::OnceLock<regex::Regex> = std::sync::OnceLock::new();\n";
+                    check("!" + name + ".get_or_init(|| regex::Regex::new(r" + fence + "\"" + *constraints.pattern + "\"" + fence + ").unwrap()).is_match(&" + field + ")");
+                }
+            }
+            if (value.is_number()) {
+                // rustc warns about comparisons the type limits decide (unused_comparisons), so those are left out
+                const NumberFormat& format = numberFormats[className][key];
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + field + " != " + (value.is_number_float() ? FieldConstraints::boundLiteral(candidate.get<double>(), false, true) : candidate.dump());
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(field + ".len() < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(field + ".len() > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    check("!" + field + ".iter().all(|item| item.is_valid())");
+                }
+            }
+            if (value.is_object()) {
+                check("!" + field + ".is_valid()");
+            }
+        }
+        outFile << indent2 << "true\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+};
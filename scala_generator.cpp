@@ -1,127 +1,444 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class ScalaGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "import io.circe.{Decoder, Encoder}\n"
-            << "import io.circe.generic.semiauto.{deriveDecoder, deriveEncoder}\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "sealed trait " << name << "\n"
-                        << "object " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << "case object " << value << " extends " << name << "\n";
-                    }
-                    outFile << std::string(config.indentSize, ' ') << "implicit val encoder: Encoder[" << name << "] = Encoder.encodeString.contramap {\n"
-                        << std::string(config.indentSize * 2, ' ') << "case ";
-                    for (size_t i = 0; i < def["enum"].size(); ++i) {
-                        outFile << def["enum"][i] << " => \"" << def["enum"][i] << "\"";
-                        if (i < def["enum"].size() - 1) {
-                            outFile << "\n" << std::string(config.indentSize * 2, ' ') << "case ";
-                        }
-                    }
-                    outFile << "\n" << std::string(config.indentSize, ' ') << "}\n";
-                    outFile << std::string(config.indentSize, ' ') << "implicit val decoder: Decoder[" << name << "] = Decoder.decodeString.emap {\n"
-                        << std::string(config.indentSize * 2, ' ') << "case ";
-                    for (size_t i = 0; i < def["enum"].size(); ++i) {
-                        outFile << "\"" << def["enum"][i] << "\" => Right(" << def["enum"][i] << ")";
-                        if (i < def["enum"].size() - 1) {
-                            outFile << "\n" << std::string(config.indentSize * 2, ' ') << "case ";
-                        }
-                    }
-                    outFile << "\n" << std::string(config.indentSize * 2, ' ') << "case _ => Left(\"Invalid " << name << "\")\n"
-                        << std::string(config.indentSize, ' ') << "}\n";
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "case class " << className << "(\n";
-
-        for (auto it = data.begin(); it != data.end(); ++it) {
-            std::string key = it.key();
-            json value = it.value();
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/** " << schema["properties"][key]["description"] << " */\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << key << ": " << type;
-            if (std::next(it) != data.end()) {
-                outFile << ",";
-            }
-            outFile << "\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << ")\n\n";
-        outFile << "object " << className << " {\n"
-            << std::string(config.indentSize, ' ') << "implicit val encoder: Encoder[" << className << "] = deriveEncoder\n"
-            << std::string(config.indentSize, ' ') << "implicit val decoder: Decoder[" << className << "] = deriveDecoder\n"
-            << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import org.scalatest.flatspec.AnyFlatSpec\n"
-            << "import org.scalatest.matchers.should.Matchers\n"
-            << "import io.circe.parser._\n"
-            << "import io.circe.syntax._\n\n"
-            << "class " << className << "Spec extends AnyFlatSpec with Matchers {\n\n"
-            << std::string(config.indentSize, ' ') << "\"" << className << "\" should \"serialize and deserialize correctly\" in {\n"
-            << std::string(config.indentSize * 2, ' ') << "val sampleJson = \"\"\"" << sampleData.dump() << "\"\"\"\n"
-            << std::string(config.indentSize * 2, ' ') << "val decoded = decode[" << className << "](sampleJson)\n"
-            << std::string(config.indentSize * 2, ' ') << "decoded.isRight shouldBe true\n"
-            << std::string(config.indentSize * 2, ' ') << "val obj = decoded.right.get\n"
-            << std::string(config.indentSize * 2, ' ') << "val encoded = obj.asJson.noSpaces\n"
-            << std::string(config.indentSize * 2, ' ') << "val reDecoded = decode[" << className << "](encoded)\n"
-            << std::string(config.indentSize * 2, ' ') << "reDecoded.isRight shouldBe true\n"
-            << std::string(config.indentSize * 2, ' ') << "reDecoded.right.get shouldBe obj\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Option[Any]";
-        if (value.is_boolean()) return "Boolean";
-        if (value.is_number_integer()) return "Int";
-        if (value.is_number_float()) return "Double";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "List[" + toLanguageType(value[0], config) + "]";
-            }
-            return "List[Any]";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "Any";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "trait " << className << "Validator {\n"
-            << std::string(config.indentSize, ' ') << "def isValid(obj: " << className << "): Boolean = {\n"
-            << std::string(config.indentSize * 2, ' ') << "// TODO: Implement validation logic\n"
-            << std::string(config.indentSize * 2, ' ') << "true\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class ScalaGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        if (config.staticCodecs) {
+            std::string indent1(config.indentSize, ' ');
+            std::string indent2(config.indentSize * 2, ' ');
+            outFile << "import java.nio.charset.StandardCharsets.UTF_8\n"
+                << "import com.github.plokhotnyuk.jsoniter_scala.core._\n"
+                << "import com.github.plokhotnyuk.jsoniter_scala.macros._\n\n"
+                << "// Untyped values are kept as raw JSON text\n"
+                << "final case class RawJson(value: String)\n\n"
+                << "object RawJson {\n"
+                << indent1 << "implicit val codec: JsonValueCodec[RawJson] = new JsonValueCodec[RawJson] {\n"
+                << indent2 << "def decodeValue(in: JsonReader, default: RawJson): RawJson = RawJson(new String(in.readRawValAsBytes(), UTF_8))\n"
+                << indent2 << "def encodeValue(x: RawJson, out: JsonWriter): Unit = out.writeRawVal(x.value.getBytes(UTF_8))\n"
+                << indent2 << "def nullValue: RawJson = null\n"
+                << indent1 << "}\n"
+                << "}\n\n";
+        }
+        else {
+            outFile << "import io.circe.{Decoder, Encoder}\n"
+                << "import io.circe.generic.semiauto.{deriveDecoder, deriveEncoder}\n\n";
+        }
+        if (config.stringFormats) {
+            generateFormatCodecs(outFile, config);
+        }
+    }
+
+    // Case objects carry their JSON value; decoding is a single match on the string
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << "sealed abstract class " << name << "(val value: String)\n\n"
+                << "object " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent1 << "case object " << cases[i] << " extends " << name << "(" << scalaString(definition.values[i]) << ")\n";
+            }
+            outFile << "\n";
+            auto generateMatch = [&](const std::string& pad, const std::string& wrap, const std::string& fallback) {
+                for (size_t i = 0; i < cases.size(); ++i) {
+                    outFile << pad << "case " << scalaString(definition.values[i]) << " => " << (wrap.empty() ? cases[i] : wrap + "(" + cases[i] + ")") << "\n";
+                }
+                outFile << pad << fallback << "\n";
+            };
+            if (config.staticCodecs) {
+                outFile << indent1 << "implicit val codec: JsonValueCodec[" << name << "] = new JsonValueCodec[" << name << "] {\n"
+                    << indent2 << "def decodeValue(in: JsonReader, default: " << name << "): " << name << " = in.readString(null) match {\n";
+                generateMatch(indent3, "", "case null => default");
+                outFile << indent3 << "case _ => in.decodeError(\"illegal " << name << " value\")\n"
+                    << indent2 << "}\n\n"
+                    << indent2 << "def encodeValue(x: " << name << ", out: JsonWriter): Unit = out.writeVal(x.value)\n\n"
+                    << indent2 << "def nullValue: " << name << " = null\n"
+                    << indent1 << "}\n";
+            }
+            else {
+                outFile << indent1 << "implicit val encoder: Encoder[" << name << "] = Encoder.encodeString.contramap(_.value)\n"
+                    << indent1 << "implicit val decoder: Decoder[" << name << "] = Decoder.decodeString.emap {\n";
+                generateMatch(indent2, "Right", "case other => Left(s\"Invalid " + name + ": $other\")");
+                outFile << indent1 << "}\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+        // A variant extends its sealed union, which a value class cannot
+        if (depth > 0 && config.valueTypes && config.staticCodecs && !variantOf.count(className) && isValueClass(className, data)) {
+            generateValueClass(className, data, outFile, config);
+        }
+        else {
+            if (config.staticCodecs && variantOf.count(className)) {
+                outFile << "@named(" << scalaString(variantOf[className].second) << ")\n";
+            }
+            outFile << "case class " << className << "(\n";
+
+            for (auto it = data.begin(); it != data.end(); ++it) {
+                std::string key = it.key();
+                const json& value = it.value();
+                std::string type = fieldType(className, key, value, config);
+                if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                    outFile << std::string(config.indentSize, ' ') << "/** " << schema["properties"][key]["description"] << " */\n";
+                }
+                outFile << std::string(config.indentSize, ' ') << identifier(key) << ": " << type;
+                if (std::next(it) != data.end()) {
+                    outFile << ",";
+                }
+                outFile << "\n";
+            }
+
+            outFile << ")" << (variantOf.count(className) ? " extends " + variantOf[className].first : "") << "\n\n";
+            outFile << "object " << className << " {\n";
+            if (config.staticCodecs) {
+                outFile << std::string(config.indentSize, ' ') << "implicit val codec: JsonValueCodec[" << className << "] = JsonCodecMaker.make\n";
+            }
+            else {
+                outFile << std::string(config.indentSize, ' ') << "implicit val encoder: Encoder[" << className << "] = deriveEncoder\n"
+                    << std::string(config.indentSize, ' ') << "implicit val decoder: Decoder[" << className << "] = deriveDecoder\n";
+            }
+            outFile << "}\n\n";
+        }
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        // Nested case classes are top-level declarations following their parent
+        ++depth;
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    // jsoniter-scala writes the discriminator itself and rejects a field of the same name
+                    json fields = *variant.sample;
+                    if (config.staticCodecs) {
+                        fields.erase(tagged->property);
+                    }
+                    variantOf[newClassName + "_" + variant.name] = { newClassName, variant.tag };
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, fields, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+        --depth;
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        if (config.staticCodecs) {
+            testFile << "import org.scalatest.flatspec.AnyFlatSpec\n"
+                << "import org.scalatest.matchers.should.Matchers\n"
+                << "import com.github.plokhotnyuk.jsoniter_scala.core._\n\n"
+                << "class " << className << "Spec extends AnyFlatSpec with Matchers {\n\n"
+                << std::string(config.indentSize, ' ') << "\"" << className << "\" should \"serialize and deserialize correctly\" in {\n"
+                << std::string(config.indentSize * 2, ' ') << "val sampleJson = \"\"\"" << sampleData.dump() << "\"\"\"\n"
+                << std::string(config.indentSize * 2, ' ') << "val obj = readFromString[" << className << "](sampleJson)\n"
+                << std::string(config.indentSize * 2, ' ') << "val encoded = writeToString(obj)\n"
+                // Array[Byte] fields compare by reference, so formats compare the encodings
+                << std::string(config.indentSize * 2, ' ') << (config.stringFormats ? "writeToString(readFromString[" + className + "](encoded)) shouldBe encoded\n" : "readFromString[" + className + "](encoded) shouldBe obj\n")
+                << std::string(config.indentSize, ' ') << "}\n"
+                << "}\n";
+            return;
+        }
+        testFile << "import org.scalatest.flatspec.AnyFlatSpec\n"
+            << "import org.scalatest.matchers.should.Matchers\n"
+            << "import io.circe.parser._\n"
+            << "import io.circe.syntax._\n\n"
+            << "class " << className << "Spec extends AnyFlatSpec with Matchers {\n\n"
+            << std::string(config.indentSize, ' ') << "\"" << className << "\" should \"serialize and deserialize correctly\" in {\n"
+            << std::string(config.indentSize * 2, ' ') << "val sampleJson = \"\"\"" << sampleData.dump() << "\"\"\"\n"
+            << std::string(config.indentSize * 2, ' ') << "val decoded = decode[" << className << "](sampleJson)\n"
+            << std::string(config.indentSize * 2, ' ') << "decoded.isRight shouldBe true\n"
+            << std::string(config.indentSize * 2, ' ') << "val obj = decoded.right.get\n"
+            << std::string(config.indentSize * 2, ' ') << "val encoded = obj.asJson.noSpaces\n"
+            << std::string(config.indentSize * 2, ' ') << "val reDecoded = decode[" << className << "](encoded)\n"
+            << std::string(config.indentSize * 2, ' ') << "reDecoded.isRight shouldBe true\n"
+            << std::string(config.indentSize * 2, ' ') << (config.stringFormats ? "reDecoded.right.get.asJson.noSpaces shouldBe encoded\n" : "reDecoded.right.get shouldBe obj\n")
+            << std::string(config.indentSize, ' ') << "}\n"
+            << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Option[Any]";
+        if (value.is_boolean()) return "Boolean";
+        if (value.is_number_integer()) return "Long";
+        if (value.is_number_float()) return "Double";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "List[" + toLanguageType(value[0], config) + "]";
+            }
+            return "List[Any]";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "Any";
+    }
+
+private:
+    int depth = 0;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+    // Sealed union and tag of each variant class
+    std::map<std::string, std::pair<std::string, std::string>> variantOf;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // circe decodes the tag alone and then only the matching case class; jsoniter-scala marks the
+    // object start and scans ahead for the discriminator, so neither builds an intermediate tree
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "sealed trait " << className << "\n\n"
+            << "object " << className << " {\n";
+        if (config.staticCodecs) {
+            outFile << indent1 << "implicit val codec: JsonValueCodec[" << className << "] = JsonCodecMaker.make(\n"
+                << indent2 << "CodecMakerConfig.withDiscriminatorFieldName(Some(" << scalaString(tagged.property) << ")).withRequireDiscriminatorFirst(false))\n";
+        }
+        else {
+            outFile << indent1 << "implicit val encoder: Encoder[" << className << "] = Encoder.instance {\n";
+            for (const auto& variant : tagged.variants) {
+                std::string variantClass = className + "_" + variant.name;
+                outFile << indent2 << "case variant: " << variantClass << " => Encoder[" << variantClass << "].apply(variant)\n";
+            }
+            outFile << indent1 << "}\n"
+                << indent1 << "implicit val decoder: Decoder[" << className << "] = Decoder.instance { cursor =>\n"
+                << indent2 << "cursor.downField(" << scalaString(tagged.property) << ").as[String].flatMap {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent3 << "case " << scalaString(variant.tag) << " => cursor.as[" << className << "_" << variant.name << "]\n";
+            }
+            outFile << indent3 << "case other => Left(io.circe.DecodingFailure(s\"Unknown " << className << " " << tagged.property << ": $other\", cursor.history))\n"
+                << indent2 << "}\n"
+                << indent1 << "}\n";
+        }
+        outFile << "}\n\n";
+
+        if (config.generateValidation) {
+            outFile << "object " << className << "Validator {\n"
+                << indent1 << "def isValid(obj: " << className << "): Boolean = obj match {\n";
+            for (const auto& variant : tagged.variants) {
+                std::string variantClass = className + "_" + variant.name;
+                outFile << indent2 << "case variant: " << variantClass << " => " << variantClass << "Validator.isValid(variant)\n";
+            }
+            outFile << indent1 << "}\n"
+                << "}\n\n";
+        }
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "java.util.UUID";
+            case StringFormat::Kind::DATE_TIME: return "java.time.Instant";
+            default: return "Array[Byte]";
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (config.staticCodecs && value.is_null()) return "Option[RawJson]";
+        if (value.is_array()) {
+            if (value.empty()) return config.staticCodecs ? "List[RawJson]" : "List[Any]";
+            return "List[" + fieldType(className, key, value[0], config) + "]";
+        }
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            // No unsigned types on the JVM; unsigned formats take the next wider signed type
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return format.bits == 32 ? "Float" : "Double";
+            int bits = format.asSigned().bits;
+            return bits == 8 ? "Byte" : bits == 16 ? "Short" : bits == 32 ? "Int" : "Long";
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    // Both libraries read UUID and Instant themselves but treat Array[Byte] as a list of numbers, so base64
+    // gets codecs that the imported implicits put ahead of the built-in ones
+    void generateFormatCodecs(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        outFile << "object JsonFormats {\n";
+        if (config.staticCodecs) {
+            outFile << indent1 << "implicit val base64Codec: JsonValueCodec[Array[Byte]] = new JsonValueCodec[Array[Byte]] {\n"
+                << indent2 << "def decodeValue(in: JsonReader, default: Array[Byte]): Array[Byte] = in.readBase64AsBytes(default)\n"
+                << indent2 << "def encodeValue(x: Array[Byte], out: JsonWriter): Unit = out.writeBase64Val(x, doPadding = true)\n"
+                << indent2 << "def nullValue: Array[Byte] = null\n"
+                << indent1 << "}\n";
+        }
+        else {
+            outFile << indent1 << "implicit val base64Encoder: Encoder[Array[Byte]] = Encoder.encodeString.contramap(java.util.Base64.getEncoder.encodeToString)\n"
+                << indent1 << "implicit val base64Decoder: Decoder[Array[Byte]] = Decoder.decodeString.emapTry(text => scala.util.Try(java.util.Base64.getDecoder.decode(text)))\n";
+        }
+        outFile << "}\n\n"
+            << "import JsonFormats._\n\n";
+    }
+
+    // The hand-written codec reads primitives only, so a single enum or formatted field keeps the case class
+    bool isValueClass(const std::string& className, const json& data) {
+        if (data.size() != 1 || !enumFields[className].empty() || !stringFormats[className].empty()) return false;
+        const json& value = data.begin().value();
+        return value.is_boolean() || value.is_number() || value.is_string();
+    }
+
+    // jsoniter-scala encodes an AnyVal as its bare value, so the codec is written out to keep the object shape
+    void generateValueClass(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        const std::string& key = data.begin().key();
+        const json& value = data.begin().value();
+        std::string type = fieldType(className, key, value, config);
+        std::string zero = value.is_boolean() ? "false" : value.is_number_integer() ? "0" : type == "Float" ? "0.0f" : value.is_number_float() ? "0.0" : "\"\"";
+        std::string reader = value.is_string() ? "in.readString(null)" : "in.read" + type + "()";
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string indent4(config.indentSize * 4, ' ');
+        std::string indent5(config.indentSize * 5, ' ');
+
+        std::string name = identifier(key);
+
+        outFile << "final case class " << className << "(" << name << ": " << type << ") extends AnyVal\n\n"
+            << "object " << className << " {\n"
+            << indent1 << "implicit val codec: JsonValueCodec[" << className << "] = new JsonValueCodec[" << className << "] {\n"
+            << indent2 << "def decodeValue(in: JsonReader, default: " << className << "): " << className << " =\n"
+            << indent3 << "if (in.isNextToken('{')) {\n"
+            << indent4 << "var " << name << " = default." << name << "\n"
+            << indent4 << "if (!in.isNextToken('}')) {\n"
+            << indent5 << "in.rollbackToken()\n"
+            << indent5 << "while ({\n"
+            << indent5 << indent1 << "if (in.readKeyAsString() == \"" << key << "\") " << name << " = " << reader << " else in.skip()\n"
+            << indent5 << indent1 << "in.isNextToken(',')\n"
+            << indent5 << "}) ()\n"
+            << indent5 << "if (!in.isCurrentToken('}')) in.objectEndOrCommaError()\n"
+            << indent4 << "}\n"
+            << indent4 << className << "(" << name << ")\n"
+            << indent3 << "} else in.readNullOrTokenError(default, '{')\n\n"
+            << indent2 << "def encodeValue(x: " << className << ", out: JsonWriter): Unit = {\n"
+            << indent3 << "out.writeObjectStart()\n"
+            << indent3 << "out.writeKey(\"" << key << "\")\n"
+            << indent3 << "out.writeVal(x." << name << ")\n"
+            << indent3 << "out.writeObjectEnd()\n"
+            << indent2 << "}\n\n"
+            << indent2 << "def nullValue: " << className << " = " << className << "(" << zero << ")\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    // An object holds the validator so its patterns are compiled once; the checks are a single
+    // short-circuiting conjunction. Decoding already rejects missing fields, which covers `required`
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+
+        outFile << "object " << className << "Validator {\n";
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << indent1 << "private val " << key << "Pattern = java.util.regex.Pattern.compile(" << scalaString(*constraints.pattern) << ")\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        std::vector<std::string> conditions;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "obj." + identifier(key);
+            // A formatted field was checked by its codec when it was decoded
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) conditions.push_back(field + ".codePointCount(0, " + field + ".length) >= " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) conditions.push_back(field + ".codePointCount(0, " + field + ".length) <= " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) conditions.push_back(key + "Pattern.matcher(" + field + ").find()");
+            }
+            if (value.is_number()) {
+                // Bounds are compared against the declared type, the wider signed one for unsigned formats
+                NumberFormat format = numberFormats[className][key].asSigned();
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) conditions.push_back(field + " >= " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) conditions.push_back(field + " <= " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string condition;
+                for (const auto& candidate : allowed) {
+                    std::string literal = candidate.is_string() ? scalaString(candidate.get<std::string>())
+                        : value.is_number_float() ? FieldConstraints::boundLiteral(candidate.get<double>(), false, true) : candidate.dump();
+                    condition += (condition.empty() ? "" : " || ") + field + " == " + literal;
+                }
+                conditions.push_back(allowed.size() == 1 ? condition : "(" + condition + ")");
+            }
+            if (value.is_array()) {
+                // lengthCompare stops after the bound instead of walking the whole list
+                if (constraints.minItems) conditions.push_back(field + ".lengthCompare(" + std::to_string(*constraints.minItems) + ") >= 0");
+                if (constraints.maxItems) conditions.push_back(field + ".lengthCompare(" + std::to_string(*constraints.maxItems) + ") <= 0");
+                if (!value.empty() && value[0].is_object()) {
+                    conditions.push_back(field + ".forall(" + className + "_" + key + "Validator.isValid)");
+                }
+            }
+            if (value.is_object()) {
+                conditions.push_back(className + "_" + key + "Validator.isValid(" + field + ")");
+            }
+        }
+
+        outFile << indent1 << "def isValid(obj: " << className << "): Boolean =\n";
+        if (conditions.empty()) {
+            outFile << indent2 << "true\n";
+        }
+        for (size_t i = 0; i < conditions.size(); ++i) {
+            outFile << indent2 << conditions[i] << (i + 1 < conditions.size() ? " &&\n" : "\n");
+        }
+        outFile << "}\n\n";
+    }
+
+    // Field names are the JSON keys, so reserved words such as `type` are quoted with backticks
+    std::string identifier(const std::string& key) {
+        static const std::set<std::string> reserved = {
+            "abstract", "case", "catch", "class", "def", "do", "else", "extends", "false", "final", "finally", "for",
+            "forSome", "if", "implicit", "import", "lazy", "match", "new", "null", "object", "override", "package",
+            "private", "protected", "return", "sealed", "super", "this", "throw", "trait", "true", "try", "type",
+            "val", "var", "while", "with", "yield",
+        };
+        return reserved.count(key) ? "`" + key + "`" : key;
+    }
+
+    std::string scalaString(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+};
@@ -0,0 +1,703 @@
+#include "json_model_generator.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+
+FieldConstraints FieldConstraints::read(const json& schema, const std::string& key) {
+    FieldConstraints constraints;
+    if (schema.contains("required") && schema["required"].is_array()) {
+        for (const auto& name : schema["required"]) {
+            if (name == key) {
+                constraints.required = true;
+            }
+        }
+    }
+    if (!schema.contains("properties") || !schema["properties"].contains(key)) {
+        return constraints;
+    }
+
+    const json& property = schema["properties"][key];
+    auto number = [&](const char* keyword) -> std::optional<double> {
+        if (property.contains(keyword) && property[keyword].is_number()) return property[keyword].get<double>();
+        return std::nullopt;
+    };
+    auto count = [&](const char* keyword) -> std::optional<size_t> {
+        if (property.contains(keyword) && property[keyword].is_number() && property[keyword].get<double>() >= 0) return property[keyword].get<size_t>();
+        return std::nullopt;
+    };
+    constraints.minimum = number("minimum");
+    constraints.maximum = number("maximum");
+    constraints.minLength = count("minLength");
+    constraints.maxLength = count("maxLength");
+    constraints.minItems = count("minItems");
+    constraints.maxItems = count("maxItems");
+    if (property.contains("pattern") && property["pattern"].is_string()) {
+        constraints.pattern = property["pattern"].get<std::string>();
+    }
+    if (property.contains("enum") && property["enum"].is_array()) {
+        constraints.enumValues = property["enum"].get<std::vector<json>>();
+    }
+    return constraints;
+}
+
+std::vector<json> FieldConstraints::enumValuesLike(const json& value) const {
+    std::vector<json> result;
+    for (const auto& candidate : enumValues) {
+        bool sameType = value.is_number() ? candidate.is_number() && (value.is_number_float() || !candidate.is_number_float()) : candidate.type() == value.type();
+        if (sameType && (value.is_string() || value.is_number())) {
+            result.push_back(candidate);
+        }
+    }
+    return result;
+}
+
+std::string FieldConstraints::boundLiteral(double bound, bool integral, bool lower) {
+    std::ostringstream literal;
+    if (integral) {
+        literal << static_cast<long long>(lower ? std::ceil(bound) : std::floor(bound));
+        return literal.str();
+    }
+    // Shortest precision that still reads back as the same double, printed without an exponent
+    // since not every target language accepts exponent literals
+    int precision = 17;
+    for (int candidate = 1; candidate < 17; ++candidate) {
+        std::ostringstream shorter;
+        shorter.precision(candidate);
+        shorter << bound;
+        if (std::stod(shorter.str()) == bound) {
+            precision = candidate;
+            break;
+        }
+    }
+    int exponent = bound == 0 ? 0 : static_cast<int>(std::floor(std::log10(std::fabs(bound))));
+    literal << std::fixed;
+    literal.precision(std::max(1, precision - 1 - exponent));
+    literal << bound;
+    std::string text = literal.str();
+    while (text.back() == '0' && text[text.size() - 2] != '.') {
+        text.pop_back();
+    }
+    return text;
+}
+
+bool FieldConstraints::usedBy(const json& schema, const json& data, std::initializer_list<const char*> keywords, const Config& config) {
+    if (!data.is_object()) return false;
+    for (auto& [key, value] : data.items()) {
+        if (value.is_string() && StringFormat::read(schema, key, value, config).kind == StringFormat::Kind::NONE) {
+            const json& property = propertySchema(schema, key);
+            for (const char* keyword : keywords) {
+                if (property.contains(keyword)) return true;
+            }
+        }
+        if (std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config)) {
+            for (const auto& variant : tagged->variants) {
+                if (usedBy(*variant.schema, *variant.sample, keywords, config)) return true;
+            }
+            continue;
+        }
+        const json* sample = &value;
+        while (sample->is_array() && !sample->empty()) {
+            sample = &(*sample)[0];
+        }
+        if (sample->is_object() && usedBy(nestedSchema(schema, key, *sample), *sample, keywords, config)) return true;
+    }
+    return false;
+}
+
+bool NumberFormat::isNumeric(const json& value) {
+    return value.is_number() || (value.is_array() && !value.empty() && value[0].is_number());
+}
+
+NumberFormat NumberFormat::read(const json& schema, const std::string& key, const json& value, const Config& config) {
+    NumberFormat format;
+    format.bits = 64;
+    format.isFloat = (value.is_array() ? value[0] : value).is_number_float();
+    if (config.wideNumbers || !schema.contains("properties") || !schema["properties"].contains(key)) {
+        return format;
+    }
+
+    const json* found = &schema["properties"][key];
+    if (value.is_array()) {
+        if (!found->contains("items")) return format;
+        found = &(*found)["items"];
+    }
+    const json& property = *found;
+    format.isFloat = format.isFloat || property.value("type", json()) == "number";
+    if (property.contains("format") && property["format"].is_string()) {
+        NumberFormat declared = parse(property["format"].get<std::string>());
+        // An integer format on a float field would truncate it
+        if (declared.bits != 0 && (declared.isFloat || !format.isFloat)) {
+            return declared;
+        }
+    }
+    if (!format.isFloat && property.contains("minimum") && property["minimum"].is_number()
+        && property.contains("maximum") && property["maximum"].is_number()) {
+        return forRange(std::ceil(property["minimum"].get<double>()), std::floor(property["maximum"].get<double>()));
+    }
+    return format;
+}
+
+std::map<std::string, NumberFormat> NumberFormat::readAll(const json& schema, const json& data, const Config& config) {
+    std::map<std::string, NumberFormat> formats;
+    for (auto& [key, value] : data.items()) {
+        if (isNumeric(value)) {
+            formats[key] = read(schema, key, value, config);
+        }
+    }
+    return formats;
+}
+
+void NumberFormat::conform(json& data, const json& schema) {
+    if (data.is_number_integer() && schema.is_object() && schema.value("type", json()) == "number") {
+        data = data.get<double>();
+    }
+    else if (data.is_array() && schema.contains("items")) {
+        for (auto& item : data) {
+            conform(item, TaggedUnion::variantSchema(schema["items"], item));
+        }
+    }
+    else if (data.is_object() && schema.contains("properties")) {
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            if (schema["properties"].contains(it.key())) {
+                conform(it.value(), schema["properties"][it.key()]);
+            }
+        }
+    }
+}
+
+NumberFormat NumberFormat::parse(const std::string& format) {
+    NumberFormat result;
+    if (format == "float" || format == "double") {
+        result.isFloat = true;
+        result.bits = format == "float" ? 32 : 64;
+        return result;
+    }
+    static const std::map<std::string, int> widths = {
+        { "int8", 8 }, { "int16", 16 }, { "int32", 32 }, { "int64", 64 }
+    };
+    result.isUnsigned = format.rfind("uint", 0) == 0;
+    auto width = widths.find(result.isUnsigned ? format.substr(1) : format);
+    if (width != widths.end()) {
+        result.bits = width->second;
+    }
+    return result;
+}
+
+NumberFormat NumberFormat::forRange(double minimum, double maximum) {
+    NumberFormat result;
+    result.isUnsigned = minimum >= 0;
+    for (int bits : { 8, 16, 32, 64 }) {
+        double low = result.isUnsigned ? 0 : -std::ldexp(1.0, bits - 1);
+        double high = std::ldexp(1.0, result.isUnsigned ? bits : bits - 1) - 1;
+        result.bits = bits;
+        if (minimum >= low && maximum <= high) {
+            break;
+        }
+    }
+    return result;
+}
+
+NumberFormat NumberFormat::asSigned() const {
+    NumberFormat result = *this;
+    if (isUnsigned) {
+        result.bits = std::min(bits * 2, 64);
+        result.isUnsigned = false;
+    }
+    return result;
+}
+
+bool NumberFormat::implies(double bound, bool lower) const {
+    if (isFloat || bits == 0) {
+        return false;
+    }
+    // long double holds the 64-bit limits exactly
+    long double low = isUnsigned ? 0 : -std::ldexp(1.0L, bits - 1);
+    long double high = std::ldexp(1.0L, isUnsigned ? bits : bits - 1) - 1;
+    return lower ? std::ceil(bound) <= low : std::floor(bound) >= high;
+}
+
+std::string NumberFormat::name() const {
+    if (isFloat) {
+        return bits == 32 ? "float" : "double";
+    }
+    return (isUnsigned ? "uint" : "int") + std::to_string(bits == 0 ? 64 : bits);
+}
+
+namespace {
+
+StringFormat::Kind formatKind(const json& property) {
+    if (property.contains("format") && property["format"].is_string()) {
+        const std::string& format = property["format"].get_ref<const std::string&>();
+        if (format == "uuid") return StringFormat::Kind::UUID;
+        if (format == "date-time") return StringFormat::Kind::DATE_TIME;
+        if (format == "byte") return StringFormat::Kind::BYTES;
+    }
+    if (property.contains("contentEncoding") && property["contentEncoding"] == "base64") {
+        return StringFormat::Kind::BYTES;
+    }
+    return StringFormat::Kind::NONE;
+}
+
+// Lookup tables keep the validators free of per-character branches: bad bytes are OR-ed into one flag
+// and tested once after the loop, which compilers turn into straight-line or vectorized code
+const std::array<uint8_t, 256>& hexDigits() {
+    static const std::array<uint8_t, 256> table = [] {
+        std::array<uint8_t, 256> t{};
+        for (int c = 0; c < 256; ++c) t[c] = std::isxdigit(c) ? 1 : 0;
+        return t;
+    }();
+    return table;
+}
+
+// Six-bit value of each base64 symbol, 0xFF for anything else
+const std::array<uint8_t, 256>& base64Values() {
+    static const std::array<uint8_t, 256> table = [] {
+        std::array<uint8_t, 256> t;
+        t.fill(0xFF);
+        const char* symbols = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (uint8_t i = 0; i < 64; ++i) t[static_cast<unsigned char>(symbols[i])] = i;
+        return t;
+    }();
+    return table;
+}
+
+int digits(std::string_view text, size_t pos, size_t count) {
+    int result = 0;
+    for (size_t i = pos; i < pos + count; ++i) result = result * 10 + (text[i] - '0');
+    return result;
+}
+
+} // namespace
+
+StringFormat StringFormat::read(const json& schema, const std::string& key, const json& value, const Config& config) {
+    StringFormat format;
+    if (config.plainStrings || !value.is_string() || !schema.contains("properties") || !schema["properties"].contains(key)) {
+        return format;
+    }
+    format.kind = formatKind(schema["properties"][key]);
+    return format;
+}
+
+std::map<std::string, StringFormat> StringFormat::readAll(const json& schema, const json& data, const Config& config) {
+    std::map<std::string, StringFormat> formats;
+    for (auto& [key, value] : data.items()) {
+        StringFormat format = read(schema, key, value, config);
+        if (format.kind != Kind::NONE) {
+            formats[key] = format;
+        }
+    }
+    return formats;
+}
+
+bool StringFormat::usedBy(const json& schema, const Config& config) {
+    if (config.plainStrings || !schema.is_object()) return false;
+    if (formatKind(schema) != Kind::NONE) return true;
+    for (const char* group : { "properties", "definitions" }) {
+        if (schema.contains(group) && schema[group].is_object()) {
+            for (auto& [key, child] : schema[group].items()) {
+                if (usedBy(child, config)) return true;
+            }
+        }
+    }
+    if (schema.contains("oneOf") && schema["oneOf"].is_array()) {
+        for (const auto& variant : schema["oneOf"]) {
+            if (usedBy(variant, config)) return true;
+        }
+    }
+    return schema.contains("items") && usedBy(schema["items"], config);
+}
+
+StringFormat StringFormat::detect(const std::vector<const json*>& samples) {
+    bool uuid = true;
+    bool dateTime = true;
+    bool base64 = true;
+    // Base64 also matches plain words and hex digests, so the samples must show both a digit or symbol
+    // and a letter past 'f' before a field counts as binary
+    bool symbol = false;
+    bool letter = false;
+    bool seen = false;
+    for (const json* sample : samples) {
+        if (!sample->is_string()) continue;
+        std::string_view text = sample->get_ref<const std::string&>();
+        seen = true;
+        uuid = uuid && isUuid(text);
+        dateTime = dateTime && isDateTime(text);
+        base64 = base64 && text.size() >= 16 && isBase64(text);
+        if (base64) {
+            for (unsigned char c : text) {
+                symbol |= std::isdigit(c) || c == '+' || c == '/' || c == '=';
+                letter |= std::isalpha(c) && std::tolower(c) > 'f';
+            }
+        }
+        if (!uuid && !dateTime && !base64) break;
+    }
+    StringFormat format;
+    if (seen) {
+        format.kind = uuid ? Kind::UUID : dateTime ? Kind::DATE_TIME : base64 && symbol && letter ? Kind::BYTES : Kind::NONE;
+    }
+    return format;
+}
+
+bool StringFormat::isUuid(std::string_view text) {
+    if (text.size() != 36) return false;
+    constexpr uint64_t dashes = (1ull << 8) | (1ull << 13) | (1ull << 18) | (1ull << 23);
+    const auto& hex = hexDigits();
+    unsigned bad = 0;
+    for (size_t i = 0; i < 36; ++i) {
+        unsigned char c = text[i];
+        bad |= (dashes >> i) & 1 ? c != '-' : !hex[c];
+    }
+    return bad == 0;
+}
+
+bool StringFormat::isDateTime(std::string_view text) {
+    // The fixed-width head, YYYY-MM-DDTHH:MM:SS, is checked against a layout in one pass
+    static constexpr char layout[] = "dddd-dd-ddTdd:dd:dd";
+    constexpr size_t head = sizeof(layout) - 1;
+    if (text.size() < head + 1) return false;
+    unsigned bad = 0;
+    for (size_t i = 0; i < head; ++i) {
+        unsigned char c = text[i];
+        bad |= layout[i] == 'd' ? !std::isdigit(c) : c != layout[i];
+    }
+    if (bad) return false;
+
+    static const int daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int year = digits(text, 0, 4);
+    int month = digits(text, 5, 2);
+    int day = digits(text, 8, 2);
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth[month - 1] + (month == 2 && leap)
+        || digits(text, 11, 2) > 23 || digits(text, 14, 2) > 59 || digits(text, 17, 2) > 59) {
+        return false;
+    }
+
+    size_t pos = head;
+    if (text[pos] == '.') {
+        size_t first = ++pos;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) ++pos;
+        // Nanoseconds are the finest precision any generated type keeps
+        if (pos == first || pos - first > 9) return false;
+    }
+    if (pos + 1 == text.size()) {
+        return text[pos] == 'Z';
+    }
+    if (pos + 6 != text.size() || (text[pos] != '+' && text[pos] != '-') || text[pos + 3] != ':') return false;
+    for (size_t i : { pos + 1, pos + 2, pos + 4, pos + 5 }) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) return false;
+    }
+    return digits(text, pos + 1, 2) <= 23 && digits(text, pos + 4, 2) <= 59;
+}
+
+bool StringFormat::isBase64(std::string_view text) {
+    if (text.empty() || text.size() % 4 != 0) return false;
+    size_t padding = text.back() != '=' ? 0 : text[text.size() - 2] == '=' ? 2 : 1;
+    const auto& values = base64Values();
+    unsigned bad = 0;
+    for (size_t i = 0; i < text.size() - padding; ++i) {
+        bad |= values[static_cast<unsigned char>(text[i])];
+    }
+    if (bad & 0x80) return false;
+    if (padding == 0) return true;
+    uint8_t last = values[static_cast<unsigned char>(text[text.size() - padding - 1])];
+    return (last & (padding == 2 ? 0x0F : 0x03)) == 0;
+}
+
+std::string StringFormat::name() const {
+    switch (kind) {
+    case Kind::UUID: return "uuid";
+    case Kind::DATE_TIME: return "date-time";
+    case Kind::BYTES: return "byte";
+    default: return "";
+    }
+}
+
+const std::string* TaggedUnion::discriminatorOf(const json& schema) {
+    if (!schema.is_object() || !schema.contains("oneOf") || !schema["oneOf"].is_array() || !schema.contains("discriminator")) {
+        return nullptr;
+    }
+    const json& discriminator = schema["discriminator"];
+    if (!discriminator.is_object() || !discriminator.contains("propertyName") || !discriminator["propertyName"].is_string()) {
+        return nullptr;
+    }
+    return &discriminator["propertyName"].get_ref<const std::string&>();
+}
+
+std::optional<std::string> TaggedUnion::tagOf(const json& variant, const std::string& property) {
+    if (!variant.is_object() || !variant.contains("properties") || !variant["properties"].contains(property)) {
+        return std::nullopt;
+    }
+    const json& schema = variant["properties"][property];
+    if (schema.contains("const") && schema["const"].is_string()) {
+        return schema["const"].get<std::string>();
+    }
+    if (schema.contains("enum") && schema["enum"].is_array() && schema["enum"].size() == 1 && schema["enum"][0].is_string()) {
+        return schema["enum"][0].get<std::string>();
+    }
+    return std::nullopt;
+}
+
+namespace {
+
+const json& emptySchema() {
+    static const json empty = json::object();
+    return empty;
+}
+
+bool hasTag(const json& item, const std::string& property, const std::string& tag) {
+    if (!item.is_object()) return false;
+    auto value = item.find(property);
+    return value != item.end() && value->is_string() && value->get_ref<const std::string&>() == tag;
+}
+
+void inlineVariantsOf(json& schema, const json& root) {
+    if (!schema.is_object()) return;
+    if (const std::string* discriminator = TaggedUnion::discriminatorOf(schema)) {
+        std::string property = *discriminator;
+        json mapping = schema["discriminator"].value("mapping", json::object());
+        for (json& variant : schema["oneOf"]) {
+            if (!variant.contains("$ref") || !variant["$ref"].is_string()) continue;
+            std::string ref = variant["$ref"].get<std::string>();
+            if (ref.rfind("#/", 0) != 0 || !root.contains(json::json_pointer(ref.substr(1)))) continue;
+            // OpenAPI tags a variant with its schema name unless the mapping, by reference or by name, says otherwise
+            std::string name = ref.substr(ref.find_last_of('/') + 1);
+            std::string tag = name;
+            for (auto& [value, target] : mapping.items()) {
+                if (target == ref || target == name) {
+                    tag = value;
+                    break;
+                }
+            }
+            json resolved = root[json::json_pointer(ref.substr(1))];
+            if (!TaggedUnion::tagOf(resolved, property)) {
+                resolved["properties"][property]["const"] = tag;
+            }
+            variant = resolved;
+        }
+    }
+    for (auto& [key, child] : schema.items()) {
+        inlineVariantsOf(child, root);
+    }
+}
+
+} // namespace
+
+std::optional<TaggedUnion> TaggedUnion::read(const json& schema, const std::string& key, const json& value, const Config& config) {
+    if (config.plainUnions || !value.is_array() || !schema.contains("properties") || !schema["properties"].contains(key)
+        || !schema["properties"][key].contains("items")) {
+        return std::nullopt;
+    }
+    const json& items = schema["properties"][key]["items"];
+    const std::string* discriminator = discriminatorOf(items);
+    if (!discriminator) {
+        return std::nullopt;
+    }
+    TaggedUnion result;
+    result.property = *discriminator;
+    EnumDefinition tags;
+    for (const auto& variant : items["oneOf"]) {
+        std::optional<std::string> tag = tagOf(variant, result.property);
+        if (!tag || std::find(tags.values.begin(), tags.values.end(), *tag) != tags.values.end()) continue;
+        // Variants missing from the sample have nothing to build their fields from
+        auto sample = std::find_if(value.begin(), value.end(), [&](const json& item) { return hasTag(item, result.property, *tag); });
+        if (sample == value.end()) continue;
+        result.variants.push_back({ *tag, "", &variant, &*sample });
+        tags.values.push_back(*tag);
+    }
+    if (result.variants.empty()) {
+        return std::nullopt;
+    }
+    std::vector<std::string> names = tags.caseNames(EnumDefinition::Style::PASCAL);
+    for (size_t i = 0; i < names.size(); ++i) {
+        result.variants[i].name = names[i];
+    }
+    return result;
+}
+
+const json& TaggedUnion::variantSchema(const json& itemSchema, const json& item) {
+    const std::string* discriminator = discriminatorOf(itemSchema);
+    if (!discriminator) {
+        return itemSchema;
+    }
+    for (const auto& variant : itemSchema["oneOf"]) {
+        std::optional<std::string> tag = tagOf(variant, *discriminator);
+        if (tag && hasTag(item, *discriminator, *tag)) {
+            return variant;
+        }
+    }
+    return emptySchema();
+}
+
+bool TaggedUnion::usedBy(const json& schema, const Config& config) {
+    if (config.plainUnions || !schema.is_object()) return false;
+    if (discriminatorOf(schema)) return true;
+    for (const char* group : { "properties", "definitions" }) {
+        if (schema.contains(group) && schema[group].is_object()) {
+            for (auto& [key, child] : schema[group].items()) {
+                if (usedBy(child, config)) return true;
+            }
+        }
+    }
+    return schema.contains("items") && usedBy(schema["items"], config);
+}
+
+void TaggedUnion::inlineVariants(json& schema) {
+    const json root = schema;
+    inlineVariantsOf(schema, root);
+}
+
+std::string TaggedUnion::detect(const std::vector<const json*>& items) {
+    // Names that mark a discriminator even when most tags occur once in the sample
+    static const std::set<std::string> conventional = {
+        "type", "kind", "event", "eventType", "event_type", "@type", "__typename", "tag", "op", "action", "messageType", "message_type"
+    };
+    if (items.size() < 2 || !std::all_of(items.begin(), items.end(), [](const json* item) { return item->is_object(); })) {
+        return "";
+    }
+    std::string best;
+    std::pair<bool, size_t> bestRank;
+    for (auto& [key, first] : items.front()->items()) {
+        if (!first.is_string()) continue;
+        // Keys seen with each tag; a tag shared by differently keyed items still counts as one shape
+        std::map<std::string, std::set<std::string>> shapes;
+        bool candidate = true;
+        for (const json* item : items) {
+            auto tag = item->find(key);
+            if (tag == item->end() || !tag->is_string()) {
+                candidate = false;
+                break;
+            }
+            std::set<std::string>& shape = shapes[tag->get<std::string>()];
+            for (auto& [name, value] : item->items()) {
+                shape.insert(name);
+            }
+            if (shapes.size() > 64) {
+                candidate = false;
+                break;
+            }
+        }
+        if (!candidate || shapes.size() < 2) continue;
+        std::set<std::set<std::string>> distinct;
+        for (const auto& [tag, shape] : shapes) {
+            distinct.insert(shape);
+        }
+        if (distinct.size() < 2) continue;
+        // As with inferred enums, other properties must repeat their values to tell a tag from an id
+        bool known = conventional.count(key) > 0;
+        if (!known && items.size() < 2 * shapes.size()) continue;
+        std::pair<bool, size_t> rank = { !known, shapes.size() };
+        if (best.empty() || rank < bestRank) {
+            best = key;
+            bestRank = rank;
+        }
+    }
+    return best;
+}
+
+std::map<std::string, EnumDefinition> EnumDefinition::readAll(const json& schema) {
+    std::map<std::string, EnumDefinition> result;
+    if (!schema.contains("definitions") || !schema["definitions"].is_object()) {
+        return result;
+    }
+    for (auto& [name, def] : schema["definitions"].items()) {
+        if (!def.contains("enum") || !def["enum"].is_array() || def["enum"].empty()) continue;
+        EnumDefinition definition{ name, {} };
+        for (const auto& value : def["enum"]) {
+            if (!value.is_string()) break;
+            definition.values.push_back(value.get<std::string>());
+        }
+        if (definition.values.size() == def["enum"].size()) {
+            result[name] = definition;
+        }
+    }
+    return result;
+}
+
+std::map<std::string, std::string> EnumDefinition::references(const json& schema, const json& data, const std::map<std::string, EnumDefinition>& enums) {
+    static const std::string prefix = "#/definitions/";
+    std::map<std::string, std::string> result;
+    if (!schema.contains("properties") || !schema["properties"].is_object()) {
+        return result;
+    }
+    for (auto& [key, value] : data.items()) {
+        if (!value.is_string() || !schema["properties"].contains(key)) continue;
+        const json& property = schema["properties"][key];
+        if (property.contains("$ref") && property["$ref"].is_string()) {
+            std::string ref = property["$ref"].get<std::string>();
+            if (ref.rfind(prefix, 0) == 0 && enums.count(ref.substr(prefix.size()))) {
+                result[key] = ref.substr(prefix.size());
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> EnumDefinition::caseNames(Style style) const {
+    // Swift and Dart take camelCase cases, where enum members (values, index, name) and keywords can clash
+    static const std::set<std::string> reserved = {
+        "as", "break", "case", "catch", "class", "const", "continue", "default", "do", "else", "enum", "extension",
+        "false", "final", "for", "func", "get", "if", "import", "in", "index", "init", "is", "let", "name", "new",
+        "nil", "null", "protocol", "rawValue", "return", "self", "set", "static", "struct", "super", "switch", "this",
+        "throw", "true", "try", "values", "var", "void", "where", "while", "with",
+        "False", "None", "Self", "True", "Type"
+    };
+    std::vector<std::string> result;
+    std::set<std::string> taken;
+    for (const auto& value : values) {
+        std::vector<std::string> words;
+        std::string word;
+        for (size_t i = 0; i < value.size(); ++i) {
+            unsigned char c = value[i];
+            if (!std::isalnum(c)) {
+                if (!word.empty()) words.push_back(word);
+                word.clear();
+                continue;
+            }
+            if (std::isupper(c) && !word.empty() && std::islower(static_cast<unsigned char>(value[i - 1]))) {
+                words.push_back(word);
+                word.clear();
+            }
+            word += static_cast<char>(std::tolower(c));
+        }
+        if (!word.empty()) words.push_back(word);
+        if (words.empty()) words.push_back("empty");
+        if (std::isdigit(static_cast<unsigned char>(words[0][0]))) words.insert(words.begin(), "v");
+
+        std::string caseName;
+        for (size_t i = 0; i < words.size(); ++i) {
+            std::string part = words[i];
+            if (style == Style::UPPER_SNAKE) {
+                std::transform(part.begin(), part.end(), part.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+                caseName += (i > 0 ? "_" : "") + part;
+                continue;
+            }
+            if (i > 0 || style == Style::PASCAL) part[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(part[0])));
+            caseName += part;
+        }
+        if (reserved.count(caseName)) caseName += "_";
+        std::string unique = caseName;
+        for (int n = 2; taken.count(unique); ++n) {
+            unique = caseName + std::to_string(n);
+        }
+        taken.insert(unique);
+        result.push_back(unique);
+    }
+    return result;
+}
+
+const json& propertySchema(const json& schema, const std::string& key) {
+    if (!schema.contains("properties") || !schema["properties"].contains(key)) {
+        return emptySchema();
+    }
+    return schema["properties"][key];
+}
+
+const json& nestedSchema(const json& schema, const std::string& key, const json& sample) {
+    const json* property = &propertySchema(schema, key);
+    while (property->contains("items")) {
+        property = &(*property)["items"];
+    }
+    return TaggedUnion::variantSchema(*property, sample);
+}
@@ -1,104 +1,403 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-
-class SwiftGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        outFile << "import Foundation\n\n";
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "enum " << name << ": String, Codable {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << "case " << value << " = \"" << value << "\"\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "struct " << className << ": Codable {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/// " << schema["properties"][key]["description"] << "\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << "let " << key << ": " << type << "\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        // Generate CodingKeys enum
-        outFile << "\n" << std::string(config.indentSize, ' ') << "enum CodingKeys: String, CodingKey {\n";
-        for (auto& [key, value] : data.items()) {
-            outFile << std::string(config.indentSize * 2, ' ') << "case " << key << "\n";
-        }
-        outFile << std::string(config.indentSize, ' ') << "}\n";
-
-        outFile << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import XCTest\n"
-            << "@testable import YourModuleName\n\n"
-            << "class " << className << "Tests: XCTestCase {\n\n"
-            << std::string(config.indentSize, ' ') << "func testSerializationDeserialization() throws {\n"
-            << std::string(config.indentSize * 2, ' ') << "let sampleJSON = \"\"\"\n"
-            << sampleData.dump(4) << "\n"
-            << std::string(config.indentSize * 2, ' ') << "\"\"\"\n\n"
-            << std::string(config.indentSize * 2, ' ') << "let jsonData = sampleJSON.data(using: .utf8)!\n"
-            << std::string(config.indentSize * 2, ' ') << "let decoder = JSONDecoder()\n"
-            << std::string(config.indentSize * 2, ' ') << "let obj = try decoder.decode(" << className << ".self, from: jsonData)\n\n"
-            << std::string(config.indentSize * 2, ' ') << "let encoder = JSONEncoder()\n"
-            << std::string(config.indentSize * 2, ' ') << "encoder.outputFormatting = .prettyPrinted\n"
-            << std::string(config.indentSize * 2, ' ') << "let encodedData = try encoder.encode(obj)\n"
-            << std::string(config.indentSize * 2, ' ') << "let encodedJSON = String(data: encodedData, encoding: .utf8)!\n\n"
-            << std::string(config.indentSize * 2, ' ') << "XCTAssertEqual(sampleJSON, encodedJSON)\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "Any?";
-        if (value.is_boolean()) return "Bool";
-        if (value.is_number_integer()) return "Int";
-        if (value.is_number_float()) return "Double";
-        if (value.is_string()) return "String";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return "[" + toLanguageType(value[0], config) + "]";
-            }
-            return "[Any]";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "Any";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "extension " << className << " {\n"
-            << std::string(config.indentSize, ' ') << "func isValid() -> Bool {\n"
-            << std::string(config.indentSize * 2, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize * 2, ' ') << "return true\n"
-            << std::string(config.indentSize, ' ') << "}\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+class SwiftGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        outFile << "import Foundation\n\n";
+    }
+
+    // String raw values give the synthesized Codable conformance, which compares the decoded string once
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::CAMEL);
+            outFile << "enum " << name << ": String, Codable {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << std::string(config.indentSize, ' ') << "case " << cases[i] << " = " << swiftString(definition.values[i]) << "\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        ++depth;
+        numberFormats[className] = NumberFormat::readAll(schema, data, config);
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        stringFormats[className] = StringFormat::readAll(schema, data, config);
+
+        outFile << "struct " << className << ": Codable {\n";
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << indent1 << "/// " << schema["properties"][key]["description"] << "\n";
+            }
+            outFile << indent1 << "let " << key << ": " << type << "\n";
+        }
+
+        // Generate CodingKeys enum
+        outFile << "\n" << indent1 << "enum CodingKeys: String, CodingKey {\n";
+        for (auto& [key, value] : data.items()) {
+            outFile << indent2 << "case " << key << " = " << json(key).dump() << "\n";
+        }
+        outFile << indent1 << "}\n";
+
+        outFile << "}\n\n";
+
+        generateCodableMethods(className, data, outFile, config);
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateUnion(newClassName, *tagged, outFile, config);
+                for (const auto& variant : tagged->variants) {
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else if (nested) {
+                std::string newClassName = className + "_" + key;
+                circHandler.addDependency(className, newClassName);
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+
+        if (--depth == 0 && usesNull) {
+            generateNullType(outFile, config);
+        }
+        if (depth == 0 && usesDateTime) {
+            generateDateTimeCoding(outFile, config);
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        testFile << "import XCTest\n"
+            << "@testable import YourModuleName\n\n"
+            << "class " << className << "Tests: XCTestCase {\n\n"
+            << std::string(config.indentSize, ' ') << "func testSerializationDeserialization() throws {\n"
+            << std::string(config.indentSize * 2, ' ') << "let sampleJSON = \"\"\"\n"
+            << sampleData.dump(4) << "\n"
+            << std::string(config.indentSize * 2, ' ') << "\"\"\"\n\n"
+            << std::string(config.indentSize * 2, ' ') << "let jsonData = sampleJSON.data(using: .utf8)!\n"
+            << std::string(config.indentSize * 2, ' ') << "let decoder = JSONDecoder()\n"
+            << std::string(config.indentSize * 2, ' ') << "let obj = try decoder.decode(" << className << ".self, from: jsonData)\n\n"
+            << std::string(config.indentSize * 2, ' ') << "let encoder = JSONEncoder()\n"
+            << std::string(config.indentSize * 2, ' ') << "let encodedData = try encoder.encode(obj)\n\n"
+            << std::string(config.indentSize * 2, ' ') << "// Key order and number formatting may differ, so the documents are compared as values\n";
+        if (config.stringFormats) {
+            // Date-times are written back in UTC, so the output is compared with its own round trip
+            testFile << std::string(config.indentSize * 2, ' ') << "let reencodedData = try encoder.encode(try decoder.decode(" << className << ".self, from: encodedData))\n"
+                << std::string(config.indentSize * 2, ' ') << "let expected = try JSONSerialization.jsonObject(with: encodedData) as? NSDictionary\n"
+                << std::string(config.indentSize * 2, ' ') << "let actual = try JSONSerialization.jsonObject(with: reencodedData) as? NSDictionary\n";
+        }
+        else {
+            testFile << std::string(config.indentSize * 2, ' ') << "let expected = try JSONSerialization.jsonObject(with: jsonData) as? NSDictionary\n"
+                << std::string(config.indentSize * 2, ' ') << "let actual = try JSONSerialization.jsonObject(with: encodedData) as? NSDictionary\n";
+        }
+        testFile
+            << std::string(config.indentSize * 2, ' ') << "XCTAssertEqual(expected, actual)\n"
+            << std::string(config.indentSize, ' ') << "}\n"
+            << "}\n";
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "Any?";
+        if (value.is_boolean()) return "Bool";
+        if (value.is_number_integer()) return "Int";
+        if (value.is_number_float()) return "Double";
+        if (value.is_string()) return "String";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return "[" + toLanguageType(value[0], config) + "]";
+            }
+            return "[Any]";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "Any";
+    }
+
+private:
+    int depth = 0;
+    bool usesNull = false;
+    bool usesDateTime = false;
+    std::map<std::string, std::map<std::string, NumberFormat>> numberFormats;
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    std::map<std::string, std::map<std::string, StringFormat>> stringFormats;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    // An enum with a case per variant. Decoding reads only the tag from a container of its own and then
+    // hands the same decoder to the variant struct, which keeps the tag as an ordinary property
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::vector<std::string> tags;
+        for (const auto& variant : tagged.variants) {
+            tags.push_back(variant.tag);
+        }
+        std::vector<std::string> cases = EnumDefinition{ className, tags }.caseNames(EnumDefinition::Style::CAMEL);
+
+        outFile << "enum " << className << ": Codable {\n";
+        for (size_t i = 0; i < cases.size(); ++i) {
+            outFile << indent1 << "case " << cases[i] << "(" << className << "_" << tagged.variants[i].name << ")\n";
+        }
+        outFile << "\n"
+            << indent1 << "private enum TagKey: String, CodingKey {\n"
+            << indent2 << "case tag = " << swiftString(tagged.property) << "\n"
+            << indent1 << "}\n\n"
+            << indent1 << "init(from decoder: Decoder) throws {\n"
+            << indent2 << "let container = try decoder.container(keyedBy: TagKey.self)\n"
+            << indent2 << "let tag = try container.decode(String.self, forKey: .tag)\n"
+            << indent2 << "switch tag {\n";
+        for (size_t i = 0; i < cases.size(); ++i) {
+            outFile << indent2 << "case " << swiftString(tagged.variants[i].tag) << ":\n"
+                << indent3 << "self = ." << cases[i] << "(try " << className << "_" << tagged.variants[i].name << "(from: decoder))\n";
+        }
+        outFile << indent2 << "default:\n"
+            << indent3 << "throw DecodingError.dataCorruptedError(forKey: .tag, in: container, debugDescription: \"Unknown " << className << " " << tagged.property << ": \\(tag)\")\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "func encode(to encoder: Encoder) throws {\n"
+            << indent2 << "switch self {\n";
+        for (const auto& name : cases) {
+            outFile << indent2 << "case ." << name << "(let variant):\n"
+                << indent3 << "try variant.encode(to: encoder)\n";
+        }
+        outFile << indent2 << "}\n"
+            << indent1 << "}\n";
+        if (config.generateValidation) {
+            outFile << "\n"
+                << indent1 << "func isValid() -> Bool {\n"
+                << indent2 << "switch self {\n";
+            for (const auto& name : cases) {
+                outFile << indent2 << "case ." << name << "(let variant):\n"
+                    << indent3 << "return variant.isValid()\n";
+            }
+            outFile << indent2 << "}\n"
+                << indent1 << "}\n";
+        }
+        outFile << "}\n\n";
+    }
+
+    // Any is not Codable, so nulls and items of empty arrays are typed as JSONNull
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_string() && stringFormats[className].count(key)) {
+            // JSONDecoder reads UUID and base64 Data itself; dates go through JSONDateTime
+            switch (stringFormats[className][key].kind) {
+            case StringFormat::Kind::UUID: return "UUID";
+            case StringFormat::Kind::DATE_TIME:
+                usesDateTime = true;
+                return "Date";
+            default: return "Data";
+            }
+        }
+        if (value.is_object()) return className + "_" + key;
+        if (value.is_null()) {
+            usesNull = true;
+            return "JSONNull?";
+        }
+        if (value.is_array()) {
+            if (value.empty()) {
+                usesNull = true;
+                return "[JSONNull]";
+            }
+            return "[" + fieldType(className, key, value[0], config) + "]";
+        }
+        if (value.is_number() && numberFormats[className][key].bits != 0) {
+            const NumberFormat& format = numberFormats[className][key];
+            if (format.isFloat) return format.bits == 32 ? "Float" : "Double";
+            return (format.isUnsigned ? "UInt" : "Int") + std::to_string(format.bits);
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    // Hand-written conformance decodes each field with a concrete type in declaration order instead of
+    // the synthesized implementation; in an extension, so the memberwise initializer is kept
+    void generateCodableMethods(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+
+        outFile << "extension " << className << " {\n"
+            << indent1 << "init(from decoder: Decoder) throws {\n";
+        if (!data.empty()) {
+            outFile << indent2 << "let container = try decoder.container(keyedBy: CodingKeys.self)\n";
+        }
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            if (value.is_null()) {
+                outFile << indent2 << key << " = try container.decodeIfPresent(JSONNull.self, forKey: ." << key << ")\n";
+            }
+            else if (type == "Date") {
+                outFile << indent2 << key << " = try JSONDateTime.decode(container, forKey: ." << key << ")\n";
+            }
+            else {
+                outFile << indent2 << key << " = try container.decode(" << type << ".self, forKey: ." << key << ")\n";
+            }
+        }
+        outFile << indent1 << "}\n\n"
+            << indent1 << "func encode(to encoder: Encoder) throws {\n";
+        if (!data.empty()) {
+            outFile << indent2 << "var container = encoder.container(keyedBy: CodingKeys.self)\n";
+        }
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            // UUID encodes upper-case by default, while the text form in JSON is conventionally lower-case
+            std::string source = type == "Date" ? "JSONDateTime.string(from: " + key + ")" : type == "UUID" ? key + ".uuidString.lowercased()" : key;
+            outFile << indent2 << "try container.encode(" << source << ", forKey: ." << key << ")\n";
+        }
+        outFile << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    void generateNullType(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "/// Placeholder for values that were null in the sample\n"
+            << "struct JSONNull: Codable, Hashable {\n"
+            << indent1 << "init() {}\n\n"
+            << indent1 << "init(from decoder: Decoder) throws {\n"
+            << indent2 << "let container = try decoder.singleValueContainer()\n"
+            << indent2 << "if !container.decodeNil() {\n"
+            << indent3 << "throw DecodingError.typeMismatch(JSONNull.self, DecodingError.Context(codingPath: decoder.codingPath, debugDescription: \"Expected null\"))\n"
+            << indent2 << "}\n"
+            << indent1 << "}\n\n"
+            << indent1 << "func encode(to encoder: Encoder) throws {\n"
+            << indent2 << "var container = encoder.singleValueContainer()\n"
+            << indent2 << "try container.encodeNil()\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    // ISO8601DateFormatter parses a fraction only when asked to and then requires one, so both
+    // variants are tried. Dates are written in UTC, with milliseconds when they have a fraction
+    void generateDateTimeCoding(std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        outFile << "/// RFC 3339 date-times for the Codable conformances above\n"
+            << "enum JSONDateTime {\n"
+            << indent1 << "private static let withFraction: ISO8601DateFormatter = {\n"
+            << indent2 << "let formatter = ISO8601DateFormatter()\n"
+            << indent2 << "formatter.formatOptions = [.withInternetDateTime, .withFractionalSeconds]\n"
+            << indent2 << "return formatter\n"
+            << indent1 << "}()\n\n"
+            << indent1 << "private static let withoutFraction = ISO8601DateFormatter()\n\n"
+            << indent1 << "static func decode<Key: CodingKey>(_ container: KeyedDecodingContainer<Key>, forKey key: Key) throws -> Date {\n"
+            << indent2 << "let text = try container.decode(String.self, forKey: key)\n"
+            << indent2 << "guard let date = withFraction.date(from: text) ?? withoutFraction.date(from: text) else {\n"
+            << indent3 << "throw DecodingError.dataCorruptedError(forKey: key, in: container, debugDescription: \"Invalid date-time: \\(text)\")\n"
+            << indent2 << "}\n"
+            << indent2 << "return date\n"
+            << indent1 << "}\n\n"
+            << indent1 << "static func string(from date: Date) -> String {\n"
+            << indent2 << "let seconds = date.timeIntervalSince1970\n"
+            << indent2 << "return (seconds.rounded(.down) == seconds ? withoutFraction : withFraction).string(from: date)\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    // Patterns are compiled once into static properties; every other keyword is a plain comparison.
+    // Decoding already rejects missing fields, which covers `required`; lengths count Unicode scalars
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        outFile << "extension " << className << " {\n";
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern && !stringFormats[className].count(key)) {
+                outFile << indent1 << "private static let " << key << "Pattern = try! NSRegularExpression(pattern: " << swiftString(*constraints.pattern) << ")\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        outFile << indent1 << "func isValid() -> Bool {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent2 << "if " << violation << " {\n"
+                << indent3 << "return false\n"
+                << indent2 << "}\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            // A formatted field was checked by its decoder
+            if (stringFormats[className].count(key)) continue;
+            if (value.is_string()) {
+                if (constraints.minLength) check(key + ".unicodeScalars.count < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(key + ".unicodeScalars.count > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check("Self." + key + "Pattern.firstMatch(in: " + key + ", range: NSRange(" + key + ".startIndex..., in: " + key + ")) == nil");
+            }
+            if (value.is_number()) {
+                // A bound the integer type already keeps could never fail, so it is left out
+                const NumberFormat& format = numberFormats[className][key];
+                if (constraints.minimum && !format.implies(*constraints.minimum, true)) check(key + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum && !format.implies(*constraints.maximum, false)) check(key + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    std::string literal = candidate.is_string() ? swiftString(candidate.get<std::string>())
+                        : value.is_number_float() ? FieldConstraints::boundLiteral(candidate.get<double>(), false, true) : candidate.dump();
+                    violation += (violation.empty() ? "" : " && ") + key + " != " + literal;
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.minItems) check(key + ".count < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(key + ".count > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object()) {
+                    outFile << indent2 << "for item in " << key << " where !item.isValid() {\n"
+                        << indent3 << "return false\n"
+                        << indent2 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                check("!" + key + ".isValid()");
+            }
+        }
+        outFile << indent2 << "return true\n"
+            << indent1 << "}\n"
+            << "}\n\n";
+    }
+
+    std::string swiftString(const std::string& text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+};
@@ -1,87 +1,584 @@
-#include "json_model_generator.hpp"
-#include <fstream>
-#include <iostream>
-
-class TypeScriptGenerator : public LanguageGenerator {
-public:
-    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
-        // TypeScript doesn't need any special imports for basic types
-    }
-
-    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
-        if (schema.contains("definitions")) {
-            for (auto& [name, def] : schema["definitions"].items()) {
-                if (def.contains("enum")) {
-                    outFile << "export enum " << name << " {\n";
-                    for (const auto& value : def["enum"]) {
-                        outFile << std::string(config.indentSize, ' ') << value << " = \"" << value << "\",\n";
-                    }
-                    outFile << "}\n\n";
-                }
-            }
-        }
-    }
-
-    void generateClass(const std::string& className, const json& data, const json& schema,
-        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
-        outFile << "export interface " << className << " {\n";
-
-        for (auto& [key, value] : data.items()) {
-            std::string type = toLanguageType(value, config, key);
-            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
-                outFile << std::string(config.indentSize, ' ') << "/**\n"
-                    << std::string(config.indentSize, ' ') << " * " << schema["properties"][key]["description"] << "\n"
-                    << std::string(config.indentSize, ' ') << " */\n";
-            }
-            outFile << std::string(config.indentSize, ' ') << key << ": " << type << ";\n";
-
-            if (value.is_object()) {
-                std::string newClassName = className + "_" + key;
-                circHandler.addDependency(className, newClassName);
-                generateClass(newClassName, value, schema["properties"][key], outFile, config, circHandler);
-            }
-        }
-
-        outFile << "}\n\n";
-
-        if (config.generateValidation) {
-            generateValidationMethod(className, schema, outFile, config);
-        }
-    }
-
-    void generateUnitTests(const std::string& className, const json& sampleData,
-        std::ofstream& testFile, const Config& config) override {
-        testFile << "import { " << className << " } from './" << className << "';\n\n"
-            << "describe('" << className << "', () => {\n"
-            << std::string(config.indentSize, ' ') << "it('should serialize and deserialize correctly', () => {\n"
-            << std::string(config.indentSize * 2, ' ') << "const sampleData: " << className << " = " << sampleData.dump() << ";\n"
-            << std::string(config.indentSize * 2, ' ') << "const serialized = JSON.stringify(sampleData);\n"
-            << std::string(config.indentSize * 2, ' ') << "const deserialized: " << className << " = JSON.parse(serialized);\n"
-            << std::string(config.indentSize * 2, ' ') << "expect(deserialized).toEqual(sampleData);\n"
-            << std::string(config.indentSize, ' ') << "});\n"
-            << "});\n";
-    }
-
-    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
-        if (value.is_null()) return "null";
-        if (value.is_boolean()) return "boolean";
-        if (value.is_number()) return "number";
-        if (value.is_string()) return "string";
-        if (value.is_array()) {
-            if (!value.empty()) {
-                return toLanguageType(value[0], config) + "[]";
-            }
-            return "any[]";
-        }
-        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
-        return "any";
-    }
-
-private:
-    void generateValidationMethod(const std::string& className, const json& schema, std::ofstream& outFile, const Config& config) {
-        outFile << "export function is" << className << "Valid(obj: " << className << "): boolean {\n"
-            << std::string(config.indentSize, ' ') << "// Implement validation logic here\n"
-            << std::string(config.indentSize, ' ') << "return true;\n"
-            << "}\n\n";
-    }
-};
\ No newline at end of file
+#include "json_model_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+class TypeScriptGenerator : public LanguageGenerator {
+public:
+    void generateFileHeader(std::ofstream& outFile, const Config& config) override {
+        // TypeScript doesn't need any special imports for basic types
+    }
+
+    // String enums keep the JSON value at runtime, so parsed data needs no mapping; the guard is a
+    // single switch over the allowed values
+    void generateEnums(const json& schema, std::ofstream& outFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        enums = EnumDefinition::readAll(schema);
+        for (const auto& [name, definition] : enums) {
+            std::vector<std::string> cases = definition.caseNames(EnumDefinition::Style::PASCAL);
+            outFile << "export enum " << name << " {\n";
+            for (size_t i = 0; i < cases.size(); ++i) {
+                outFile << indent1 << cases[i] << " = " << json(definition.values[i]).dump() << ",\n";
+            }
+            outFile << "}\n\n"
+                << "export function is" << name << "(value: unknown): value is " << name << " {\n"
+                << indent1 << "switch (value) {\n";
+            for (const auto& value : definition.values) {
+                outFile << indent2 << "case " << json(value).dump() << ":\n";
+            }
+            outFile << indent3 << "return true;\n"
+                << indent2 << "default:\n"
+                << indent3 << "return false;\n"
+                << indent1 << "}\n"
+                << "}\n\n";
+        }
+    }
+
+    void generateClass(const std::string& className, const json& data, const json& schema,
+        std::ofstream& outFile, const Config& config, CircularReferenceHandler& circHandler) override {
+        enumFields[className] = EnumDefinition::references(schema, data, enums);
+        for (auto& [key, value] : data.items()) {
+            std::optional<TaggedUnion> tagged = TaggedUnion::read(schema, key, value, config);
+            if (tagged) {
+                unions[className + "_" + key] = *tagged;
+            }
+        }
+        outFile << "export interface " << className << " {\n";
+
+        for (auto& [key, value] : data.items()) {
+            std::string type = fieldType(className, key, value, config);
+            if (config.generateDocs && schema.contains("properties") && schema["properties"].contains(key) && schema["properties"][key].contains("description")) {
+                outFile << std::string(config.indentSize, ' ') << "/**\n"
+                    << std::string(config.indentSize, ' ') << " * " << schema["properties"][key]["description"] << "\n"
+                    << std::string(config.indentSize, ' ') << " */\n";
+            }
+            outFile << std::string(config.indentSize, ' ') << key << ": " << type << ";\n";
+        }
+
+        outFile << "}\n\n";
+
+        if (config.typedArrays) {
+            generateTypedArrayConversions(className, data, outFile, config);
+        }
+
+        generateTypeGuards(className, data, outFile, config, false);
+        if (config.typedArrays) {
+            // Parsed JSON still holds plain number arrays, so it is checked before conversion
+            generateTypeGuards(className, data, outFile, config, true);
+        }
+        generateParseFunction(className, outFile, config);
+
+        if (config.generateValidation) {
+            generateValidationMethod(className, data, schema, outFile, config);
+        }
+
+        // Interfaces cannot nest, so nested ones follow at module level
+        for (auto& [key, value] : data.items()) {
+            const json* nested = objectSample(value);
+            if (!nested) {
+                continue;
+            }
+            std::string newClassName = className + "_" + key;
+            circHandler.addDependency(className, newClassName);
+            if (unions.count(newClassName)) {
+                const TaggedUnion& tagged = unions[newClassName];
+                generateUnion(newClassName, tagged, outFile, config);
+                for (const auto& variant : tagged.variants) {
+                    tags[newClassName + "_" + variant.name] = { tagged.property, variant.tag };
+                    circHandler.addDependency(newClassName, newClassName + "_" + variant.name);
+                    generateClass(newClassName + "_" + variant.name, *variant.sample, *variant.schema, outFile, config, circHandler);
+                }
+            }
+            else {
+                generateClass(newClassName, *nested, nestedSchema(schema, key, *nested), outFile, config, circHandler);
+            }
+        }
+    }
+
+    void generateUnitTests(const std::string& className, const json& sampleData,
+        std::ofstream& testFile, const Config& config) override {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+
+        testFile << "import { " << className << ", is" << className << ", assert" << className << ", parse" << className;
+        if (config.typedArrays) {
+            testFile << ", decode" << className << ", encode" << className;
+        }
+        testFile << " } from './" << className << "';\n\n"
+            << "describe('" << className << "', () => {\n"
+            << indent1 << "const sampleJson = " << json(sampleData.dump()).dump() << ";\n\n"
+            << indent1 << "it('should serialize and deserialize correctly', () => {\n";
+        if (!config.typedArrays) {
+            testFile << indent2 << "const sampleData: " << className << " = " << sampleData.dump() << ";\n"
+                << indent2 << "const serialized = JSON.stringify(sampleData);\n"
+                << indent2 << "const deserialized: " << className << " = JSON.parse(serialized);\n"
+                << indent2 << "expect(deserialized).toEqual(sampleData);\n";
+        }
+        else {
+            // Typed arrays serialize as index-keyed objects, so the round trip goes through the generated conversions
+            testFile << indent2 << "const decoded: " << className << " = decode" << className << "(JSON.parse(sampleJson));\n"
+                << indent2 << "const serialized = JSON.stringify(encode" << className << "(decoded));\n"
+                << indent2 << "expect(JSON.parse(serialized)).toEqual(JSON.parse(sampleJson));\n";
+        }
+        testFile << indent1 << "});\n\n"
+            << indent1 << "it('should check values with the compiled guards', () => {\n"
+            << indent2 << "const parsed: " << className << " = parse" << className << "(sampleJson);\n"
+            << indent2 << "expect(is" << className << "(parsed)).toBe(true);\n"
+            << indent2 << "expect(is" << className << "(null)).toBe(false);\n"
+            << indent2 << "expect(() => assert" << className << "([], 'sample')).toThrow(TypeError);\n"
+            << indent1 << "});\n"
+            << "});\n";
+
+        generateBenchmark(className, sampleData, config);
+    }
+
+    std::string toLanguageType(const json& value, const Config& config, const std::string& key = "") override {
+        if (value.is_null()) return "null";
+        if (value.is_boolean()) return "boolean";
+        if (value.is_number()) return "number";
+        if (value.is_string()) return "string";
+        if (value.is_array()) {
+            if (!value.empty()) {
+                return toLanguageType(value[0], config) + "[]";
+            }
+            return "any[]";
+        }
+        if (value.is_object()) return key.substr(0, 1) + key.substr(1);
+        return "any";
+    }
+
+private:
+    std::map<std::string, EnumDefinition> enums;
+    std::map<std::string, std::map<std::string, std::string>> enumFields;
+    // Tag property and value of each union variant, typed as a literal so the union discriminates
+    std::map<std::string, std::pair<std::string, std::string>> tags;
+    std::map<std::string, TaggedUnion> unions;
+
+    // Innermost object of a value, looking through arrays of objects
+    const json* objectSample(const json& value) {
+        const json* current = &value;
+        while (current->is_array() && !current->empty()) {
+            current = &(*current)[0];
+        }
+        return current->is_object() ? current : nullptr;
+    }
+
+    bool isTag(const std::string& className, const std::string& key) {
+        return tags.count(className) && tags[className].first == key;
+    }
+
+    // A discriminated union of the variant interfaces. Guards, conversions and validation read the
+    // tag once and hand the value to the matching variant's function
+    void generateUnion(const std::string& className, const TaggedUnion& tagged, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string tag = json(tagged.property).dump();
+
+        outFile << "export type " << className << " =";
+        for (const auto& variant : tagged.variants) {
+            outFile << "\n" << indent1 << "| " << className << "_" << variant.name;
+        }
+        outFile << ";\n\n";
+
+        auto dispatch = [&](const std::string& source, const std::function<std::string(const std::string&)>& call, const std::string& otherwise) {
+            outFile << indent1 << "switch (" << source << ") {\n";
+            for (const auto& variant : tagged.variants) {
+                outFile << indent2 << "case " << json(variant.tag).dump() << ":\n"
+                    << indent3 << call(className + "_" + variant.name) << "\n";
+            }
+            outFile << indent2 << "default:\n"
+                << indent3 << otherwise << "\n"
+                << indent1 << "}\n";
+        };
+
+        if (config.typedArrays) {
+            outFile << "export function decode" << className << "(raw: any): " << className << " {\n"
+                << indent1 << "if (raw == null) return raw;\n";
+            dispatch("raw[" + tag + "]", [](const std::string& variant) { return "return decode" + variant + "(raw);"; }, "return raw;");
+            outFile << "}\n\n"
+                << "export function encode" << className << "(obj: " << className << "): any {\n"
+                << indent1 << "if (obj == null) return obj;\n";
+            dispatch("obj[" + tag + "]", [](const std::string& variant) { return "return encode" + variant + "(obj as " + variant + ");"; }, "return obj;");
+            outFile << "}\n\n";
+        }
+
+        std::vector<bool> modes = { false };
+        if (config.typedArrays) {
+            modes.push_back(true);
+        }
+        for (bool rawJson : modes) {
+            std::string name = className + (rawJson ? "Json" : "");
+            std::string suffix = rawJson ? "Json" : "";
+            outFile << "export function is" << name << "(value: unknown): " << (rawJson ? "boolean" : "value is " + className) << " {\n"
+                << indent1 << "if (typeof value !== \"object\" || value === null || Array.isArray(value)) return false;\n";
+            dispatch("(value as Record<string, unknown>)[" + tag + "]", [&](const std::string& variant) { return "return is" + variant + suffix + "(value);"; }, "return false;");
+            outFile << "}\n\n"
+                << "export function assert" << name << "(value: unknown, path: string = \"" << className << "\"): " << (rawJson ? "void" : "asserts value is " + className) << " {\n"
+                << indent1 << "if (typeof value !== \"object\" || value === null || Array.isArray(value)) throw new TypeError(path + \": expected object\");\n";
+            std::string expected;
+            for (const auto& variant : tagged.variants) {
+                expected += (expected.empty() ? "" : ", ") + variant.tag;
+            }
+            dispatch("(value as Record<string, unknown>)[" + tag + "]", [&](const std::string& variant) { return "return assert" + variant + suffix + "(value, path);"; },
+                "throw new TypeError(path + " + json("." + tagged.property + ": expected one of " + expected).dump() + ");");
+            outFile << "}\n\n";
+        }
+
+        if (config.generateValidation) {
+            outFile << "export function is" << className << "Valid(obj: " << className << "): boolean {\n";
+            dispatch("obj[" + tag + "]", [](const std::string& variant) { return "return is" + variant + "Valid(obj as " + variant + ");"; }, "return false;");
+            outFile << "}\n\n";
+        }
+    }
+
+    // Element kind of a non-empty array whose items are all numbers: "int32", "int64" or "float64";
+    // empty for anything else
+    std::string numericArrayKind(const json& value) {
+        if (!value.is_array() || value.empty()) return "";
+        bool fitsInt32 = true;
+        for (const auto& item : value) {
+            if (!item.is_number()) return "";
+            if (item.is_number_float()) return "float64";
+            if (item.is_number_unsigned() ? item.get<uint64_t>() > INT32_MAX : item.get<int64_t>() < INT32_MIN || item.get<int64_t>() > INT32_MAX) {
+                fitsInt32 = false;
+            }
+        }
+        return fitsInt32 ? "int32" : "int64";
+    }
+
+    std::string typedArrayType(const json& value) {
+        // Integers beyond 32 bits lose nothing as doubles up to 2^53, which is all a JS number holds anyway
+        return numericArrayKind(value) == "int32" ? "Int32Array" : "Float64Array";
+    }
+
+    std::string fieldType(const std::string& className, const std::string& key, const json& value, const Config& config) {
+        if (isTag(className, key)) return json(tags[className].second).dump();
+        if (enumFields[className].count(key)) return enumFields[className][key];
+        if (value.is_object()) return className + "_" + key;
+        if (config.typedArrays && !numericArrayKind(value).empty()) return typedArrayType(value);
+        if (value.is_array() && !value.empty()) {
+            if (!isUniform(value)) return "unknown[]";
+            std::string item = fieldType(className, key, value[0], config);
+            return (item.find('|') != std::string::npos ? "(" + item + ")" : item) + "[]";
+        }
+        return toLanguageType(value, config, key);
+    }
+
+    // Whether all items of an array have the JSON type of the first, which then types the array
+    bool isUniform(const json& value) {
+        for (const auto& item : value) {
+            if (item.type() != value[0].type() && !(item.is_number() && value[0].is_number())) return false;
+        }
+        return true;
+    }
+
+    // Whether a value holds typed arrays, directly or through nested objects, and so needs converting
+    bool hasTypedArrays(const json& value) {
+        if (value.is_object()) {
+            for (auto& [key, item] : value.items()) {
+                if (hasTypedArrays(item)) return true;
+            }
+            return false;
+        }
+        if (!numericArrayKind(value).empty()) return true;
+        return value.is_array() && !value.empty() && isUniform(value) && hasTypedArrays(value[0]);
+    }
+
+    std::string decodeExpr(const std::string& source, const std::string& className, const std::string& key, const json& value, int level) {
+        if (value.is_object()) {
+            return "decode" + className + "_" + key + "(" + source + ")";
+        }
+        if (!numericArrayKind(value).empty()) {
+            return typedArrayType(value) + ".from(" + source + ")";
+        }
+        std::string item = "v" + std::to_string(level);
+        return source + ".map((" + item + ": any) => " + decodeExpr(item, className, key, value[0], level + 1) + ")";
+    }
+
+    std::string encodeExpr(const std::string& source, const std::string& className, const std::string& key, const json& value, int level) {
+        if (value.is_object()) {
+            return "encode" + className + "_" + key + "(" + source + ")";
+        }
+        if (!numericArrayKind(value).empty()) {
+            return "Array.from(" + source + ")";
+        }
+        std::string item = "v" + std::to_string(level);
+        return source + ".map((" + item + ": any) => " + encodeExpr(item, className, key, value[0], level + 1) + ")";
+    }
+
+    // JSON.parse yields boxed number arrays and JSON.stringify writes typed arrays as index-keyed
+    // objects, so decode/encode copy between the two; fields without typed arrays are passed through
+    void generateTypedArrayConversions(const std::string& className, const json& data, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+
+        outFile << "export function decode" << className << "(raw: any): " << className << " {\n"
+            << indent1 << "if (raw == null) return raw;\n"
+            << indent1 << "return {\n"
+            << indent2 << "...raw,\n";
+        for (auto& [key, value] : data.items()) {
+            if (hasTypedArrays(value) || unions.count(className + "_" + key)) {
+                std::string source = "raw[" + json(key).dump() + "]";
+                outFile << indent2 << json(key).dump() << ": " << source << " == null ? " << source << " : " << decodeExpr(source, className, key, value, 0) << ",\n";
+            }
+        }
+        outFile << indent1 << "};\n"
+            << "}\n\n"
+            << "export function encode" << className << "(obj: " << className << "): any {\n"
+            << indent1 << "if (obj == null) return obj;\n"
+            << indent1 << "return {\n"
+            << indent2 << "...obj,\n";
+        for (auto& [key, value] : data.items()) {
+            if (hasTypedArrays(value) || unions.count(className + "_" + key)) {
+                std::string source = "obj[" + json(key).dump() + "]";
+                outFile << indent2 << json(key).dump() << ": " << source << " == null ? " << source << " : " << encodeExpr(source, className, key, value, 0) << ",\n";
+            }
+        }
+        outFile << indent1 << "};\n"
+            << "}\n\n";
+    }
+
+    // Appends straight-line checks of `expr` against the sample's type. In guard mode a mismatch returns
+    // false; in assert mode it throws with the path, built only once a check has failed. Json mode checks
+    // parsed JSON, where typed arrays are still plain number arrays
+    void generateChecks(const std::string& expr, const std::string& path, const std::string& className, const std::string& key, const json& value,
+        bool asserting, bool rawJson, int level, std::ofstream& outFile, const Config& config) {
+        std::string pad(config.indentSize * level, ' ');
+        std::string suffix = rawJson ? "Json" : "";
+        auto fail = [&](const std::string& expected) {
+            return asserting ? "throw new TypeError(" + path + " + \": expected " + expected + "\");" : "return false;";
+        };
+
+        if (value.is_object()) {
+            std::string nested = className + "_" + key + suffix;
+            outFile << pad << (asserting ? "assert" + nested + "(" + expr + ", " + path + ");\n" : "if (!is" + nested + "(" + expr + ")) return false;\n");
+        }
+        else if (value.is_null()) {
+            outFile << pad << "if (" << expr << " !== null) " << fail("null") << "\n";
+        }
+        else if (isTag(className, key)) {
+            std::string tag = json(tags[className].second).dump();
+            outFile << pad << "if (" << expr << " !== " << tag << ") " << fail(tags[className].second) << "\n";
+        }
+        else if (value.is_string() && enumFields[className].count(key)) {
+            std::string name = enumFields[className][key];
+            outFile << pad << "if (!is" << name << "(" << expr << ")) " << fail(name) << "\n";
+        }
+        else if (value.is_string() || value.is_boolean() || value.is_number()) {
+            std::string type = toLanguageType(value, config);
+            outFile << pad << "if (typeof " << expr << " !== \"" << type << "\") " << fail(type) << "\n";
+        }
+        else if (config.typedArrays && !rawJson && !numericArrayKind(value).empty()) {
+            std::string type = typedArrayType(value);
+            outFile << pad << "if (!(" << expr << " instanceof " << type << ")) " << fail(type) << "\n";
+        }
+        else if (value.is_array()) {
+            std::string array = "a" + std::to_string(level);
+            std::string index = "i" + std::to_string(level);
+            outFile << pad << "const " << array << " = " << expr << ";\n"
+                << pad << "if (!Array.isArray(" << array << ")) " << fail("array") << "\n";
+            if (!value.empty() && isUniform(value)) {
+                // Items of typed arrays are only known to be numbers
+                const json element = config.typedArrays && !numericArrayKind(value).empty() ? json(0) : value[0];
+                outFile << pad << "for (let " << index << " = 0; " << index << " < " << array << ".length; " << index << "++) {\n";
+                generateChecks(array + "[" + index + "]", path + " + \"[\" + " + index + " + \"]\"", className, key, element, asserting, rawJson, level + 1, outFile, config);
+                outFile << pad << "}\n";
+            }
+        }
+    }
+
+    // is<Class> narrows with unrolled property checks; assert<Class> re-walks only after the guard fails
+    void generateTypeGuards(const std::string& className, const json& data, std::ofstream& outFile, const Config& config, bool rawJson) {
+        std::string indent1(config.indentSize, ' ');
+        std::string name = className + (rawJson ? "Json" : "");
+        std::string target = rawJson ? "boolean" : "value is " + className;
+        std::string asserted = rawJson ? "void" : "asserts value is " + className;
+
+        for (bool asserting : { false, true }) {
+            if (asserting) {
+                outFile << "export function assert" << name << "(value: unknown, path: string = \"" << className << "\"): " << asserted << " {\n"
+                    << indent1 << "if (is" << name << "(value)) return;\n"
+                    << indent1 << "if (typeof value !== \"object\" || value === null || Array.isArray(value)) throw new TypeError(path + \": expected object\");\n";
+            }
+            else {
+                outFile << "export function is" << name << "(value: unknown): " << target << " {\n"
+                    << indent1 << "if (typeof value !== \"object\" || value === null || Array.isArray(value)) return false;\n";
+            }
+            if (!data.empty()) {
+                outFile << indent1 << "const v = value as Record<string, unknown>;\n";
+            }
+            for (auto& [key, value] : data.items()) {
+                std::string field = json(key).dump();
+                if (value.is_array() && (rawJson || !config.typedArrays || numericArrayKind(value).empty())) {
+                    // Array checks declare locals, so each field gets its own block
+                    outFile << indent1 << "{\n";
+                    generateChecks("v[" + field + "]", "path + " + json("." + key).dump(), className, key, value, asserting, rawJson, 2, outFile, config);
+                    outFile << indent1 << "}\n";
+                }
+                else {
+                    generateChecks("v[" + field + "]", "path + " + json("." + key).dump(), className, key, value, asserting, rawJson, 1, outFile, config);
+                }
+            }
+            if (!asserting) {
+                outFile << indent1 << "return true;\n";
+            }
+            outFile << "}\n\n";
+        }
+    }
+
+    void generateParseFunction(const std::string& className, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        outFile << "export function parse" << className << "(text: string): " << className << " {\n"
+            << indent1 << "const value: unknown = JSON.parse(text);\n";
+        if (config.typedArrays) {
+            outFile << indent1 << "assert" << className << "Json(value);\n"
+                << indent1 << "return decode" << className << "(value);\n";
+        }
+        else {
+            outFile << indent1 << "assert" << className << "(value);\n"
+                << indent1 << "return value;\n";
+        }
+        outFile << "}\n\n";
+    }
+
+    // JSON Schema-like description of the sample, for the interpretive side of the benchmark
+    json sampleSchema(const json& value) {
+        if (value.is_object()) {
+            json properties = json::object();
+            for (auto& [key, item] : value.items()) {
+                properties[key] = sampleSchema(item);
+            }
+            return { { "type", "object" }, { "properties", properties } };
+        }
+        if (value.is_array()) {
+            json schema = { { "type", "array" } };
+            if (!value.empty() && isUniform(value)) {
+                // Differently shaped objects, as in a tagged union, get no item schema either
+                json items = sampleSchema(value[0]);
+                if (std::all_of(value.begin(), value.end(), [&](const json& item) { return sampleSchema(item) == items; })) {
+                    schema["items"] = items;
+                }
+            }
+            return schema;
+        }
+        return { { "type", value.is_null() ? "null" : toLanguageType(value, Config()) } };
+    }
+
+    // Benchmark sources are written next to the model as <Class>.bench.ts
+    void generateBenchmark(const std::string& className, const json& sampleData, const Config& config) {
+        std::string directory = config.outputFile.substr(0, config.outputFile.find_last_of("/\\") + 1);
+        std::ofstream benchFile(directory + className + ".bench.ts");
+        if (!benchFile.is_open()) {
+            return;
+        }
+
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+        std::string guard = "is" + className + (config.typedArrays ? "Json" : "");
+
+        benchFile << "// Compiled type guard versus an interpretive schema validator on the " << className << " sample.\n"
+            << "// Run with: npx ts-node " << className << ".bench.ts\n"
+            << "import { " << guard << " } from './" << className << "';\n\n"
+            << "type Schema = { type: string; properties?: Record<string, Schema>; items?: Schema };\n\n"
+            << "const SCHEMA: Schema = " << sampleSchema(sampleData).dump() << ";\n\n"
+            << "const SAMPLE_JSON = " << json(sampleData.dump()).dump() << ";\n\n"
+            << "// Walks the schema on every call, as a generic runtime validator does\n"
+            << "function interpret(schema: Schema, value: unknown): boolean {\n"
+            << indent1 << "switch (schema.type) {\n"
+            << indent2 << "case \"object\": {\n"
+            << indent3 << "if (typeof value !== \"object\" || value === null || Array.isArray(value)) return false;\n"
+            << indent3 << "const properties = schema.properties ?? {};\n"
+            << indent3 << "return Object.keys(properties).every((key) => interpret(properties[key], (value as Record<string, unknown>)[key]));\n"
+            << indent2 << "}\n"
+            << indent2 << "case \"array\":\n"
+            << indent3 << "return Array.isArray(value) && (schema.items === undefined || value.every((item) => interpret(schema.items!, item)));\n"
+            << indent2 << "case \"null\":\n"
+            << indent3 << "return value === null;\n"
+            << indent2 << "default:\n"
+            << indent3 << "return typeof value === schema.type;\n"
+            << indent1 << "}\n"
+            << "}\n\n"
+            << "function measure(name: string, check: (value: unknown) => boolean, value: unknown): void {\n"
+            << indent1 << "const iterations = 1000000;\n"
+            << indent1 << "let valid = 0;\n"
+            << indent1 << "const start = performance.now();\n"
+            << indent1 << "for (let i = 0; i < iterations; i++) {\n"
+            << indent2 << "if (check(value)) valid++;\n"
+            << indent1 << "}\n"
+            << indent1 << "const elapsed = performance.now() - start;\n"
+            << indent1 << "console.log(`${name}: ${((elapsed * 1e6) / iterations).toFixed(1)} ns per check (${valid} valid)`);\n"
+            << "}\n\n"
+            << "const sample: unknown = JSON.parse(SAMPLE_JSON);\n"
+            << "measure(\"compiled\", " << guard << ", sample);\n"
+            << "measure(\"interpreted\", (value) => interpret(SCHEMA, value), sample);\n";
+    }
+
+    // Patterns are compiled once into module-level constants; every other keyword is a plain comparison.
+    // Lengths are counted in UTF-16 code units, as String.length does
+    void generateValidationMethod(const std::string& className, const json& data, const json& schema, std::ofstream& outFile, const Config& config) {
+        std::string indent1(config.indentSize, ' ');
+        std::string indent2(config.indentSize * 2, ' ');
+        std::string indent3(config.indentSize * 3, ' ');
+
+        bool patterns = false;
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            if (value.is_string() && constraints.pattern) {
+                outFile << "const " << className << "_" << key << "Pattern = new RegExp(" << json(*constraints.pattern).dump() << ", \"u\");\n";
+                patterns = true;
+            }
+        }
+        if (patterns) {
+            outFile << "\n";
+        }
+
+        outFile << "export function is" << className << "Valid(obj: " << className << "): boolean {\n";
+        auto check = [&](const std::string& violation) {
+            outFile << indent1 << "if (" << violation << ") return false;\n";
+        };
+        for (auto& [key, value] : data.items()) {
+            FieldConstraints constraints = FieldConstraints::read(schema, key);
+            std::string field = "obj." + key;
+            if (value.is_string()) {
+                if (constraints.minLength) check(field + ".length < " + std::to_string(*constraints.minLength));
+                if (constraints.maxLength) check(field + ".length > " + std::to_string(*constraints.maxLength));
+                if (constraints.pattern) check("!" + className + "_" + key + "Pattern.test(" + field + ")");
+            }
+            if (value.is_number()) {
+                if (constraints.minimum) check(field + " < " + FieldConstraints::boundLiteral(*constraints.minimum, !value.is_number_float(), true));
+                if (constraints.maximum) check(field + " > " + FieldConstraints::boundLiteral(*constraints.maximum, !value.is_number_float(), false));
+            }
+            std::vector<json> allowed = constraints.enumValuesLike(value);
+            if (!allowed.empty()) {
+                std::string violation;
+                for (const auto& candidate : allowed) {
+                    violation += (violation.empty() ? "" : " && ") + field + " !== " + candidate.dump();
+                }
+                check(violation);
+            }
+            if (value.is_array()) {
+                if (constraints.required) check(field + " == null");
+                if (constraints.minItems) check(field + ".length < " + std::to_string(*constraints.minItems));
+                if (constraints.maxItems) check(field + ".length > " + std::to_string(*constraints.maxItems));
+                if (!value.empty() && value[0].is_object() && isUniform(value)) {
+                    outFile << indent1 << "if (" << field << " != null) {\n"
+                        << indent2 << "for (let i = 0; i < " << field << ".length; i++) {\n"
+                        << indent3 << "if (" << field << "[i] != null && !is" << className << "_" << key << "Valid(" << field << "[i])) return false;\n"
+                        << indent2 << "}\n"
+                        << indent1 << "}\n";
+                }
+            }
+            if (value.is_object()) {
+                if (constraints.required) check(field + " == null");
+                check(field + " != null && !is" + className + "_" + key + "Valid(" + field + ")");
+            }
+        }
+        outFile << indent1 << "return true;\n"
+            << "}\n\n";
+    }
+};